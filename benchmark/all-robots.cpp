@@ -14,6 +14,8 @@
 #endif
 
 #ifdef CROCODDYL_WITH_CODEGEN
+#include <stdlib.h>
+#include <fstream>
 #include "crocoddyl/core/codegen/action-base.hpp"
 #endif
 
@@ -28,6 +30,99 @@
 #define STDDEV(vec) std::sqrt(((vec - vec.mean())).square().sum() / (static_cast<double>(vec.size()) - 1))
 #define AVG(vec) (vec.mean())
 
+#ifdef CROCODDYL_WITH_CODEGEN
+typedef CppAD::AD<CppAD::cg::CG<double> > ADScalar;
+
+/**
+ * @brief Create a new folder for the generated libraries, so they are not loaded from a previous run
+ */
+std::string create_codegen_folder() {
+  char folder[] = "/tmp/crocoddyl_codegen_XXXXXX";
+  if (mkdtemp(folder) == NULL) {
+    throw_pretty("Invalid argument: "
+                 << "cannot create the folder of the generated libraries");
+  }
+  return folder;
+}
+
+/**
+ * @brief Print the compilation time of the code-generated running model
+ *
+ * It compares a single compile job of the unsplit generated code (i.e., the compilation before splitting it into
+ * several translation units), the parallel jobs of the split code, the object cache (cold and warm) and the library
+ * cache. Each library is built in a fresh folder, so none of them is loaded from a previous run.
+ */
+void print_codegen_startup(const std::string& robot_name,
+                           boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<ADScalar> > ad_model,
+                           boost::shared_ptr<crocoddyl::ActionModelAbstract> model) {
+  const std::string folder = create_codegen_folder();
+  const std::string prefix = folder + "/" + robot_name + "_running_cg";
+  crocoddyl::CodeGenOptions serial_options;
+  serial_options.njobs = 1;
+  serial_options.max_assignments = 0;
+  crocoddyl::CodeGenOptions parallel_options;
+  crocoddyl::CodeGenOptions cached_options;
+  cached_options.object_cache = folder + "/objects";
+
+  const std::size_t nbuilds = 5;
+  const std::string names[nbuilds] = {"single job", "parallel jobs", "object cache (cold)", "object cache (warm)",
+                                      "library cache"};
+  const std::string libraries[nbuilds] = {prefix + "_serial", prefix + "_parallel", prefix + "_cold",
+                                          prefix + "_warm", prefix + "_warm"};
+  const crocoddyl::CodeGenOptions* options[nbuilds] = {&serial_options, &parallel_options, &cached_options,
+                                                       &cached_options, &cached_options};
+  std::cout << "Compilation of the running model (" << folder << "):" << std::endl;
+  for (std::size_t i = 0; i < nbuilds; ++i) {
+    crocoddyl::Timer timer;
+    crocoddyl::ActionModelCodeGen cg_model(ad_model, model, libraries[i], 0,
+                                           crocoddyl::ActionModelCodeGen::empty_record_env, "calc", "calcDiff",
+                                           *options[i]);
+    std::cout << "  " << names[i] << " [s]:\t" << timer.get_duration() * 1e-3 << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+/**
+ * @brief Print the code size and the calcDiff time of the running model with dense and sparse derivatives
+ *
+ * The dense library generates all the derivatives (i.e., the code before the sparsity detection), while the sparse
+ * one only generates the derivatives that are not constant.
+ */
+void print_codegen_sparsity(const std::string& robot_name,
+                            boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<ADScalar> > ad_model,
+                            boost::shared_ptr<crocoddyl::ActionModelAbstract> model, const Eigen::VectorXd& x,
+                            const Eigen::VectorXd& u, const unsigned int T) {
+  const std::string folder = create_codegen_folder();
+  const std::string extension = CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
+  std::cout << "Derivatives of the running model (" << folder << "):" << std::endl;
+  for (std::size_t i = 0; i < 2; ++i) {
+    crocoddyl::CodeGenOptions options;
+    options.sparsity = i == 1;
+    const std::string label = options.sparsity ? "sparse" : "dense";
+    const std::string name = folder + "/" + robot_name + "_running_cg_" + label;
+    crocoddyl::ActionModelCodeGen cg_model(ad_model, model, name, 0, crocoddyl::ActionModelCodeGen::empty_record_env,
+                                           "calc", "calcDiff", options);
+    const std::string filename = name + "_" + cg_model.get_library_key() + extension;
+    std::ifstream library(filename.c_str(), std::ios::binary | std::ios::ate);
+
+    boost::shared_ptr<crocoddyl::ActionDataAbstract> cg_data = cg_model.createData();
+    cg_model.calc(cg_data, x, u);
+    Eigen::ArrayXd duration(T);
+    for (unsigned int j = 0; j < T; ++j) {
+      crocoddyl::Timer timer;
+      cg_model.calcDiff(cg_data, x, u);
+      duration[j] = timer.get_us_duration();
+    }
+    std::cout << "  " << label << " generated derivatives:\t" << cg_model.get_calcDiff_outputs().size() << " of "
+              << cg_model.get_calcDiff_constants().size() << std::endl;
+    std::cout << "  " << label << " library size [bytes]:\t" << library.tellg() << std::endl;
+    std::cout << "  " << label << " calcDiff [us]:\t\t" << AVG(duration) << " +- " << STDDEV(duration)
+              << " (max: " << duration.maxCoeff() << ", min: " << duration.minCoeff() << ")" << std::endl;
+  }
+  std::cout << std::endl;
+}
+#endif  // CROCODDYL_WITH_CODEGEN
+
 void print_benchmark(RobotEENames robot) {
   unsigned int N = 100;  // number of nodes
   unsigned int T = 1e3;  // number of trials
@@ -82,7 +177,6 @@ void print_benchmark(RobotEENames robot) {
 
 #ifdef CROCODDYL_WITH_CODEGEN
   // Code generation of the running an terminal models
-  typedef CppAD::AD<CppAD::cg::CG<double> > ADScalar;
   boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<ADScalar> > ad_runningModel, ad_terminalModel;
   if (robot.robot_name == "Talos_arm") {
     crocoddyl::benchmark::build_arm_action_models(ad_runningModel, ad_terminalModel);
@@ -92,12 +186,17 @@ void print_benchmark(RobotEENames robot) {
     crocoddyl::benchmark::build_contact_action_models(robot, ad_runningModel, ad_terminalModel);
   }
 
+  // The startup time includes the recording, the code generation and the compilation of the libraries (unless they
+  // are already in the cache)
+  crocoddyl::Timer startup_timer;
   boost::shared_ptr<crocoddyl::ActionModelAbstract> cg_runningModel =
       boost::make_shared<crocoddyl::ActionModelCodeGen>(ad_runningModel, runningModel,
                                                         robot.robot_name + "_running_cg");
   boost::shared_ptr<crocoddyl::ActionModelAbstract> cg_terminalModel =
       boost::make_shared<crocoddyl::ActionModelCodeGen>(ad_terminalModel, terminalModel,
                                                         robot.robot_name + "_terminal_cg");
+  std::cout << "Code generation startup [s]:\t" << startup_timer.get_duration() * 1e-3 << std::endl << std::endl;
+  print_codegen_startup(robot.robot_name, ad_runningModel, runningModel);
 
   // Defining the shooting problem for both cases: with and without code generation
   std::vector<boost::shared_ptr<crocoddyl::ActionModelAbstract> > cg_runningModels(N, cg_runningModel);
@@ -124,6 +223,7 @@ void print_benchmark(RobotEENames robot) {
   assert_pretty(cg_runningData->Luu.isApprox(runningData->Luu), "Problem in Luu");
   assert_pretty(cg_runningData->Fx.isApprox(runningData->Fx), "Problem in Fx");
   assert_pretty(cg_runningData->Fu.isApprox(runningData->Fu), "Problem in Fu");
+  print_codegen_sparsity(robot.robot_name, ad_runningModel, runningModel, x_rand, u_rand, T);
 #endif  // CROCODDYL_WITH_CODEGEN
 
   /******************************* create csv file *******************************/
@@ -214,6 +314,30 @@ void print_benchmark(RobotEENames robot) {
   csv << "backwardPass" << 1 << false << avg_bp << stddev_bp << duration.maxCoeff() << duration.minCoeff()
       << avg_bp / N << stddev_bp / N << csv.endl;
 
+#ifdef CROCODDYL_WITH_MULTITHREADING
+  // Partitioned backward pass timings
+  ddp.set_backward_type(crocoddyl::BackwardPassPartitioned);
+  for (int ithread = 1; ithread < CROCODDYL_WITH_NTHREADS; ++ithread) {
+    problem->set_nthreads(ithread + 1);
+    duration.setZero();
+    for (unsigned int i = 0; i < T; ++i) {
+      crocoddyl::Timer timer;
+      ddp.backwardPass();
+      duration[i] = timer.get_us_duration();
+    }
+    avg[ithread] = AVG(duration);
+    stddev[ithread] = STDDEV(duration);
+    std::cout << ithread + 1 << " threaded backwardPass [us]:\t" << avg[ithread] << " +- " << stddev[ithread]
+              << " (max: " << duration.maxCoeff() << ", min: " << duration.minCoeff()
+              << ", per nodes: " << avg[ithread] * (ithread + 1) / N << " +- " << stddev[ithread] * (ithread + 1) / N
+              << ")" << std::endl;
+    csv << "backwardPass" << (ithread + 1) << false << avg[ithread] << stddev[ithread] << duration.maxCoeff()
+        << duration.minCoeff() << avg[ithread] * (ithread + 1) / N << stddev[ithread] * (ithread + 1) / N << csv.endl;
+  }
+  ddp.set_backward_type(crocoddyl::BackwardPassSerial);
+  problem->set_nthreads(CROCODDYL_WITH_NTHREADS);
+#endif
+
   // Forward pass timings
   duration.setZero();
   for (unsigned int i = 0; i < T; ++i) {
@@ -286,6 +410,32 @@ void print_benchmark(RobotEENames robot) {
         << duration.minCoeff() << avg[ithread] * (ithread + 1) / N << stddev[ithread] * (ithread + 1) / N << csv.endl;
   }
 
+  // batched calcDiff timings, which evaluate the nodes as the columns of a matrix instead of the per-node loop
+  crocoddyl::ActionModelCodeGen* cg_model = static_cast<crocoddyl::ActionModelCodeGen*>(cg_runningModel.get());
+  const std::size_t nx = state->get_nx();
+  Eigen::MatrixXd xus = Eigen::MatrixXd::Zero(cg_model->getInputDimension(), N);
+  for (unsigned int j = 0; j < N; ++j) {
+    xus.col(j).head(nx) = xs[j];
+    xus.col(j).segment(nx, cg_model->get_nu()) = us[j];
+  }
+  Eigen::MatrixXd calcDiffout(cg_model->get_calcDiff_constants().size(), N);
+  for (int ithread = 0; ithread < CROCODDYL_WITH_NTHREADS; ++ithread) {
+    duration.setZero();
+    for (unsigned int i = 0; i < T; ++i) {
+      crocoddyl::Timer timer;
+      cg_model->calcDiffBatch(xus, calcDiffout, ithread + 1);
+      duration[i] = timer.get_us_duration();
+    }
+    avg[ithread] = AVG(duration);
+    stddev[ithread] = STDDEV(duration);
+    std::cout << ithread + 1 << " threaded batched calcDiff [us]:\t" << avg[ithread] << " +- " << stddev[ithread]
+              << " (max: " << duration.maxCoeff() << ", min: " << duration.minCoeff()
+              << ", per nodes: " << avg[ithread] * (ithread + 1) / N << " +- " << stddev[ithread] * (ithread + 1) / N
+              << ")" << std::endl;
+    csv << "calcDiffBatch" << (ithread + 1) << true << avg[ithread] << stddev[ithread] << duration.maxCoeff()
+        << duration.minCoeff() << avg[ithread] * (ithread + 1) / N << stddev[ithread] * (ithread + 1) / N << csv.endl;
+  }
+
   /*******************************************************************************/
   /******************* DDP BACKWARD AND FORWARD PASSES TIMINGS *******************/
   // Backward pass timings
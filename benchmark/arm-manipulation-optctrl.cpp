@@ -68,6 +68,28 @@ int main(int argc, char* argv[]) {
   std::cout << "  DDP.solve [ms]: " << avrg_duration << " (" << min_duration << "-" << max_duration << ")"
             << std::endl;
 
+  // Running the backward pass with the structured, fixed-size and dynamic-size kernels
+  const bool structured[3] = {true, false, false};
+  const bool fixed_size[3] = {true, true, false};
+  const char* kernel_names[3] = {"structured", "fixed-size", "dynamic-size"};
+  for (std::size_t f = 0; f < 3; ++f) {
+    ddp.set_structured(structured[f]);
+    ddp.set_fixed_size(fixed_size[f]);
+    for (unsigned int i = 0; i < T; ++i) {
+      crocoddyl::Timer timer;
+      ddp.backwardPass();
+      duration[i] = timer.get_duration();
+    }
+
+    avrg_duration = duration.sum() / T;
+    min_duration = duration.minCoeff();
+    max_duration = duration.maxCoeff();
+    std::cout << "  DDP.backwardPass (" << kernel_names[f] << ") [ms]: " << avrg_duration << " ("
+              << min_duration << "-" << max_duration << ")" << std::endl;
+  }
+  ddp.set_structured(true);
+  ddp.set_fixed_size(true);
+
   // Running calc
   for (unsigned int i = 0; i < T; ++i) {
     crocoddyl::Timer timer;
@@ -30,6 +30,7 @@
 #include "crocoddyl/multibody/actuations/floating-base.hpp"
 #include "crocoddyl/core/utils/callbacks.hpp"
 #include "crocoddyl/core/solvers/ddp.hpp"
+#include "crocoddyl/core/utils/scheduler.hpp"
 #include "crocoddyl/core/utils/timer.hpp"
 
 #define SMOOTH(s) for (size_t _smooth = 0; _smooth < s; ++_smooth)
@@ -468,4 +469,86 @@ int main(int argc, char* argv[]) {
 
   std::cout << "ContactDAM+EulerIAM calcDiff :\t\t" << AVG(duration) << " us\t" << STDDEV(duration) << " us\t"
             << duration.maxCoeff() << " us\t" << duration.minCoeff() << " us" << std::endl;
+
+  /*********************Load balancing**************************/
+  const unsigned int Tlb = std::min(T, 1000u);
+  Eigen::ArrayXd lb_duration(Tlb);
+  std::vector<Eigen::VectorXd> lb_us(N, Eigen::VectorXd::Zero(actuation->get_nu()));
+  const std::size_t nthreads[3] = {2, 4, 8};
+  const boost::shared_ptr<crocoddyl::SchedulerAbstract> schedulers[2] = {
+      boost::make_shared<crocoddyl::SchedulerOpenMP>(), boost::make_shared<crocoddyl::SchedulerThreadPool>()};
+  const char* scheduler_names[2] = {"OpenMP", "pool"};
+  const crocoddyl::LoadBalancingType balancing[3] = {crocoddyl::LoadBalancingStatic, crocoddyl::LoadBalancingCostAware,
+                                                     crocoddyl::LoadBalancingDynamic};
+  const char* balancing_names[3] = {"static :\t", "cost-aware :", "dynamic :\t"};
+  const boost::shared_ptr<crocoddyl::SchedulerAbstract> default_scheduler = problem->get_scheduler();
+  for (std::size_t s = 0; s < 2; ++s) {
+    problem->set_scheduler(schedulers[s]);
+    for (std::size_t n = 0; n < 3; ++n) {
+      problem->set_nthreads(static_cast<int>(nthreads[n]));
+      for (std::size_t b = 0; b < 3; ++b) {
+        problem->set_load_balancing(balancing[b]);
+        problem->calcDiff(xs, lb_us);  // measures the node durations
+        lb_duration.setZero();
+        SMOOTH(Tlb) {
+          timer.reset();
+          problem->calcDiff(xs, lb_us);
+          lb_duration[_smooth] = timer.get_us_duration();
+        }
+        std::cout << "ShootingProblem.calcDiff " << scheduler_names[s] << " " << nthreads[n] << "T "
+                  << balancing_names[b] << "\t" << AVG(lb_duration) << " us\t" << STDDEV(lb_duration) << " us\t"
+                  << lb_duration.maxCoeff() << " us\t" << lb_duration.minCoeff() << " us" << std::endl;
+      }
+    }
+  }
+  problem->set_scheduler(default_scheduler);
+  problem->set_load_balancing(crocoddyl::LoadBalancingStatic);
+
+  /*********************Solver**********************************/
+  const unsigned int Tbp = std::min(T, 1000u);
+  Eigen::ArrayXd bp_duration(Tbp);
+  crocoddyl::SolverDDP ddp(problem);
+  ddp.setCandidate(xs, std::vector<Eigen::VectorXd>(N, Eigen::VectorXd::Zero(actuation->get_nu())), false);
+  ddp.calcDiff();
+
+  bp_duration.setZero();
+  SMOOTH(Tbp) {
+    timer.reset();
+    ddp.backwardPass();
+    bp_duration[_smooth] = timer.get_us_duration();
+  }
+
+  std::cout << "SolverDDP.backwardPass serial :\t\t" << AVG(bp_duration) << " us\t" << STDDEV(bp_duration) << " us\t"
+            << bp_duration.maxCoeff() << " us\t" << bp_duration.minCoeff() << " us" << std::endl;
+
+  ddp.set_backward_type(crocoddyl::BackwardPassPartitioned);
+  bp_duration.setZero();
+  SMOOTH(Tbp) {
+    timer.reset();
+    ddp.backwardPass();
+    bp_duration[_smooth] = timer.get_us_duration();
+  }
+
+  std::cout << "SolverDDP.backwardPass partitioned :\t" << AVG(bp_duration) << " us\t" << STDDEV(bp_duration)
+            << " us\t" << bp_duration.maxCoeff() << " us\t" << bp_duration.minCoeff() << " us" << std::endl;
+  ddp.set_backward_type(crocoddyl::BackwardPassSerial);
+
+  /*********************Real-time iteration*********************/
+  Eigen::ArrayXd fb_duration(Tbp);
+  bp_duration.setZero();
+  fb_duration.setZero();
+  SMOOTH(Tbp) {
+    ddp.setCandidate(xs, std::vector<Eigen::VectorXd>(N, Eigen::VectorXd::Zero(actuation->get_nu())), false);
+    timer.reset();
+    ddp.preparationPhase();
+    bp_duration[_smooth] = timer.get_us_duration();
+    timer.reset();
+    ddp.feedbackPhase(x0);
+    fb_duration[_smooth] = timer.get_us_duration();
+  }
+
+  std::cout << "SolverDDP.preparationPhase :\t\t" << AVG(bp_duration) << " us\t" << STDDEV(bp_duration) << " us\t"
+            << bp_duration.maxCoeff() << " us\t" << bp_duration.minCoeff() << " us" << std::endl;
+  std::cout << "SolverDDP.feedbackPhase :\t\t" << AVG(fb_duration) << " us\t" << STDDEV(fb_duration) << " us\t"
+            << fb_duration.maxCoeff() << " us\t" << fb_duration.minCoeff() << " us" << std::endl;
 }
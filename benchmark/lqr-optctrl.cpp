@@ -10,6 +10,7 @@
 #include "crocoddyl/core/actions/lqr.hpp"
 #include "crocoddyl/core/utils/callbacks.hpp"
 #include "crocoddyl/core/solvers/ddp.hpp"
+#include "crocoddyl/core/utils/scheduler.hpp"
 #include "crocoddyl/core/utils/timer.hpp"
 
 int main(int argc, char* argv[]) {
@@ -34,6 +35,8 @@ int main(int argc, char* argv[]) {
   boost::shared_ptr<crocoddyl::ShootingProblem> problem =
       boost::make_shared<crocoddyl::ShootingProblem>(x0, runningModels, model);
   crocoddyl::SolverDDP ddp(problem);
+  std::cout << "DDP.workspace [bytes]: " << ddp.get_workspace_size() << " (" << ddp.get_workspace_nodes()[0]
+            << " per node)" << std::endl;
   if (CALLBACKS) {
     std::vector<boost::shared_ptr<crocoddyl::CallbackAbstract> > cbs;
     cbs.push_back(boost::make_shared<crocoddyl::CallbackVerbose>());
@@ -78,4 +81,27 @@ int main(int argc, char* argv[]) {
   max_duration = duration.maxCoeff();
   std::cout << "ShootingProblem.calcDiff [ms]: " << avrg_duration << " (" << min_duration << "-" << max_duration << ")"
             << std::endl;
+
+  // Running calcDiff with the OpenMP and thread-pool schedulers, i.e., their overhead for nodes of equal cost
+  const std::size_t nthreads[4] = {1, 2, 4, 8};
+  const boost::shared_ptr<crocoddyl::SchedulerAbstract> schedulers[2] = {
+      boost::make_shared<crocoddyl::SchedulerOpenMP>(), boost::make_shared<crocoddyl::SchedulerThreadPool>()};
+  const char* scheduler_names[2] = {"openmp", "thread-pool"};
+  for (std::size_t s = 0; s < 2; ++s) {
+    problem->set_scheduler(schedulers[s]);
+    for (std::size_t n = 0; n < 4; ++n) {
+      problem->set_nthreads(static_cast<int>(nthreads[n]));
+      for (unsigned int i = 0; i < T; ++i) {
+        crocoddyl::Timer timer;
+        problem->calcDiff(xs, us);
+        duration[i] = timer.get_duration();
+      }
+
+      avrg_duration = duration.sum() / T;
+      min_duration = duration.minCoeff();
+      max_duration = duration.maxCoeff();
+      std::cout << "ShootingProblem.calcDiff (" << scheduler_names[s] << ", " << nthreads[n] << " threads) [ms]: "
+                << avrg_duration << " (" << min_duration << "-" << max_duration << ")" << std::endl;
+    }
+  }
 }
\ No newline at end of file
@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+
+#include "crocoddyl/core/solvers/fddp.hpp"
+#include "crocoddyl/core/utils/timer.hpp"
+#include "crocoddyl/core/utils/file-io.hpp"
+
+#include "factory/legged-robots.hpp"
+#include "factory/arm.hpp"
+
+// Number of heap allocations of the process. With glibc, the allocation functions are replaced by wrappers of the
+// glibc ones, so it counts the allocations of Eigen, the STL and Pinocchio (including the ones in the library).
+static std::atomic<std::size_t> n_allocations(0);
+
+#ifdef __GLIBC__
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t n, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+
+void* malloc(std::size_t size) {
+  n_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+void* calloc(std::size_t n, std::size_t size) {
+  n_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, std::size_t size) {
+  n_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size) {
+  n_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) {
+  n_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, std::size_t alignment, std::size_t size) {
+  n_allocations.fetch_add(1, std::memory_order_relaxed);
+  *ptr = __libc_memalign(alignment, size);
+  return *ptr == NULL ? ENOMEM : 0;
+}
+}
+#endif
+
+#define AVG(vec) (vec.mean())
+
+// Value of the p-th percentile of a sorted array
+double percentile(const Eigen::ArrayXd& sorted, const double p) {
+  const std::size_t n = static_cast<std::size_t>(sorted.size());
+  const std::size_t i = static_cast<std::size_t>(std::ceil(p * static_cast<double>(n)));
+  return sorted[std::min(std::max(i, std::size_t(1)), n) - 1];
+}
+
+void print_benchmark(RobotEENames robot, const unsigned int T, const unsigned int maxiter, const bool warm_start,
+                     CsvStream& csv) {
+  unsigned int N = 100;  // number of nodes
+
+  // Building the running and terminal models
+  boost::shared_ptr<crocoddyl::ActionModelAbstract> runningModel, terminalModel;
+  if (robot.robot_name == "Talos_arm") {
+    crocoddyl::benchmark::build_arm_action_models(runningModel, terminalModel);
+  } else {
+    crocoddyl::benchmark::build_contact_action_models(robot, runningModel, terminalModel);
+  }
+
+  // Get the initial state
+  boost::shared_ptr<crocoddyl::StateMultibody> state =
+      boost::static_pointer_cast<crocoddyl::StateMultibody>(runningModel->get_state());
+  std::cout << "NQ: " << state->get_nq() << ", number of nodes: " << N << ", cycles: " << T
+            << ", maxiter: " << maxiter << ", warm start policy: " << warm_start << std::endl;
+
+  Eigen::VectorXd default_state(state->get_nq() + state->get_nv());
+  boost::shared_ptr<crocoddyl::IntegratedActionModelEulerTpl<double> > rm =
+      boost::static_pointer_cast<crocoddyl::IntegratedActionModelEulerTpl<double> >(runningModel);
+  if (robot.robot_name == "Talos_arm") {
+    boost::shared_ptr<crocoddyl::DifferentialActionModelFreeFwdDynamicsTpl<double> > dm =
+        boost::static_pointer_cast<crocoddyl::DifferentialActionModelFreeFwdDynamicsTpl<double> >(
+            rm->get_differential());
+    default_state << dm->get_pinocchio().referenceConfigurations[robot.reference_conf],
+        Eigen::VectorXd::Zero(state->get_nv());
+  } else {
+    boost::shared_ptr<crocoddyl::DifferentialActionModelContactFwdDynamicsTpl<double> > dm =
+        boost::static_pointer_cast<crocoddyl::DifferentialActionModelContactFwdDynamicsTpl<double> >(
+            rm->get_differential());
+    default_state << dm->get_pinocchio().referenceConfigurations[robot.reference_conf],
+        Eigen::VectorXd::Zero(state->get_nv());
+  }
+  Eigen::VectorXd x0(default_state);
+  std::vector<boost::shared_ptr<crocoddyl::ActionModelAbstract> > runningModels(N, runningModel);
+  boost::shared_ptr<crocoddyl::ShootingProblem> problem =
+      boost::make_shared<crocoddyl::ShootingProblem>(x0, runningModels, terminalModel);
+
+  // Computing the warm-start and solving the first problem, which is not measured
+  std::vector<Eigen::VectorXd> xs(N + 1, x0);
+  std::vector<Eigen::VectorXd> us(N, Eigen::VectorXd::Zero(runningModel->get_nu()));
+  for (unsigned int i = 0; i < N; ++i) {
+    const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = problem->get_runningModels()[i];
+    const boost::shared_ptr<crocoddyl::ActionDataAbstract>& data = problem->get_runningDatas()[i];
+    model->quasiStatic(data, us[i], x0);
+  }
+  crocoddyl::SolverFDDP ddp(problem);
+  ddp.set_warm_start_policy(warm_start);
+  ddp.solve(xs, us, 100);
+
+  /*******************************************************************************/
+  /*********************************** MPC LOOP **********************************/
+  // The plant is simulated with the running model and a small disturbance of the state
+  boost::shared_ptr<crocoddyl::ActionDataAbstract> plantData = runningModel->createData();
+  Eigen::VectorXd x(x0);
+  Eigen::VectorXd disturbance(state->get_ndx());
+  Eigen::ArrayXd duration(T);
+  Eigen::ArrayXd iterations(T);
+  Eigen::ArrayXd allocations(T);
+  std::srand(1);
+  for (unsigned int i = 0; i < T; ++i) {
+    runningModel->calc(plantData, x, ddp.get_us()[0]);
+    disturbance.setRandom();
+    state->integrate(plantData->xnext, 1e-3 * disturbance, x);
+
+    const std::size_t n_allocations_start = n_allocations.load(std::memory_order_relaxed);
+    crocoddyl::Timer timer;
+    problem->circularAppend(runningModel);
+    problem->set_x0(x);
+    ddp.shiftWarmStart();
+    ddp.solve(ddp.get_xs(), ddp.get_us(), maxiter);
+    duration[i] = timer.get_us_duration();
+    allocations[i] = static_cast<double>(n_allocations.load(std::memory_order_relaxed) - n_allocations_start);
+    iterations[i] = static_cast<double>(ddp.get_iter());
+  }
+
+  Eigen::ArrayXd sorted(duration);
+  std::sort(sorted.data(), sorted.data() + sorted.size());
+  const double p50 = percentile(sorted, 0.5);
+  const double p99 = percentile(sorted, 0.99);
+  std::cout << "cycle latency [us]:\t\tp50: " << p50 << ", p99: " << p99 << ", max: " << duration.maxCoeff()
+            << std::endl;
+  std::cout << "iterations per cycle:\t\t" << AVG(iterations) << " (max: " << iterations.maxCoeff() << ")"
+            << std::endl;
+#ifdef __GLIBC__
+  std::cout << "allocations per cycle:\t\t" << AVG(allocations) << " (max: " << allocations.maxCoeff() << ")"
+            << std::endl;
+#endif
+  std::cout << std::endl;
+
+  csv << robot.robot_name << state->get_nq() << N << T << maxiter << warm_start << p50 << p99 << duration.maxCoeff()
+      << AVG(iterations) << iterations.maxCoeff();
+#ifdef __GLIBC__
+  csv << AVG(allocations) << allocations.maxCoeff() << csv.endl;
+#else
+  // the allocations are only counted with glibc
+  csv << "n/a"
+      << "n/a" << csv.endl;
+#endif
+}
+
+int main(int argc, char* argv[]) {
+  unsigned int T = 1e3;       // number of MPC cycles
+  unsigned int maxiter = 10;  // maximum number of iterations per cycle
+  if (argc > 1) {
+    T = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    maxiter = atoi(argv[2]);
+  }
+
+  /******************************* create csv file *******************************/
+  CsvStream csv("/tmp/mpc-loop.bench");
+  csv << "robot"
+      << "nq"
+      << "nodes"
+      << "cycles"
+      << "maxiter"
+      << "warm_start"
+      << "p50"
+      << "p99"
+      << "max"
+      << "mean_iter"
+      << "max_iter"
+      << "mean_alloc"
+      << "max_alloc" << csv.endl;
+
+  std::vector<RobotEENames> robots;
+  std::vector<std::string> contact_names;
+  std::vector<crocoddyl::ContactType> contact_types;
+  robots.push_back(RobotEENames("Talos_arm", contact_names, contact_types,
+                                EXAMPLE_ROBOT_DATA_MODEL_DIR "/talos_data/robots/talos_left_arm.urdf",
+                                EXAMPLE_ROBOT_DATA_MODEL_DIR "/talos_data/srdf/talos.srdf", "gripper_left_joint",
+                                "half_sitting"));
+
+  contact_names.push_back("FR_KFE");
+  contact_names.push_back("HL_KFE");
+  contact_types.push_back(crocoddyl::Contact3D);
+  contact_types.push_back(crocoddyl::Contact3D);
+  robots.push_back(RobotEENames("Solo", contact_names, contact_types,
+                                EXAMPLE_ROBOT_DATA_MODEL_DIR "/solo_description/robots/solo.urdf",
+                                EXAMPLE_ROBOT_DATA_MODEL_DIR "/solo_description/srdf/solo.srdf", "HL_KFE",
+                                "standing"));
+
+  contact_names.clear();
+  contact_types.clear();
+  contact_names.push_back("RF_KFE");
+  contact_names.push_back("LF_KFE");
+  contact_names.push_back("LH_KFE");
+  contact_types.push_back(crocoddyl::Contact3D);
+  contact_types.push_back(crocoddyl::Contact3D);
+  contact_types.push_back(crocoddyl::Contact3D);
+  robots.push_back(RobotEENames("Anymal", contact_names, contact_types,
+                                EXAMPLE_ROBOT_DATA_MODEL_DIR "/anymal_b_simple_description/robots/anymal.urdf",
+                                EXAMPLE_ROBOT_DATA_MODEL_DIR "/anymal_b_simple_description/srdf/anymal.srdf",
+                                "RH_KFE", "standing"));
+
+  contact_names.clear();
+  contact_types.clear();
+  contact_names.push_back("leg_right_6_joint");
+  contact_names.push_back("leg_left_6_joint");
+  contact_types.push_back(crocoddyl::Contact6D);
+  contact_types.push_back(crocoddyl::Contact6D);
+  robots.push_back(RobotEENames("Talos", contact_names, contact_types,
+                                EXAMPLE_ROBOT_DATA_MODEL_DIR "/talos_data/robots/talos_reduced.urdf",
+                                EXAMPLE_ROBOT_DATA_MODEL_DIR "/talos_data/srdf/talos.srdf", "arm_right_7_joint",
+                                "half_sitting"));
+
+  for (std::size_t i = 0; i < robots.size(); ++i) {
+    std::cout << "******************** " << robots[i].robot_name << " ********************" << std::endl;
+    print_benchmark(robots[i], T, maxiter, false, csv);
+    print_benchmark(robots[i], T, maxiter, true, csv);
+  }
+  return 0;
+}
@@ -12,6 +12,7 @@
 #include "crocoddyl/multibody/utils/quadruped-gaits.hpp"
 #include "crocoddyl/core/utils/callbacks.hpp"
 #include "crocoddyl/core/solvers/fddp.hpp"
+#include "crocoddyl/core/utils/scheduler.hpp"
 #include "crocoddyl/core/utils/timer.hpp"
 
 int main(int argc, char* argv[]) {
@@ -66,6 +67,68 @@ int main(int argc, char* argv[]) {
   std::cout << "  DDP.solve [ms]: " << avrg_duration << " (" << min_duration << "-" << max_duration << ")"
             << std::endl;
 
+#ifdef CROCODDYL_WITH_MULTITHREADING
+  // Solving the optimal control problem with a concurrent line search
+  ddp.set_linesearch_type(crocoddyl::LineSearchConcurrent);
+  for (unsigned int i = 0; i < T; ++i) {
+    crocoddyl::Timer timer;
+    ddp.solve(xs, us, MAXITER, false, 0.1);
+    duration[i] = timer.get_duration();
+  }
+  ddp.set_linesearch_type(crocoddyl::LineSearchSerial);
+
+  avrg_duration = duration.mean();
+  min_duration = duration.minCoeff();
+  max_duration = duration.maxCoeff();
+  std::cout << "  DDP.solve (concurrent line search) [ms]: " << avrg_duration << " (" << min_duration << "-"
+            << max_duration << ")" << std::endl;
+#endif  // CROCODDYL_WITH_MULTITHREADING
+
+  // Running the real-time iteration, i.e. the preparation and feedback phases from the same guess
+  Eigen::ArrayXd feedback_duration(T);
+  for (unsigned int i = 0; i < T; ++i) {
+    ddp.setCandidate(xs, us, false);
+    crocoddyl::Timer timer;
+    ddp.preparationPhase();
+    duration[i] = timer.get_duration();
+    timer.reset();
+    ddp.feedbackPhase(x0);
+    feedback_duration[i] = timer.get_duration();
+  }
+
+  avrg_duration = duration.mean();
+  min_duration = duration.minCoeff();
+  max_duration = duration.maxCoeff();
+  std::cout << "  DDP.preparationPhase [ms]: " << avrg_duration << " (" << min_duration << "-" << max_duration << ")"
+            << std::endl;
+  avrg_duration = feedback_duration.mean();
+  min_duration = feedback_duration.minCoeff();
+  max_duration = feedback_duration.maxCoeff();
+  std::cout << "  DDP.feedbackPhase [ms]: " << avrg_duration << " (" << min_duration << "-" << max_duration << ")"
+            << std::endl;
+
+  // Running the backward pass with the structured, fixed-size and dynamic-size kernels
+  const bool structured[3] = {true, false, false};
+  const bool fixed_size[3] = {true, true, false};
+  const char* kernel_names[3] = {"structured", "fixed-size", "dynamic-size"};
+  for (std::size_t f = 0; f < 3; ++f) {
+    ddp.set_structured(structured[f]);
+    ddp.set_fixed_size(fixed_size[f]);
+    for (unsigned int i = 0; i < T; ++i) {
+      crocoddyl::Timer timer;
+      ddp.backwardPass();
+      duration[i] = timer.get_duration();
+    }
+
+    avrg_duration = duration.sum() / T;
+    min_duration = duration.minCoeff();
+    max_duration = duration.maxCoeff();
+    std::cout << "  DDP.backwardPass (" << kernel_names[f] << ") [ms]: " << avrg_duration << " ("
+              << min_duration << "-" << max_duration << ")" << std::endl;
+  }
+  ddp.set_structured(true);
+  ddp.set_fixed_size(false);
+
   // Running calc
   for (unsigned int i = 0; i < T; ++i) {
     crocoddyl::Timer timer;
@@ -91,4 +154,35 @@ int main(int argc, char* argv[]) {
   max_duration = duration.maxCoeff();
   std::cout << "  ShootingProblem.calcDiff [ms]: " << avrg_duration << " (" << min_duration << "-" << max_duration
             << ")" << std::endl;
+
+  // Running calcDiff with the OpenMP and thread-pool schedulers and the different load balancing types
+  const std::size_t nthreads[3] = {2, 4, 8};
+  const boost::shared_ptr<crocoddyl::SchedulerAbstract> schedulers[2] = {
+      boost::make_shared<crocoddyl::SchedulerOpenMP>(), boost::make_shared<crocoddyl::SchedulerThreadPool>()};
+  const char* scheduler_names[2] = {"openmp", "thread-pool"};
+  const crocoddyl::LoadBalancingType balancing[3] = {crocoddyl::LoadBalancingStatic, crocoddyl::LoadBalancingCostAware,
+                                                     crocoddyl::LoadBalancingDynamic};
+  const char* balancing_names[3] = {"static", "cost-aware", "dynamic"};
+  for (std::size_t s = 0; s < 2; ++s) {
+    problem->set_scheduler(schedulers[s]);
+    for (std::size_t n = 0; n < 3; ++n) {
+      problem->set_nthreads(static_cast<int>(nthreads[n]));
+      for (std::size_t b = 0; b < 3; ++b) {
+        problem->set_load_balancing(balancing[b]);
+        problem->calcDiff(xs, us);  // measures the node durations
+        for (unsigned int i = 0; i < T; ++i) {
+          crocoddyl::Timer timer;
+          problem->calcDiff(xs, us);
+          duration[i] = timer.get_duration();
+        }
+
+        avrg_duration = duration.sum() / T;
+        min_duration = duration.minCoeff();
+        max_duration = duration.maxCoeff();
+        std::cout << "  ShootingProblem.calcDiff (" << scheduler_names[s] << ", " << nthreads[n] << " threads, "
+                  << balancing_names[b] << ") [ms]: " << avrg_duration << " (" << min_duration << "-"
+                  << max_duration << ")" << std::endl;
+      }
+    }
+  }
 }
@@ -54,6 +54,19 @@ void exposeActionAbstract() {
       .def<void (ActionModelAbstract::*)(const boost::shared_ptr<ActionDataAbstract>&,
                                          const Eigen::Ref<const Eigen::VectorXd>&)>(
           "calcDiff", &ActionModelAbstract::calcDiff, bp::args("self", "data", "x"))
+      .def<void (ActionModelAbstract::*)(const boost::shared_ptr<ActionDataAbstract>&,
+                                         const Eigen::Ref<const Eigen::VectorXd>&,
+                                         const Eigen::Ref<const Eigen::VectorXd>&)>(
+          "calcAndDiff", &ActionModelAbstract::calcAndDiff, bp::args("self", "data", "x", "u"),
+          "Compute the next state, cost value and their derivatives.\n\n"
+          "It is equivalent to run calc and then calcDiff, but some models share the\n"
+          "computations of both functions.\n"
+          ":param data: action data\n"
+          ":param x: time-discrete state vector\n"
+          ":param u: time-discrete control input")
+      .def<void (ActionModelAbstract::*)(const boost::shared_ptr<ActionDataAbstract>&,
+                                         const Eigen::Ref<const Eigen::VectorXd>&)>(
+          "calcAndDiff", &ActionModelAbstract::calcAndDiff, bp::args("self", "data", "x"))
       .def("createData", &ActionModelAbstract_wrap::createData, &ActionModelAbstract_wrap::default_createData,
            bp::args("self"),
            "Create the action data.\n\n"
@@ -121,7 +134,17 @@ void exposeActionAbstract() {
       .add_property("Lxu", bp::make_getter(&ActionDataAbstract::Lxu, bp::return_internal_reference<>()),
                     bp::make_setter(&ActionDataAbstract::Lxu), "Hessian of the cost")
       .add_property("Luu", bp::make_getter(&ActionDataAbstract::Luu, bp::return_internal_reference<>()),
-                    bp::make_setter(&ActionDataAbstract::Luu), "Hessian of the cost");
+                    bp::make_setter(&ActionDataAbstract::Luu), "Hessian of the cost")
+      .add_property("F_structured",
+                    bp::make_getter(&ActionDataAbstract::F_structured, bp::return_value_policy<bp::return_by_value>()),
+                    bp::make_setter(&ActionDataAbstract::F_structured),
+                    "true if the Jacobians of the dynamics have the block structure of an explicit Euler step")
+      .add_property("F_dt", bp::make_getter(&ActionDataAbstract::F_dt, bp::return_value_policy<bp::return_by_value>()),
+                    bp::make_setter(&ActionDataAbstract::F_dt), "time step of the Euler step")
+      .add_property("F_ndense",
+                    bp::make_getter(&ActionDataAbstract::F_ndense, bp::return_value_policy<bp::return_by_value>()),
+                    bp::make_setter(&ActionDataAbstract::F_ndense),
+                    "number of leading configuration rows of the Jacobians without this structure");
 }
 
 }  // namespace python
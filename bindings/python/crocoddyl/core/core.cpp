@@ -30,6 +30,7 @@ void exposeCore() {
   exposeActionNumDiff();
   exposeDifferentialActionNumDiff();
   exposeActivationNumDiff();
+  exposeScheduler();
   exposeShootingProblem();
   exposeSolverAbstract();
   exposeStateEuclidean();
@@ -50,8 +51,11 @@ void exposeCore() {
   exposeSolverBoxQP();
   exposeSolverBoxDDP();
   exposeSolverBoxFDDP();
+  exposeSolverBatch();
+  exposePolicyBuffer();
   exposeCallbacks();
   exposeStopWatch();
+  exposeInstrumentation();
 }
 
 }  // namespace python
@@ -52,8 +52,12 @@ void exposeSolverFDDP();
 void exposeSolverBoxQP();
 void exposeSolverBoxDDP();
 void exposeSolverBoxFDDP();
+void exposeSolverBatch();
+void exposePolicyBuffer();
 void exposeCallbacks();
 void exposeStopWatch();
+void exposeInstrumentation();
+void exposeScheduler();
 
 void exposeCore();
 
@@ -52,6 +52,19 @@ void exposeDifferentialActionAbstract() {
       .def<void (DifferentialActionModelAbstract::*)(const boost::shared_ptr<DifferentialActionDataAbstract>&,
                                                      const Eigen::Ref<const Eigen::VectorXd>&)>(
           "calcDiff", &DifferentialActionModelAbstract::calcDiff, bp::args("self", "data", "x"))
+      .def<void (DifferentialActionModelAbstract::*)(const boost::shared_ptr<DifferentialActionDataAbstract>&,
+                                                     const Eigen::Ref<const Eigen::VectorXd>&,
+                                                     const Eigen::Ref<const Eigen::VectorXd>&)>(
+          "calcAndDiff", &DifferentialActionModelAbstract::calcAndDiff, bp::args("self", "data", "x", "u"),
+          "Compute the system acceleration, cost value and their derivatives.\n\n"
+          "It is equivalent to run calc and then calcDiff, but some models share the\n"
+          "computations of both functions.\n"
+          ":param data: differential action data\n"
+          ":param x: state vector\n"
+          ":param u: control input")
+      .def<void (DifferentialActionModelAbstract::*)(const boost::shared_ptr<DifferentialActionDataAbstract>&,
+                                                     const Eigen::Ref<const Eigen::VectorXd>&)>(
+          "calcAndDiff", &DifferentialActionModelAbstract::calcAndDiff, bp::args("self", "data", "x"))
       .def("createData", &DifferentialActionModelAbstract_wrap::createData,
            &DifferentialActionModelAbstract_wrap::default_createData, bp::args("self"),
            "Create the differential action data.\n\n"
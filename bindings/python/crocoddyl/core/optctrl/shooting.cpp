@@ -16,6 +16,22 @@
 namespace crocoddyl {
 namespace python {
 
+bp::list shooting_get_durations(const std::vector<double>& durations) {
+  bp::list list;
+  for (std::size_t i = 0; i < durations.size(); ++i) {
+    list.append(durations[i]);
+  }
+  return list;
+}
+
+bp::list shooting_get_calc_durations(const ShootingProblem& self) {
+  return shooting_get_durations(self.get_calc_durations());
+}
+
+bp::list shooting_get_calcDiff_durations(const ShootingProblem& self) {
+  return shooting_get_durations(self.get_calcDiff_durations());
+}
+
 void exposeShootingProblem() {
   // Register custom converters between std::vector and Python list
   typedef boost::shared_ptr<ActionModelAbstract> ActionModelPtr;
@@ -25,6 +41,12 @@ void exposeShootingProblem() {
 
   bp::register_ptr_to_python<boost::shared_ptr<ShootingProblem> >();
 
+  bp::enum_<LoadBalancingType>("LoadBalancingType")
+      .value("LoadBalancingStatic", LoadBalancingStatic)
+      .value("LoadBalancingCostAware", LoadBalancingCostAware)
+      .value("LoadBalancingDynamic", LoadBalancingDynamic)
+      .export_values();
+
   bp::class_<ShootingProblem, boost::noncopyable>(
       "ShootingProblem",
       "Declare a shooting problem.\n\n"
@@ -63,6 +85,13 @@ void exposeShootingProblem() {
            ":param xs: time-discrete state trajectory (size T+1)\n"
            ":param us: time-discrete control sequence (size T)\n"
            ":returns the total cost value")
+      .def("calcAndDiff", &ShootingProblem::calcAndDiff, bp::args("self", "xs", "us"),
+           "Compute the cost, the next states and their derivatives.\n\n"
+           "It is equivalent to run calc and then calcDiff, but each node runs the fused calcAndDiff\n"
+           "of its action model.\n"
+           ":param xs: time-discrete state trajectory (size T+1)\n"
+           ":param us: time-discrete control sequence (size T)\n"
+           ":returns the total cost value")
       .def("rollout", &ShootingProblem::rollout_us, bp::args("self", "us"),
            "Integrate the dynamics given a control sequence.\n\n"
            "Rollout the dynamics give a sequence of control commands\n"
@@ -81,7 +110,8 @@ void exposeShootingProblem() {
           "circularAppend", &ShootingProblem::circularAppend, bp::args("self", "model"),
           "Circular append the model and data onto the end running node.\n\n"
           "Once we update the end running node, the first running mode is removed as in a circular buffer.\n"
-          "Note that this method allocates new data for the end running node.\n"
+          "The data of the end running node is recycled from the removed nodes of the same model, otherwise\n"
+          "new data is allocated.\n"
           ":param model: new model")
       .def("updateNode", &ShootingProblem::updateNode, bp::args("self", "i", "model", "data"),
            "Update the model and data for a specific node.\n\n"
@@ -92,6 +122,9 @@ void exposeShootingProblem() {
            "Update a model and allocated new data for a specific node.\n\n"
            ":param i: index of the node (0 <= i <= T + 1)\n"
            ":param model: new model")
+      .def("invalidateDerivatives", &ShootingProblem::invalidateDerivatives, bp::args("self"),
+           "Force the next calcDiff to evaluate all the nodes.\n\n"
+           "It is required by the incremental calcDiff after modifying the parameters of a model.")
       .add_property("T", bp::make_function(&ShootingProblem::get_T), "number of running nodes")
       .add_property("x0", bp::make_function(&ShootingProblem::get_x0, bp::return_internal_reference<>()),
                     &ShootingProblem::set_x0, "initial state")
@@ -113,8 +146,27 @@ void exposeShootingProblem() {
           "terminal data")
       .add_property("nthreads", bp::make_function(&ShootingProblem::get_nthreads),
                     bp::make_function(&ShootingProblem::set_nthreads),
-                    "number of threads launch by the multi-threading support (if you set nthreads <= 1, then "
+                    "number of threads used by the scheduler (if you set nthreads <= 1, then "
                     "nthreads=CROCODDYL_WITH_NTHREADS)")
+      .add_property(
+          "scheduler",
+          bp::make_function(&ShootingProblem::get_scheduler, bp::return_value_policy<bp::return_by_value>()),
+          &ShootingProblem::set_scheduler, "scheduler that runs the parallel loops over the nodes")
+      .add_property("load_balancing", bp::make_function(&ShootingProblem::get_load_balancing),
+                    bp::make_function(&ShootingProblem::set_load_balancing),
+                    "type of load balancing used to distribute the nodes among the threads")
+      .add_property("calc_durations", &shooting_get_calc_durations,
+                    "measured duration of calc per running node (in microseconds)")
+      .add_property("calcDiff_durations", &shooting_get_calcDiff_durations,
+                    "measured duration of calcDiff per running node (in microseconds)")
+      .add_property("incremental_calcDiff", bp::make_function(&ShootingProblem::get_incremental_calcDiff),
+                    bp::make_function(&ShootingProblem::set_incremental_calcDiff),
+                    "if true, calcDiff skips the nodes whose state and control did not change")
+      .add_property("calcDiff_tolerance", bp::make_function(&ShootingProblem::get_calcDiff_tolerance),
+                    bp::make_function(&ShootingProblem::set_calcDiff_tolerance),
+                    "change of the state or control that triggers a new evaluation in the incremental calcDiff")
+      .add_property("calcDiff_skipped", bp::make_function(&ShootingProblem::get_calcDiff_skipped),
+                    "number of nodes skipped by the last calcDiff")
       .add_property("nx", bp::make_function(&ShootingProblem::get_nx), "dimension of state tuple")
       .add_property("ndx", bp::make_function(&ShootingProblem::get_ndx),
                     "dimension of the tangent space of the state manifold")
@@ -85,6 +85,12 @@ void exposeSolverAbstract() {
                                   ":param us: control trajectory of T elements (default []).\n"
                                   ":param isFeasible: true if the xs are obtained from integrating the\n"
                                   "us (rollout)."))
+      .def("shiftWarmStart", &SolverAbstract_wrap::shiftWarmStart, bp::args("self"),
+           "Shift the solver warm-point by one node.\n\n"
+           "It is used by receding-horizon (MPC) loops after shifting the problem with circularAppend.\n"
+           "The state and control trajectories (and the per-node terms of the DDP-based solvers) are rotated\n"
+           "one node towards the beginning of the horizon without allocating memory, and the new end running\n"
+           "node repeats the previous one. The shifted warm-point is used by calling solve(xs, us).")
       .def("setCallbacks", &SolverAbstract_wrap::setCallbacks, bp::args("self"),
            "Set a list of callback functions using for diagnostic.\n\n"
            "Each iteration, the solver calls these set of functions in order to\n"
@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "python/crocoddyl/core/core.hpp"
+#include "crocoddyl/core/solvers/batch.hpp"
+
+namespace crocoddyl {
+namespace python {
+
+boost::shared_ptr<SolverAbstract> solverBatch_create(bp::object creator, boost::shared_ptr<ShootingProblem> problem) {
+  return bp::extract<boost::shared_ptr<SolverAbstract> >(creator(problem));
+}
+
+boost::shared_ptr<SolverBatch> solverBatch_init(boost::shared_ptr<ShootingProblem> problem, const std::size_t nbatch,
+                                                bp::object creator) {
+  if (creator.is_none()) {
+    return boost::make_shared<SolverBatch>(problem, nbatch);
+  }
+  // The solvers are created serially in the constructor, so it is safe to call back into Python
+  return boost::make_shared<SolverBatch>(problem, nbatch, boost::bind(&solverBatch_create, creator, _1));
+}
+
+std::vector<std::vector<Eigen::VectorXd> > solverBatch_trajectories(const bp::list& trajs) {
+  std::vector<std::vector<Eigen::VectorXd> > vtrajs(bp::len(trajs));
+  for (std::size_t i = 0; i < vtrajs.size(); ++i) {
+    vtrajs[i] = bp::extract<std::vector<Eigen::VectorXd> >(trajs[i]);
+  }
+  return vtrajs;
+}
+
+bool solverBatch_solve(SolverBatch& self, const bp::list& x0s = bp::list(), const bp::list& init_xs = bp::list(),
+                       const bp::list& init_us = bp::list(), const std::size_t maxiter = 100,
+                       const bool is_feasible = false, const double reg_init = 1e-9) {
+  std::vector<Eigen::VectorXd> vx0s(bp::len(x0s));
+  for (std::size_t i = 0; i < vx0s.size(); ++i) {
+    vx0s[i] = bp::extract<Eigen::VectorXd>(x0s[i]);
+  }
+  const std::vector<std::vector<Eigen::VectorXd> > vxs = solverBatch_trajectories(init_xs);
+  const std::vector<std::vector<Eigen::VectorXd> > vus = solverBatch_trajectories(init_us);
+  return self.solve(vx0s, vxs, vus, maxiter, is_feasible, reg_init);
+}
+
+BOOST_PYTHON_FUNCTION_OVERLOADS(SolverBatch_solves, solverBatch_solve, 1, 7)
+
+bp::list solverBatch_get_converged(const SolverBatch& self) {
+  bp::list converged;
+  const std::vector<bool> flags = self.get_converged();
+  for (std::size_t i = 0; i < flags.size(); ++i) {
+    converged.append(static_cast<bool>(flags[i]));
+  }
+  return converged;
+}
+
+bp::list solverBatch_get_problems(const SolverBatch& self) {
+  bp::list problems;
+  const std::vector<boost::shared_ptr<ShootingProblem> >& instances = self.get_problems();
+  for (std::size_t i = 0; i < instances.size(); ++i) {
+    problems.append(instances[i]);
+  }
+  return problems;
+}
+
+bp::list solverBatch_get_solvers(const SolverBatch& self) {
+  bp::list solvers;
+  const std::vector<boost::shared_ptr<SolverAbstract> >& instances = self.get_solvers();
+  for (std::size_t i = 0; i < instances.size(); ++i) {
+    solvers.append(instances[i]);
+  }
+  return solvers;
+}
+
+void exposeSolverBatch() {
+  bp::register_ptr_to_python<boost::shared_ptr<SolverBatch> >();
+
+  bp::class_<SolverBatch, boost::noncopyable>(
+      "SolverBatch",
+      "Batch solver.\n\n"
+      "It solves many instances of the same problem, which only differ on their initial state and warm-start\n"
+      "(e.g. for multi-start or scenario sampling). The instances share the action models of the problem, and\n"
+      "they are solved in parallel through the problem's scheduler.",
+      bp::no_init)
+      .def("__init__",
+           bp::make_constructor(&solverBatch_init, bp::default_call_policies(),
+                                (bp::arg("problem"), bp::arg("nbatch"), bp::arg("creator") = bp::object())),
+           "Initialize the batch solver.\n\n"
+           ":param problem: shooting problem that defines the action models of all the instances\n"
+           ":param nbatch: number of instances\n"
+           ":param creator: callable that receives the problem of an instance and returns its solver\n"
+           "                (default SolverFDDP)")
+      .def("solve", &solverBatch_solve,
+           SolverBatch_solves(bp::args("self", "x0s", "init_xs", "init_us", "maxiter", "isFeasible", "regInit"),
+                              "Solve all the instances in parallel.\n\n"
+                              "Empty lists keep the current initial state of each instance, and use the default\n"
+                              "warm-start of the solver. Otherwise, they must contain one element per instance.\n"
+                              ":param x0s: initial state of each instance (default [])\n"
+                              ":param init_xs: initial guess for the state trajectory of each instance (default [])\n"
+                              ":param init_us: initial guess for the control trajectory of each instance\n"
+                              "                (default [])\n"
+                              ":param maxiter: maximum allowed number of iterations (default 100)\n"
+                              ":param isFeasible: true if the init_xs are obtained from integrating the init_us\n"
+                              "                   (default False)\n"
+                              ":param regInit: initial guess for the regularization value (default 1e-9)\n"
+                              ":returns true if all the instances converged."))
+      .add_property("problem",
+                    bp::make_function(&SolverBatch::get_problem, bp::return_value_policy<bp::copy_const_reference>()),
+                    "shooting problem that defines the instances")
+      .add_property("nbatch", bp::make_function(&SolverBatch::get_nbatch), "number of instances")
+      .add_property("problems", &solverBatch_get_problems, "shooting problem of each instance")
+      .add_property("solvers", &solverBatch_get_solvers, "solver of each instance")
+      .add_property("converged", &solverBatch_get_converged, "instances that converged in the last solve")
+      .add_property("nconverged", bp::make_function(&SolverBatch::get_nconverged),
+                    "number of instances that converged in the last solve");
+}
+
+}  // namespace python
+}  // namespace crocoddyl
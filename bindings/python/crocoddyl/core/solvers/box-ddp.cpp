@@ -15,7 +15,7 @@ namespace python {
 void exposeSolverBoxDDP() {
   bp::register_ptr_to_python<boost::shared_ptr<SolverBoxDDP> >();
 
-  bp::class_<SolverBoxDDP, bp::bases<SolverDDP> >(
+  bp::class_<SolverBoxDDP, bp::bases<SolverDDP>, boost::noncopyable>(
       "SolverBoxDDP",
       "Box-constrained DDP solver.\n\n"
       ":param shootingProblem: shooting problem (list of action models along trajectory.)",
@@ -15,7 +15,7 @@ namespace python {
 void exposeSolverBoxFDDP() {
   bp::register_ptr_to_python<boost::shared_ptr<SolverBoxFDDP> >();
 
-  bp::class_<SolverBoxFDDP, bp::bases<SolverFDDP> >(
+  bp::class_<SolverBoxFDDP, bp::bases<SolverFDDP>, boost::noncopyable>(
       "SolverBoxFDDP",
       "Box-constrained FDDP solver.\n\n"
       ":param shootingProblem: shooting problem (list of action models along trajectory.)",
@@ -17,10 +17,49 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SolverDDP_solves, SolverDDP::solve, 0, 5)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SolverDDP_computeDirections, SolverDDP::computeDirection, 0, 1)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SolverDDP_trySteps, SolverDDP::tryStep, 0, 1)
 
+template <typename Matrix, typename Map>
+bp::list solverDDP_terms(const std::vector<Map>& terms) {
+  bp::list list;
+  for (std::size_t t = 0; t < terms.size(); ++t) {
+    list.append(Matrix(terms[t]));
+  }
+  return list;
+}
+
+bp::list solverDDP_get_Vxx(const SolverDDP& self) { return solverDDP_terms<Eigen::MatrixXd>(self.get_Vxx()); }
+bp::list solverDDP_get_Vx(const SolverDDP& self) { return solverDDP_terms<Eigen::VectorXd>(self.get_Vx()); }
+bp::list solverDDP_get_Qxx(const SolverDDP& self) { return solverDDP_terms<Eigen::MatrixXd>(self.get_Qxx()); }
+bp::list solverDDP_get_Qxu(const SolverDDP& self) { return solverDDP_terms<Eigen::MatrixXd>(self.get_Qxu()); }
+bp::list solverDDP_get_Quu(const SolverDDP& self) { return solverDDP_terms<Eigen::MatrixXd>(self.get_Quu()); }
+bp::list solverDDP_get_Qx(const SolverDDP& self) { return solverDDP_terms<Eigen::VectorXd>(self.get_Qx()); }
+bp::list solverDDP_get_Qu(const SolverDDP& self) { return solverDDP_terms<Eigen::VectorXd>(self.get_Qu()); }
+bp::list solverDDP_get_K(const SolverDDP& self) { return solverDDP_terms<Eigen::MatrixXd>(self.get_K()); }
+bp::list solverDDP_get_k(const SolverDDP& self) { return solverDDP_terms<Eigen::VectorXd>(self.get_k()); }
+bp::list solverDDP_get_fs(const SolverDDP& self) { return solverDDP_terms<Eigen::VectorXd>(self.get_fs()); }
+
+bp::list solverDDP_get_workspace_nodes(const SolverDDP& self) {
+  bp::list nodes;
+  const std::vector<std::size_t>& sizes = self.get_workspace_nodes();
+  for (std::size_t t = 0; t < sizes.size(); ++t) {
+    nodes.append(sizes[t]);
+  }
+  return nodes;
+}
+
 void exposeSolverDDP() {
   bp::register_ptr_to_python<boost::shared_ptr<SolverDDP> >();
 
-  bp::class_<SolverDDP, bp::bases<SolverAbstract> >(
+  bp::enum_<BackwardPassType>("BackwardPassType")
+      .value("BackwardPassSerial", BackwardPassSerial)
+      .value("BackwardPassPartitioned", BackwardPassPartitioned)
+      .export_values();
+
+  bp::enum_<LineSearchType>("LineSearchType")
+      .value("LineSearchSerial", LineSearchSerial)
+      .value("LineSearchConcurrent", LineSearchConcurrent)
+      .export_values();
+
+  bp::class_<SolverDDP, bp::bases<SolverAbstract>, boost::noncopyable>(
       "SolverDDP",
       "DDP solver.\n\n"
       "The DDP solver computes an optimal trajectory and control commands by iterates\n"
@@ -84,20 +123,48 @@ void exposeSolverDDP() {
            "It rollouts the action model given the computed policy (feedforward terns and feedback\n"
            "gains) by the backwardPass. We can define different step lengths\n"
            ":param stepLength: applied step length (<= 1. and >= 0.)")
-      .add_property("Vxx", make_function(&SolverDDP::get_Vxx, bp::return_value_policy<bp::copy_const_reference>()),
-                    "Vxx")
-      .add_property("Vx", make_function(&SolverDDP::get_Vx, bp::return_value_policy<bp::copy_const_reference>()), "Vx")
-      .add_property("Qxx", make_function(&SolverDDP::get_Qxx, bp::return_value_policy<bp::copy_const_reference>()),
-                    "Qxx")
-      .add_property("Qxu", make_function(&SolverDDP::get_Qxu, bp::return_value_policy<bp::copy_const_reference>()),
-                    "Qxu")
-      .add_property("Quu", make_function(&SolverDDP::get_Quu, bp::return_value_policy<bp::copy_const_reference>()),
-                    "Quu")
-      .add_property("Qx", make_function(&SolverDDP::get_Qx, bp::return_value_policy<bp::copy_const_reference>()), "Qx")
-      .add_property("Qu", make_function(&SolverDDP::get_Qu, bp::return_value_policy<bp::copy_const_reference>()), "Qu")
-      .add_property("K", make_function(&SolverDDP::get_K, bp::return_value_policy<bp::copy_const_reference>()), "K")
-      .add_property("k", make_function(&SolverDDP::get_k, bp::return_value_policy<bp::copy_const_reference>()), "k")
-      .add_property("fs", make_function(&SolverDDP::get_fs, bp::return_value_policy<bp::copy_const_reference>()), "fs")
+      .def("preparationPhase", &SolverDDP::preparationPhase, bp::args("self"),
+           "Run the preparation phase of a Real-Time Iteration (RTI).\n\n"
+           "It linearizes the problem around the current guess and runs the backward pass, so all the\n"
+           "derivative evaluations run before the new measurement arrives.\n"
+           ":returns true if the search direction was computed.")
+      .def("feedbackPhase", &SolverDDP::feedbackPhase, bp::args("self", "x0"),
+           "Run the feedback phase of a Real-Time Iteration (RTI).\n\n"
+           "It updates the initial state and applies the full step of the prepared search direction with\n"
+           "the linearized dynamics, without evaluating the action models. The control to apply is us[0].\n"
+           ":param x0: measured initial state")
+      .add_property("Vxx", &solverDDP_get_Vxx, "Vxx")
+      .add_property("Vx", &solverDDP_get_Vx, "Vx")
+      .add_property("Qxx", &solverDDP_get_Qxx, "Qxx")
+      .add_property("Qxu", &solverDDP_get_Qxu, "Qxu")
+      .add_property("Quu", &solverDDP_get_Quu, "Quu")
+      .add_property("Qx", &solverDDP_get_Qx, "Qx")
+      .add_property("Qu", &solverDDP_get_Qu, "Qu")
+      .add_property("K", &solverDDP_get_K, "K")
+      .add_property("k", &solverDDP_get_k, "k")
+      .add_property("fs", &solverDDP_get_fs, "fs")
+      .add_property("workspace_size", bp::make_function(&SolverDDP::get_workspace_size),
+                    "size in bytes of the workspace of the per-node terms")
+      .add_property("workspace_nodes", &solverDDP_get_workspace_nodes,
+                    "size in bytes used by each node in the workspace")
+      .add_property("backward_type", bp::make_function(&SolverDDP::get_backward_type),
+                    bp::make_function(&SolverDDP::set_backward_type),
+                    "type of Riccati recursion run by the backward pass (serial or partitioned across threads)")
+      .add_property("linesearch_type", bp::make_function(&SolverDDP::get_linesearch_type),
+                    bp::make_function(&SolverDDP::set_linesearch_type),
+                    "type of line search run by the solver (serial or concurrent across threads)")
+      .add_property("fixed_size", bp::make_function(&SolverDDP::get_fixed_size),
+                    bp::make_function(&SolverDDP::set_fixed_size),
+                    "true if the backward pass runs the fixed-size kernels (only compiled for some dimensions)")
+      .add_property("structured", bp::make_function(&SolverDDP::get_structured),
+                    bp::make_function(&SolverDDP::set_structured),
+                    "true if the backward pass exploits the block structure of the dynamics (e.g. Euler step)")
+      .add_property("speculative_calcDiff", bp::make_function(&SolverDDP::get_speculative_calcDiff),
+                    bp::make_function(&SolverDDP::set_speculative_calcDiff),
+                    "true if the full step speculatively computes its derivatives during its rollout")
+      .add_property("warm_start_policy", bp::make_function(&SolverDDP::get_warm_start_policy),
+                    bp::make_function(&SolverDDP::set_warm_start_policy),
+                    "true if a solve after shiftWarmStart starts from the closed-loop rollout of the previous policy")
       .add_property("reg_incFactor", bp::make_function(&SolverDDP::get_reg_incfactor),
                     bp::make_function(&SolverDDP::set_reg_incfactor),
                     "regularization factor used for increasing the damping value.")
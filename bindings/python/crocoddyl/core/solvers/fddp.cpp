@@ -18,7 +18,18 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SolverFDDP_computeDirections, SolverDDP::
 void exposeSolverFDDP() {
   bp::register_ptr_to_python<boost::shared_ptr<SolverFDDP> >();
 
-  bp::class_<SolverFDDP, bp::bases<SolverDDP> >(
+  bp::enum_<ForwardPassType>("ForwardPassType")
+      .value("ForwardPassSerial", ForwardPassSerial)
+      .value("ForwardPassPartitioned", ForwardPassPartitioned)
+      .export_values();
+
+  bp::enum_<DeadlinePhase>("DeadlinePhase")
+      .value("DeadlineNotReached", DeadlineNotReached)
+      .value("DeadlineComputeDirection", DeadlineComputeDirection)
+      .value("DeadlineLineSearch", DeadlineLineSearch)
+      .export_values();
+
+  bp::class_<SolverFDDP, bp::bases<SolverDDP>, boost::noncopyable>(
       "SolverFDDP",
       "Feasibility-driven DDP (FDDP) solver.\n\n"
       "The FDDP solver computes an optimal trajectory and control commands by iterates\n"
@@ -45,13 +56,27 @@ void exposeSolverFDDP() {
                "False).\n"
                ":param regInit: initial guess for the regularization value. Very low values are typical\n"
                "                used with very good guess points (init_xs, init_us) (default None).\n"
+               "The solver also stops, keeping the last accepted iterate, once the time budget (deadline) expires.\n"
                ":returns the optimal trajectory xopt, uopt and a boolean that describes if convergence was reached."))
       .def("updateExpectedImprovement", &SolverFDDP::updateExpectedImprovement,
            bp::return_value_policy<bp::copy_const_reference>(), bp::args("self"),
            "Update the expected improvement model\n\n")
       .add_property("th_acceptNegStep", bp::make_function(&SolverFDDP::get_th_acceptnegstep),
                     bp::make_function(&SolverFDDP::set_th_acceptnegstep),
-                    "threshold for step acceptance in ascent direction");
+                    "threshold for step acceptance in ascent direction")
+      .add_property("forward_type", bp::make_function(&SolverFDDP::get_forward_type),
+                    bp::make_function(&SolverFDDP::set_forward_type),
+                    "type of rollout run by the forward pass (serial or partitioned across threads)")
+      .add_property("th_boundgap", bp::make_function(&SolverFDDP::get_th_boundgap),
+                    bp::make_function(&SolverFDDP::set_th_boundgap),
+                    "threshold for closing the boundary gaps of the partitioned rollout (default 1e-9)")
+      .add_property("deadline", bp::make_function(&SolverFDDP::get_deadline),
+                    bp::make_function(&SolverFDDP::set_deadline),
+                    "time budget of solve in milliseconds (default inf)")
+      .add_property("deadline_phase", bp::make_function(&SolverFDDP::get_deadline_phase),
+                    "phase in which the time budget of the last solve expired")
+      .add_property("direction_outdated", bp::make_function(&SolverFDDP::get_direction_outdated),
+                    "true if a step was accepted after computing the search direction");
 }
 
 }  // namespace python
@@ -19,11 +19,17 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SolverKKT_trySteps, SolverKKT::tryStep, 0
 void exposeSolverKKT() {
   bp::register_ptr_to_python<boost::shared_ptr<SolverKKT> >();
 
+  bp::enum_<KKTFactorizationType>("KKTFactorizationType")
+      .value("KKTFactorizationRiccati", KKTFactorizationRiccati)
+      .value("KKTFactorizationDense", KKTFactorizationDense)
+      .export_values();
+
   bp::class_<SolverKKT, bp::bases<SolverAbstract> >(
       "SolverKKT",
       "KKT solver.\n\n"
       "The KKT solver computes a primal and dual optimal by inverting\n"
-      "the kkt matrix \n"
+      "the kkt matrix. By default, the block-tridiagonal KKT system is factorized\n"
+      "by a Riccati recursion over the node blocks, which scales linearly with the horizon.\n"
       ":param shootingProblem: shooting problem (list of action models along trajectory.)",
       bp::init<boost::shared_ptr<ShootingProblem> >(bp::args("self", "problem"),
                                                     "Initialize the vector dimension.\n\n"
@@ -62,8 +68,11 @@ void exposeSolverKKT() {
            "For computing the expected improvement, you need to compute first\n"
            "the search direction by running computeDirection. The quadratic\n"
            "improvement model is described as dV = f_0 - f_+ = d1*a + d2*a**2/2.")
+      .add_property("factorization_type", bp::make_function(&SolverKKT::get_factorization_type),
+                    bp::make_function(&SolverKKT::set_factorization_type),
+                    "type of factorization of the KKT system (Riccati or dense)")
       .add_property("kkt", make_function(&SolverKKT::get_kkt, bp::return_value_policy<bp::copy_const_reference>()),
-                    "kkt")
+                    "kkt (assembled on demand with the Riccati factorization)")
       .add_property("kktref",
                     make_function(&SolverKKT::get_kktref, bp::return_value_policy<bp::copy_const_reference>()),
                     "kktref")
@@ -90,6 +90,8 @@ void exposeStateAbstract() {
       .add_property("nq", bp::make_function(&StateAbstract_wrap::get_nq), "dimension of the configuration tuple")
       .add_property("nv", bp::make_function(&StateAbstract_wrap::get_nv),
                     "dimension of tangent space of the configuration manifold")
+      .add_property("ndx_lie", bp::make_function(&StateAbstract_wrap::get_ndx_lie),
+                    "number of leading directions of the tangent space that are not integrated as a vector space")
       .add_property("has_limits", bp::make_function(&StateAbstract_wrap::get_has_limits),
                     "indicates whether problem has finite state limits")
       .add_property("lb", bp::make_getter(&StateAbstract_wrap::lb_, bp::return_internal_reference<>()),
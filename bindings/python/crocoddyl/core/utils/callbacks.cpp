@@ -25,6 +25,22 @@ void exposeCallbacks() {
       .def("__call__", &CallbackVerbose::operator(), bp::args("self", "solver"),
            "Run the callback function given a solver.\n\n"
            ":param solver: solver to be diagnostic");
+
+  bp::class_<CallbackPolicyPublisher, bp::bases<CallbackAbstract> >(
+      "CallbackPolicyPublisher",
+      "Callback function for publishing the feedback policy of the solver.\n\n"
+      "After each iteration, it publishes the first nodes of xs, us and K of a DDP-based solver into a\n"
+      "lock-free buffer, from which a control thread can read the latest policy.",
+      bp::init<boost::shared_ptr<PolicyBuffer> >(bp::args("self", "buffer"),
+                                                 "Initialize the policy publisher callback.\n\n"
+                                                 ":param buffer: buffer in which the policy is published"))
+      .def("__call__", &CallbackPolicyPublisher::operator(), bp::args("self", "solver"),
+           "Run the callback function given a solver.\n\n"
+           ":param solver: solver whose policy is published")
+      .add_property("buffer",
+                    bp::make_function(&CallbackPolicyPublisher::get_buffer,
+                                      bp::return_value_policy<bp::copy_const_reference>()),
+                    "buffer in which the policy is published");
 }
 
 }  // namespace python
@@ -0,0 +1,77 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <sstream>
+
+#include "python/crocoddyl/core/core.hpp"
+#include "crocoddyl/core/utils/instrumentation.hpp"
+
+namespace crocoddyl {
+namespace python {
+
+void instrumentation_set_enabled(const bool enabled) { Instrumentation::set_enabled(enabled); }
+
+bool instrumentation_get_enabled() { return Instrumentation::get_enabled(); }
+
+void instrumentation_reset() { getInstrumentation().reset(); }
+
+std::string instrumentation_report() {
+  std::ostringstream os;
+  getInstrumentation().report(os);
+  return os.str();
+}
+
+LatencyHistogram instrumentation_get_histogram(const ProbeType probe) {
+  return getInstrumentation().get_histogram(probe);
+}
+
+void exposeInstrumentation() {
+  bp::enum_<ProbeType>("ProbeType")
+      .value("ProbeCalcDiff", ProbeCalcDiff)
+      .value("ProbeBackwardPass", ProbeBackwardPass)
+      .value("ProbeForwardPass", ProbeForwardPass)
+      .value("ProbeComputeGains", ProbeComputeGains)
+      .value("ProbeNodeCalc", ProbeNodeCalc)
+      .value("ProbeNodeCalcDiff", ProbeNodeCalcDiff)
+      .value("ProbeNodeCalcAndDiff", ProbeNodeCalcAndDiff)
+      .export_values();
+
+  bp::class_<LatencyHistogram>("LatencyHistogram",
+                               "Latency histogram with log-linear buckets.\n\n"
+                               "Each power of two is split into linear buckets, as in HDR histograms.",
+                               bp::init<>(bp::args("self"), "Initialize an empty histogram."))
+      .def("record", &LatencyHistogram::record, bp::args("self", "ns"),
+           "Record a latency.\n\n"
+           ":param ns: latency in nanoseconds")
+      .def("merge", &LatencyHistogram::merge, bp::args("self", "other"), "Add the records of another histogram.")
+      .def("reset", &LatencyHistogram::reset, bp::args("self"), "Remove all the records.")
+      .def("percentile", &LatencyHistogram::get_percentile, bp::args("self", "p"),
+           "Return the latency (in microseconds) below which a fraction of the records lies.\n\n"
+           ":param p: fraction of the records, in [0, 1]")
+      .add_property("count", bp::make_function(&LatencyHistogram::get_count), "number of records")
+      .add_property("min", bp::make_function(&LatencyHistogram::get_min), "minimum latency in microseconds")
+      .add_property("max", bp::make_function(&LatencyHistogram::get_max), "maximum latency in microseconds")
+      .add_property("mean", bp::make_function(&LatencyHistogram::get_mean), "mean latency in microseconds");
+
+  bp::def("instrumentation_set_enabled", instrumentation_set_enabled, bp::args("enabled"),
+          "Enable or disable the latency probes of the solvers.");
+
+  bp::def("instrumentation_get_enabled", instrumentation_get_enabled,
+          "Return true if the latency probes of the solvers are enabled.");
+
+  bp::def("instrumentation_reset", instrumentation_reset, "Remove the latencies recorded by all the threads.");
+
+  bp::def("instrumentation_report", instrumentation_report,
+          "Return the count, mean, percentiles and maximum latency of the probes with records.");
+
+  bp::def("instrumentation_get_histogram", instrumentation_get_histogram, bp::args("probe"),
+          "Return the latency histogram of a probe merged over all the threads.");
+}
+
+}  // namespace python
+}  // namespace crocoddyl
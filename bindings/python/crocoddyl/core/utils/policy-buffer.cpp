@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "python/crocoddyl/core/core.hpp"
+#include "crocoddyl/core/utils/policy-buffer.hpp"
+
+namespace crocoddyl {
+namespace python {
+
+Eigen::VectorXd policy_computeControl(const Policy& self, const std::size_t t, const Eigen::VectorXd& dx) {
+  Eigen::VectorXd u;
+  self.computeControl(t, dx, u);
+  return u;
+}
+
+void exposePolicyBuffer() {
+  bp::register_ptr_to_python<boost::shared_ptr<PolicyBuffer> >();
+
+  bp::class_<Policy>(
+      "Policy",
+      "Feedback policy of the first nodes of the horizon.\n\n"
+      "The control of the node t is u[t] - K[t] * (x - xs[t]).",
+      bp::init<std::size_t, std::size_t, std::size_t, std::size_t>(
+          bp::args("self", "nodes", "nx", "ndx", "nu"),
+          "Initialize the policy.\n\n"
+          ":param nodes: number of nodes\n"
+          ":param nx: dimension of the state\n"
+          ":param ndx: dimension of the tangent space of the state manifold\n"
+          ":param nu: dimension of the control"))
+      .def("computeControl", &policy_computeControl, bp::args("self", "t", "dx"),
+           "Compute the control of a node given the deviation from its state.\n\n"
+           ":param t: node index\n"
+           ":param dx: deviation from the state of the node\n"
+           ":return control")
+      .add_property("xs", bp::make_getter(&Policy::xs, bp::return_value_policy<bp::return_by_value>()),
+                    "state trajectory")
+      .add_property("us", bp::make_getter(&Policy::us, bp::return_value_policy<bp::return_by_value>()),
+                    "control trajectory")
+      .add_property("K", bp::make_getter(&Policy::K, bp::return_value_policy<bp::return_by_value>()),
+                    "feedback gains")
+      .def_readonly("iter", &Policy::iter, "iteration of the solver that produced the policy")
+      .def_readonly("sequence", &Policy::sequence, "number of the publication (0 if nothing has been published)")
+      .def_readonly("timestamp", &Policy::timestamp, "time of the publication in seconds (monotonic clock)");
+
+  bp::class_<PolicyBuffer, boost::noncopyable>(
+      "PolicyBuffer",
+      "Lock-free triple buffer of feedback policies.\n\n"
+      "It transfers the latest policy from the solver thread (writer) to a control thread (reader),\n"
+      "without blocking any of them. It supports a single writer and a single reader thread.",
+      bp::init<std::size_t, std::size_t, std::size_t, std::size_t>(
+          bp::args("self", "nodes", "nx", "ndx", "nu"),
+          "Initialize the buffer.\n\n"
+          ":param nodes: number of nodes of the policy\n"
+          ":param nx: dimension of the state\n"
+          ":param ndx: dimension of the tangent space of the state manifold\n"
+          ":param nu: dimension of the control"))
+      .def("publish", &PolicyBuffer::publish, bp::args("self", "iter"),
+           "Publish the policy filled by the writer.\n\n"
+           ":param iter: iteration of the solver that produced the policy")
+      .def("read", &PolicyBuffer::read, bp::return_value_policy<bp::copy_const_reference>(), bp::args("self"),
+           "Return a copy of the latest published policy.")
+      .add_property("back", bp::make_function(&PolicyBuffer::get_back, bp::return_internal_reference<>()),
+                    "policy filled by the writer")
+      .add_property("has_update", bp::make_function(&PolicyBuffer::has_update),
+                    "true if a policy was published after the last read")
+      .add_property("nodes", bp::make_function(&PolicyBuffer::get_nodes), "number of nodes of the policy");
+}
+
+}  // namespace python
+}  // namespace crocoddyl
@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "python/crocoddyl/core/core.hpp"
+#include "crocoddyl/core/utils/scheduler.hpp"
+
+namespace crocoddyl {
+namespace python {
+
+bp::list scheduler_get_affinity(const SchedulerThreadPool& self) {
+  bp::list cores;
+  const std::vector<std::size_t>& affinity = self.get_affinity();
+  for (std::size_t i = 0; i < affinity.size(); ++i) {
+    cores.append(affinity[i]);
+  }
+  return cores;
+}
+
+void scheduler_set_affinity(SchedulerThreadPool& self, const bp::list& cores) {
+  std::vector<std::size_t> affinity(bp::len(cores));
+  for (std::size_t i = 0; i < affinity.size(); ++i) {
+    affinity[i] = bp::extract<std::size_t>(cores[i]);
+  }
+  self.set_affinity(affinity);
+}
+
+void exposeScheduler() {
+  bp::register_ptr_to_python<boost::shared_ptr<SchedulerAbstract> >();
+
+  bp::class_<SchedulerAbstract, boost::noncopyable>(
+      "SchedulerAbstract",
+      "Abstract class for task schedulers.\n\n"
+      "A scheduler distributes the nodes of the parallel loops (e.g. calc and calcDiff of a shooting problem)\n"
+      "among a number of threads, which can be modified at runtime.",
+      bp::no_init)
+      .add_property("nthreads", bp::make_function(&SchedulerAbstract::get_nthreads),
+                    bp::make_function(&SchedulerAbstract::set_nthreads), "number of threads");
+
+  bp::class_<SchedulerOpenMP, bp::bases<SchedulerAbstract>, boost::noncopyable>(
+      "SchedulerOpenMP",
+      "OpenMP scheduler.\n\n"
+      "It runs the parallel loops with OpenMP, and serially if crocoddyl is built without multithreading support.",
+      bp::init<bp::optional<std::size_t> >(bp::args("self", "nthreads"),
+                                           "Initialize the OpenMP scheduler.\n\n"
+                                           ":param nthreads: number of threads (default CROCODDYL_WITH_NTHREADS)"));
+
+  bp::class_<SchedulerThreadPool, bp::bases<SchedulerAbstract>, boost::noncopyable>(
+      "SchedulerThreadPool",
+      "Work-stealing thread pool.\n\n"
+      "The calling thread runs the loops together with nthreads - 1 workers, which steal iterations among them\n"
+      "to balance the load.",
+      bp::init<bp::optional<std::size_t> >(bp::args("self", "nthreads"),
+                                           "Initialize the thread pool.\n\n"
+                                           ":param nthreads: number of threads (default hardware concurrency)"))
+      .add_property("affinity", &scheduler_get_affinity, &scheduler_set_affinity,
+                    "cores in which the workers are pinned (only supported in Linux)");
+}
+
+}  // namespace python
+}  // namespace crocoddyl
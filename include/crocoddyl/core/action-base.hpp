@@ -101,6 +101,19 @@ class ActionModelAbstractTpl {
   virtual void calcDiff(const boost::shared_ptr<ActionDataAbstract>& data, const Eigen::Ref<const VectorXs>& x,
                         const Eigen::Ref<const VectorXs>& u) = 0;
 
+  /**
+   * @brief Compute the next state, cost value and their derivatives
+   *
+   * It is equivalent to run `calc()` and then `calcDiff()`, which is the default behaviour. Models override it to
+   * share the computations of both functions, e.g. the dynamics that are also obtained by its derivatives.
+   *
+   * @param[in] data  Action data
+   * @param[in] x     State point
+   * @param[in] u     Control input
+   */
+  virtual void calcAndDiff(const boost::shared_ptr<ActionDataAbstract>& data, const Eigen::Ref<const VectorXs>& x,
+                           const Eigen::Ref<const VectorXs>& u);
+
   /**
    * @brief Create the action data
    *
@@ -129,6 +142,14 @@ class ActionModelAbstractTpl {
    */
   void calcDiff(const boost::shared_ptr<ActionDataAbstract>& data, const Eigen::Ref<const VectorXs>& x);
 
+  /**
+   * @copybrief calcAndDiff()
+   *
+   * @param[in] data  Action data
+   * @param[in] x     State point
+   */
+  void calcAndDiff(const boost::shared_ptr<ActionDataAbstract>& data, const Eigen::Ref<const VectorXs>& x);
+
   /**
    * @brief Computes the quasic static commands
    *
@@ -240,7 +261,10 @@ struct ActionDataAbstractTpl {
         Lu(model->get_nu()),
         Lxx(model->get_state()->get_ndx(), model->get_state()->get_ndx()),
         Lxu(model->get_state()->get_ndx(), model->get_nu()),
-        Luu(model->get_nu(), model->get_nu()) {
+        Luu(model->get_nu(), model->get_nu()),
+        F_structured(false),
+        F_dt(Scalar(0.)),
+        F_ndense(0) {
     xnext.setZero();
     Fx.setZero();
     Fu.setZero();
@@ -263,6 +287,13 @@ struct ActionDataAbstractTpl {
   MatrixXs Lxx;    //!< Hessian of the cost function
   MatrixXs Lxu;    //!< Hessian of the cost function
   MatrixXs Luu;    //!< Hessian of the cost function
+
+  // Block structure of the Jacobians of the dynamics. If the dynamics is an explicit Euler step, i.e.
+  // Fx = [dt Fxv + [I 0]; Fxv] and Fu = [dt Fuv; Fuv] where Fxv, Fuv are their velocity rows, then this holds for all
+  // the configuration rows except the first F_ndense ones (i.e. the Lie-group directions of the state)
+  bool F_structured;     //!< True if Fx and Fu have the block structure of an explicit Euler step
+  Scalar F_dt;           //!< Time step of the Euler step
+  std::size_t F_ndense;  //!< Number of leading configuration rows of Fx and Fu without this structure
 };
 
 }  // namespace crocoddyl
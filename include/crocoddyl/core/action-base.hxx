@@ -40,6 +40,20 @@ void ActionModelAbstractTpl<Scalar>::calcDiff(const boost::shared_ptr<ActionData
   calcDiff(data, x, unone_);
 }
 
+template <typename Scalar>
+void ActionModelAbstractTpl<Scalar>::calcAndDiff(const boost::shared_ptr<ActionDataAbstract>& data,
+                                                 const Eigen::Ref<const VectorXs>& x,
+                                                 const Eigen::Ref<const VectorXs>& u) {
+  calc(data, x, u);
+  calcDiff(data, x, u);
+}
+
+template <typename Scalar>
+void ActionModelAbstractTpl<Scalar>::calcAndDiff(const boost::shared_ptr<ActionDataAbstract>& data,
+                                                 const Eigen::Ref<const VectorXs>& x) {
+  calcAndDiff(data, x, unone_);
+}
+
 template <typename Scalar>
 void ActionModelAbstractTpl<Scalar>::quasiStatic(const boost::shared_ptr<ActionDataAbstract>& data,
                                                  Eigen::Ref<VectorXs> u, const Eigen::Ref<const VectorXs>& x,
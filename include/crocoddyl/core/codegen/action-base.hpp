@@ -10,13 +10,53 @@
 #ifndef CROCODDYL_CORE_CODEGEN_ACTION_BASE_HPP_
 #define CROCODDYL_CORE_CODEGEN_ACTION_BASE_HPP_
 
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <functional>
+#include <mutex>
+#include <sstream>
 #include "pinocchio/codegen/cppadcg.hpp"
 
 #include "crocoddyl/core/action-base.hpp"
+#include "crocoddyl/core/codegen/compiler.hpp"
+#include "crocoddyl/core/utils/exception.hpp"
+#include "crocoddyl/core/utils/scheduler.hpp"
 
 namespace crocoddyl {
 
+/**
+ * @brief Exclusive lock of a file shared among processes
+ *
+ * The lock is released when the object is destroyed, including when an exception is thrown.
+ */
+class CodeGenFileLock {
+ public:
+  explicit CodeGenFileLock(const std::string& filename) : fd_(::open(filename.c_str(), O_RDWR | O_CREAT, 0666)) {
+    if (fd_ == -1 || ::flock(fd_, LOCK_EX) != 0) {
+      if (fd_ != -1) {
+        ::close(fd_);
+      }
+      throw_pretty("Invalid argument: "
+                   << "cannot lock " + filename + ": " + std::strerror(errno));
+    }
+  }
+  ~CodeGenFileLock() {
+    ::flock(fd_, LOCK_UN);
+    ::close(fd_);
+  }
+
+ private:
+  CodeGenFileLock(const CodeGenFileLock&);
+  CodeGenFileLock& operator=(const CodeGenFileLock&);
+
+  int fd_;  //!< File descriptor of the lock file
+};
+
 template <typename Scalar>
 struct ActionDataCodeGenTpl;
 
@@ -44,12 +84,15 @@ class ActionModelCodeGenTpl : public ActionModelAbstractTpl<_Scalar> {
 
   typedef CppAD::ADFun<CGScalar> ADFun;
 
+  static const int cache_version = 2;  //!< Version of the generated functions, which is part of the library key
+
   ActionModelCodeGenTpl(boost::shared_ptr<ADBase> admodel, boost::shared_ptr<Base> model,
                         const std::string& library_name, const std::size_t n_env = 0,
                         std::function<void(boost::shared_ptr<ADBase>, const Eigen::Ref<const ADVectorXs>&)>
                             fn_record_env = empty_record_env,
                         const std::string& function_name_calc = "calc",
-                        const std::string& function_name_calcDiff = "calcDiff")
+                        const std::string& function_name_calcDiff = "calcDiff",
+                        const CodeGenOptions& options = CodeGenOptions())
       : Base(model->get_state(), model->get_nu()),
         model(model),
         ad_model(admodel),
@@ -59,6 +102,7 @@ class ActionModelCodeGenTpl : public ActionModelAbstractTpl<_Scalar> {
         library_name(library_name),
         n_env(n_env),
         fn_record_env(fn_record_env),
+        options(options),
         ad_X(ad_model->get_state()->get_nx() + ad_model->get_nu() + n_env),
         ad_X2(ad_model->get_state()->get_nx() + ad_model->get_nu() + n_env),
         ad_calcout(ad_model->get_state()->get_nx() + 1) {
@@ -123,10 +167,41 @@ class ActionModelCodeGenTpl : public ActionModelAbstractTpl<_Scalar> {
     ad_model->calcDiff(ad_data, ad_X2.head(nx), ad_X2.segment(nx, nu));
 
     collect_calcDiffout();
-    ad_calcDiff.Dependent(ad_X2, ad_calcDiffout);
+    detectCalcDiffSparsity();
+    ADVectorXs ad_Y(calcDiff_outputs.size());
+    for (std::size_t k = 0; k < calcDiff_outputs.size(); ++k) {
+      ad_Y[k] = ad_calcDiffout[calcDiff_outputs[k]];
+    }
+    ad_calcDiff.Dependent(ad_X2, ad_Y);
     ad_calcDiff.optimize("no_compare_op");
   }
 
+  /**
+   * @brief Detect the entries of the derivatives that do not depend on the inputs
+   *
+   * These entries (e.g. the structural zeros of `Fx` and `Lxx` in multibody models) are parameters of the recorded
+   * tape. They are stored in `calcDiff_constants` and written once when the data is created, so the generated
+   * function only computes and writes the other entries, listed in `calcDiff_outputs`. When `options.sparsity` is
+   * false, all the entries are outputs of the generated function.
+   */
+  void detectCalcDiffSparsity() {
+    const std::size_t nY = static_cast<std::size_t>(ad_calcDiffout.size());
+    calcDiff_outputs.clear();
+    calcDiff_constants = VectorXs::Zero(nY);
+    for (std::size_t i = 0; i < nY; ++i) {
+      const ADScalar& y = ad_calcDiffout[i];
+      if (!options.sparsity || CppAD::Variable(y) || !CppAD::Value(y).isValueDefined()) {
+        calcDiff_outputs.push_back(i);
+      } else {
+        calcDiff_constants[i] = CppAD::Value(y).getValue();
+      }
+    }
+    if (calcDiff_outputs.empty()) {
+      // the generated function needs at least one output
+      calcDiff_outputs.push_back(0);
+    }
+  }
+
   void initLib() {
     recordCalc();
 
@@ -135,6 +210,9 @@ class ActionModelCodeGenTpl : public ActionModelAbstractTpl<_Scalar> {
         new CppAD::cg::ModelCSourceGen<Scalar>(ad_calc, function_name_calc));
     calcgen_ptr->setCreateForwardZero(true);
     calcgen_ptr->setCreateJacobian(false);
+    if (options.max_assignments != 0) {
+      calcgen_ptr->setMaxAssignmentsPerFunc(options.max_assignments);
+    }
 
     // generates source code
     recordCalcDiff();
@@ -142,25 +220,125 @@ class ActionModelCodeGenTpl : public ActionModelAbstractTpl<_Scalar> {
         new CppAD::cg::ModelCSourceGen<Scalar>(ad_calcDiff, function_name_calcDiff));
     calcDiffgen_ptr->setCreateForwardZero(true);
     calcDiffgen_ptr->setCreateJacobian(false);
+    if (options.max_assignments != 0) {
+      // splits the generated code into several translation units that are compiled in parallel
+      calcDiffgen_ptr->setMaxAssignmentsPerFunc(options.max_assignments);
+    }
 
     libcgen_ptr = std::unique_ptr<CppAD::cg::ModelLibraryCSourceGen<Scalar> >(
         new CppAD::cg::ModelLibraryCSourceGen<Scalar>(*calcgen_ptr, *calcDiffgen_ptr));
 
+    // the library name contains the key of its content, so a modified model never loads a stale library
+    library_key = computeLibraryKey();
     dynamicLibManager_ptr = std::unique_ptr<CppAD::cg::DynamicModelLibraryProcessor<Scalar> >(
-        new CppAD::cg::DynamicModelLibraryProcessor<Scalar>(*libcgen_ptr, library_name));
+        new CppAD::cg::DynamicModelLibraryProcessor<Scalar>(*libcgen_ptr, library_name + "_" + library_key));
   }
 
-  void compileLib() {
-    CppAD::cg::GccCompiler<Scalar> compiler;
+  /**
+   * @brief Compile the generated library into the cache
+   *
+   * The library is built under a temporary name and then atomically renamed, so concurrent processes that share the
+   * cache never load a partial library. A lock file serializes the compilation of the same key, and the processes
+   * that waited for it load the library built by the first one.
+   */
+  void compileLib() { compileLibrary(*dynamicLibManager_ptr, options); }
+
+  /**
+   * @brief Compile a generated library into the cache
+   *
+   * \sa `compileLib()`
+   */
+  static void compileLibrary(CppAD::cg::DynamicModelLibraryProcessor<Scalar>& processor,
+                             const CodeGenOptions& options) {
+    const std::string name = processor.getLibraryName();
+    const std::string extension = CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
+    CodeGenFileLock lock(name + ".lock");
+    if (existLibrary(name)) {
+      return;
+    }
+    const std::string tmp_name = name + ".tmp" + std::to_string(::getpid());
+    CodeGenCompilerTpl<Scalar> compiler(options.njobs, options.object_cache);
+    compiler.setCompileFlags(getCompileFlags(compiler));
+    compiler.setTemporaryFolder(tmp_name + "_objs");
+    processor.setLibraryName(tmp_name);
+    try {
+      processor.createDynamicLibrary(compiler, false);
+    } catch (...) {
+      processor.setLibraryName(name);
+      std::remove((tmp_name + extension).c_str());
+      throw;
+    }
+    processor.setLibraryName(name);
+    if (std::rename((tmp_name + extension).c_str(), (name + extension).c_str()) != 0) {
+      std::remove((tmp_name + extension).c_str());
+      throw_pretty("Invalid argument: "
+                   << "cannot move the compiled library to " + name + extension + ": " + std::strerror(errno));
+    }
+  }
+
+  /**
+   * @brief Return the compile flags of the generated library
+   */
+  static std::vector<std::string> getCompileFlags(const CppAD::cg::GccCompiler<Scalar>& compiler) {
     std::vector<std::string> compile_options = compiler.getCompileFlags();
     compile_options[0] = "-O3";
-    compiler.setCompileFlags(compile_options);
-    dynamicLibManager_ptr->createDynamicLibrary(compiler, false);
+    return compile_options;
+  }
+
+  /**
+   * @brief Compute the key of the generated library
+   *
+   * It hashes the dimensions and a numerical evaluation of the recorded `calc` and `calcDiff` tapes, together with
+   * the environment size, the function names, the compiler and its flags. Therefore any change in the model (or its
+   * parameters) or in the compile options produces a new library instead of reusing a stale one.
+   */
+  std::string computeLibraryKey() {
+    CppAD::cg::GccCompiler<Scalar> compiler;
+    std::ostringstream content;
+    content << cache_version << " " << function_name_calc << " " << function_name_calcDiff << " " << n_env << " "
+            << compiler.getCompilerPath();
+    const std::vector<std::string> compile_options = getCompileFlags(compiler);
+    for (std::size_t i = 0; i < compile_options.size(); ++i) {
+      content << " " << compile_options[i];
+    }
+    fingerprintTape(ad_calc, content);
+    fingerprintTape(ad_calcDiff, content);
+    for (std::size_t k = 0; k < calcDiff_outputs.size(); ++k) {
+      content << " " << calcDiff_outputs[k];
+    }
+
+    return codegenHash(content.str());
+  }
+
+  /**
+   * @brief Write the dimensions of a tape and its outputs at a fixed input
+   */
+  static void fingerprintTape(ADFun& fun, std::ostream& os) {
+    os << " " << fun.Domain() << " " << fun.Range() << " " << fun.size_var() << " " << fun.size_par() << " "
+       << fun.size_op();
+    CppAD::vector<CGScalar> x(fun.Domain());
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      x[i] = CGScalar(Scalar(0.1) + Scalar(0.01) * Scalar(i));
+    }
+    const CppAD::vector<CGScalar> y = fun.Forward(0, x);
+    for (std::size_t i = 0; i < y.size(); ++i) {
+      if (y[i].isValueDefined()) {
+        const Scalar value = y[i].getValue();
+        os.write(reinterpret_cast<const char*>(&value), sizeof(Scalar));
+      } else {
+        os << "?";
+      }
+    }
+    fun.capacity_order(0);
   }
 
-  bool existLib() const {
-    const std::string filename =
-        dynamicLibManager_ptr->getLibraryName() + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
+  bool existLib() const { return existLibrary(dynamicLibManager_ptr->getLibraryName()); }
+
+  /**
+   * @brief Return true if the library of a given name (without extension) was already compiled
+   */
+  static bool existLibrary(const std::string& name) {
+    const std::string filename = name + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
     std::ifstream file(filename.c_str());
     return file.good();
   }
@@ -213,6 +391,73 @@ class ActionModelCodeGenTpl : public ActionModelAbstractTpl<_Scalar> {
     d->distribute_calcDiffout();
   }
 
+  /**
+   * @brief Evaluate the generated calc for a batch of inputs
+   *
+   * Each column of `xus` is an input vector \f$[\mathbf{x};\mathbf{u};\mathbf{env}]\f$ (of dimension
+   * `getInputDimension()`), and the generated function writes the cost and the next state of each column directly
+   * into the same column of `calcout`, without copying them into a data. The batch is split into contiguous chunks of
+   * columns, one per thread of the scheduler, and each chunk is evaluated with its own copy of the generated model.
+   * The copies belong to a workspace that is taken by this call and returned at the end, so the batched evaluations
+   * can be called concurrently (e.g. from several threads of the user or from a parallel loop of the scheduler).
+   * Note that the generated code is scalar, so the columns of a chunk are evaluated one after the other.
+   *
+   * @param[in]  xus        Inputs of the batch, one per column
+   * @param[out] calcout    Cost and next state of each input (dimension \f$(1+nx)\times K\f$)
+   * @param[in]  scheduler  Scheduler that runs the chunks of the batch
+   */
+  void calcBatch(const Eigen::Ref<const MatrixXs>& xus, Eigen::Ref<MatrixXs> calcout,
+                 const boost::shared_ptr<SchedulerAbstract>& scheduler) {
+    BatchLease lease(*this);
+    evaluateCalcBatch(lease, xus, calcout, scheduler);
+  }
+
+  /**
+   * @brief Evaluate the generated calc for a batch of inputs with a number of threads
+   *
+   * It runs the batch in a default scheduler (see `createDefaultScheduler()`), which is kept in the taken workspace.
+   *
+   * @param[in]  xus       Inputs of the batch, one per column
+   * @param[out] calcout   Cost and next state of each input (dimension \f$(1+nx)\times K\f$)
+   * @param[in]  nthreads  Number of threads
+   */
+  void calcBatch(const Eigen::Ref<const MatrixXs>& xus, Eigen::Ref<MatrixXs> calcout, const std::size_t nthreads = 1) {
+    BatchLease lease(*this);
+    evaluateCalcBatch(lease, xus, calcout, lease.getScheduler(nthreads));
+  }
+
+  /**
+   * @brief Evaluate the generated calcDiff for a batch of inputs
+   *
+   * Each column of `calcDiffout` receives the derivatives of the input in the same column of `xus`, in the layout of
+   * `collect_calcDiffout()`, i.e. \f$[\mathbf{F_x}, \mathbf{F_u}, \mathbf{l_x}, \mathbf{l_u}, \mathbf{l_{xx}},
+   * \mathbf{l_{xu}}, \mathbf{l_{uu}}]\f$ with column-major matrices. The generated function writes its compact
+   * outputs at the top of the column, and then they are expanded in place together with the constant derivatives.
+   * The batch is scheduled as in `calcBatch()`.
+   *
+   * @param[in]  xus          Inputs of the batch, one per column
+   * @param[out] calcDiffout  Derivatives of each input (dimension `get_calcDiff_constants().size()` \f$\times K\f$)
+   * @param[in]  scheduler    Scheduler that runs the chunks of the batch
+   */
+  void calcDiffBatch(const Eigen::Ref<const MatrixXs>& xus, Eigen::Ref<MatrixXs> calcDiffout,
+                     const boost::shared_ptr<SchedulerAbstract>& scheduler) {
+    BatchLease lease(*this);
+    evaluateCalcDiffBatch(lease, xus, calcDiffout, scheduler);
+  }
+
+  /**
+   * @brief Evaluate the generated calcDiff for a batch of inputs with a number of threads
+   *
+   * @param[in]  xus          Inputs of the batch, one per column
+   * @param[out] calcDiffout  Derivatives of each input (dimension `get_calcDiff_constants().size()` \f$\times K\f$)
+   * @param[in]  nthreads     Number of threads
+   */
+  void calcDiffBatch(const Eigen::Ref<const MatrixXs>& xus, Eigen::Ref<MatrixXs> calcDiffout,
+                     const std::size_t nthreads = 1) {
+    BatchLease lease(*this);
+    evaluateCalcDiffBatch(lease, xus, calcDiffout, lease.getScheduler(nthreads));
+  }
+
   boost::shared_ptr<ActionDataAbstract> createData() {
     return boost::allocate_shared<Data>(Eigen::aligned_allocator<Data>(), this);
   }
@@ -220,7 +465,170 @@ class ActionModelCodeGenTpl : public ActionModelAbstractTpl<_Scalar> {
   /// \brief Dimension of the input vector
   Eigen::DenseIndex getInputDimension() const { return ad_X.size(); }
 
+  /// \brief Key of the generated library, which is appended to its name
+  const std::string& get_library_key() const { return library_key; }
+
+  /// \brief Positions of the entries computed by the generated calcDiff in the layout of `collect_calcDiffout()`
+  const std::vector<std::size_t>& get_calcDiff_outputs() const { return calcDiff_outputs; }
+
+  /// \brief Values of the constant entries of the derivatives (zero for the entries computed by calcDiff)
+  const VectorXs& get_calcDiff_constants() const { return calcDiff_constants; }
+
  protected:
+  /**
+   * @brief Copies of the generated models used by a batched evaluation
+   *
+   * The generated models keep the pointers of their arguments in internal buffers, so each chunk of a batch needs its
+   * own copy.
+   */
+  struct BatchWorkspace {
+    boost::shared_ptr<SchedulerAbstract> scheduler;  //!< Default scheduler of the calls with a number of threads
+    std::vector<std::unique_ptr<CppAD::cg::GenericModel<Scalar> > > calcFuns;      //!< Generated calc per chunk
+    std::vector<std::unique_ptr<CppAD::cg::GenericModel<Scalar> > > calcDiffFuns;  //!< Generated calcDiff per chunk
+  };
+
+  /**
+   * @brief Take an idle workspace of the model during its lifetime
+   *
+   * A new workspace is created if all of them are taken by other calls. The copies of the generated models are
+   * loaded under the lock of the model, as the dynamic library keeps track of them.
+   */
+  class BatchLease {
+   public:
+    explicit BatchLease(ActionModelCodeGenTpl& model) : model_(model) {
+      std::lock_guard<std::mutex> lock(model_.batch_mutex);
+      if (model_.batch_workspaces.empty()) {
+        workspace_.reset(new BatchWorkspace());
+      } else {
+        workspace_ = std::move(model_.batch_workspaces.back());
+        model_.batch_workspaces.pop_back();
+      }
+    }
+    ~BatchLease() {
+      std::lock_guard<std::mutex> lock(model_.batch_mutex);
+      model_.batch_workspaces.push_back(std::move(workspace_));
+    }
+
+    /**
+     * @brief Load a copy of the generated models per chunk, and return the workspace
+     */
+    BatchWorkspace& reserve(const std::size_t nslots) {
+      if (workspace_->calcFuns.size() < nslots) {
+        std::lock_guard<std::mutex> lock(model_.batch_mutex);
+        while (workspace_->calcFuns.size() < nslots) {
+          workspace_->calcFuns.push_back(model_.dynamicLib_ptr->model(model_.function_name_calc.c_str()));
+          workspace_->calcDiffFuns.push_back(model_.dynamicLib_ptr->model(model_.function_name_calcDiff.c_str()));
+        }
+      }
+      return *workspace_;
+    }
+
+    /**
+     * @brief Return the default scheduler of the workspace with a given number of threads
+     */
+    const boost::shared_ptr<SchedulerAbstract>& getScheduler(const std::size_t nthreads) {
+      if (nthreads == 0) {
+        throw_pretty("Invalid argument: "
+                     << "nthreads should be positive");
+      }
+      if (!workspace_->scheduler) {
+        workspace_->scheduler = createDefaultScheduler();
+      }
+      if (workspace_->scheduler->get_nthreads() != nthreads) {
+        workspace_->scheduler->set_nthreads(nthreads);
+      }
+      return workspace_->scheduler;
+    }
+
+   private:
+    BatchLease(const BatchLease&);
+    BatchLease& operator=(const BatchLease&);
+
+    ActionModelCodeGenTpl& model_;               //!< Model that owns the workspace
+    std::unique_ptr<BatchWorkspace> workspace_;  //!< Workspace taken by the call
+  };
+
+  /**
+   * @brief Check the dimensions of a batch
+   */
+  void checkBatch(const Eigen::Ref<const MatrixXs>& xus, const Eigen::Ref<const MatrixXs>& out,
+                  const Eigen::DenseIndex nY) const {
+    if (xus.rows() != ad_X.size()) {
+      throw_pretty("Invalid argument: "
+                   << "xus has wrong dimension (it should have " + std::to_string(ad_X.size()) + " rows)");
+    }
+    if (out.rows() != nY || out.cols() != xus.cols()) {
+      throw_pretty("Invalid argument: "
+                   << "the batch output has wrong dimension (it should be " + std::to_string(nY) + "x" +
+                          std::to_string(xus.cols()) + ")");
+    }
+  }
+
+  /**
+   * @brief Return the number of chunks of a batch, i.e. one per thread of the scheduler
+   */
+  static std::size_t getBatchSlots(const std::size_t K, const boost::shared_ptr<SchedulerAbstract>& scheduler) {
+    if (!scheduler) {
+      throw_pretty("Invalid argument: "
+                   << "the scheduler is null");
+    }
+    return std::max<std::size_t>(1, std::min(scheduler->get_nthreads(), K));
+  }
+
+  /**
+   * @brief Evaluate the generated calc for a batch of inputs in the chunks of a workspace
+   */
+  void evaluateCalcBatch(BatchLease& lease, const Eigen::Ref<const MatrixXs>& xus, Eigen::Ref<MatrixXs> calcout,
+                         const boost::shared_ptr<SchedulerAbstract>& scheduler) {
+    checkBatch(xus, calcout, static_cast<Eigen::DenseIndex>(ad_calcout.size()));
+    const std::size_t K = static_cast<std::size_t>(xus.cols());
+    const std::size_t nX = static_cast<std::size_t>(xus.rows());
+    const std::size_t nY = static_cast<std::size_t>(calcout.rows());
+    const std::size_t nslots = getBatchSlots(K, scheduler);
+    BatchWorkspace& workspace = lease.reserve(nslots);
+    scheduler->parallelFor(nslots, [&](const std::size_t slot) {
+      CppAD::cg::GenericModel<Scalar>& fun = *workspace.calcFuns[slot];
+      const Eigen::DenseIndex end = static_cast<Eigen::DenseIndex>((slot + 1) * K / nslots);
+      for (Eigen::DenseIndex k = static_cast<Eigen::DenseIndex>(slot * K / nslots); k < end; ++k) {
+        fun.ForwardZero(CppAD::cg::ArrayView<const Scalar>(xus.data() + k * xus.outerStride(), nX),
+                        CppAD::cg::ArrayView<Scalar>(calcout.data() + k * calcout.outerStride(), nY));
+      }
+    });
+  }
+
+  /**
+   * @brief Evaluate the generated calcDiff for a batch of inputs in the chunks of a workspace
+   */
+  void evaluateCalcDiffBatch(BatchLease& lease, const Eigen::Ref<const MatrixXs>& xus,
+                             Eigen::Ref<MatrixXs> calcDiffout, const boost::shared_ptr<SchedulerAbstract>& scheduler) {
+    checkBatch(xus, calcDiffout, calcDiff_constants.size());
+    const std::size_t K = static_cast<std::size_t>(xus.cols());
+    const std::size_t nX = static_cast<std::size_t>(xus.rows());
+    const std::size_t nO = calcDiff_outputs.size();
+    const std::size_t nY = static_cast<std::size_t>(calcDiffout.rows());
+    const std::size_t nslots = getBatchSlots(K, scheduler);
+    BatchWorkspace& workspace = lease.reserve(nslots);
+    scheduler->parallelFor(nslots, [&](const std::size_t slot) {
+      CppAD::cg::GenericModel<Scalar>& fun = *workspace.calcDiffFuns[slot];
+      const Eigen::DenseIndex end = static_cast<Eigen::DenseIndex>((slot + 1) * K / nslots);
+      for (Eigen::DenseIndex k = static_cast<Eigen::DenseIndex>(slot * K / nslots); k < end; ++k) {
+        Scalar* Y = calcDiffout.data() + k * calcDiffout.outerStride();
+        fun.ForwardZero(CppAD::cg::ArrayView<const Scalar>(xus.data() + k * xus.outerStride(), nX),
+                        CppAD::cg::ArrayView<Scalar>(Y, nO));
+        // the output positions are increasing and calcDiff_outputs[j] >= j, so the expansion runs backwards
+        std::size_t j = nO;
+        for (std::size_t i = nY; i-- > 0;) {
+          if (j > 0 && calcDiff_outputs[j - 1] == i) {
+            --j;
+            Y[i] = Y[j];
+          } else {
+            Y[i] = calcDiff_constants[i];
+          }
+        }
+      }
+    });
+  }
+
   using Base::has_control_limits_;  //!< Indicates whether any of the control limits
   using Base::nr_;                  //!< Dimension of the cost residual
   using Base::nu_;                  //!< Control dimension
@@ -239,6 +647,9 @@ class ActionModelCodeGenTpl : public ActionModelAbstractTpl<_Scalar> {
   /// \brief Name of the library
   const std::string library_name;
 
+  /// \brief Key of the library content (hash of the tapes and compile options)
+  std::string library_key;
+
   /// \brief Size of the environment variables
   const std::size_t n_env;
 
@@ -248,6 +659,9 @@ class ActionModelCodeGenTpl : public ActionModelAbstractTpl<_Scalar> {
   /// \brief Options to generate or not the source code for the evaluation function
   bool build_forward;
 
+  /// \brief Options of the generation and compilation of the library
+  const CodeGenOptions options;
+
   ADVectorXs ad_X, ad_X2;
 
   ADVectorXs ad_calcout;
@@ -255,12 +669,24 @@ class ActionModelCodeGenTpl : public ActionModelAbstractTpl<_Scalar> {
 
   ADFun ad_calc, ad_calcDiff;
 
+  /// \brief Positions of the entries computed by the generated calcDiff (i.e. its sparsity pattern)
+  std::vector<std::size_t> calcDiff_outputs;
+
+  /// \brief Values of the derivatives that do not depend on the inputs
+  VectorXs calcDiff_constants;
+
   std::unique_ptr<CppAD::cg::ModelCSourceGen<Scalar> > calcgen_ptr, calcDiffgen_ptr;
   std::unique_ptr<CppAD::cg::ModelLibraryCSourceGen<Scalar> > libcgen_ptr;
   std::unique_ptr<CppAD::cg::DynamicModelLibraryProcessor<Scalar> > dynamicLibManager_ptr;
   std::unique_ptr<CppAD::cg::DynamicLib<Scalar> > dynamicLib_ptr;
   std::unique_ptr<CppAD::cg::GenericModel<Scalar> > calcFun_ptr, calcDiffFun_ptr;
 
+  /// \brief Idle workspaces of the batched evaluations
+  std::vector<std::unique_ptr<BatchWorkspace> > batch_workspaces;
+
+  /// \brief Lock of the idle workspaces
+  std::mutex batch_mutex;
+
 };  // struct CodeGenBase
 
 template <typename _Scalar>
@@ -286,7 +712,10 @@ struct ActionDataCodeGenTpl : public ActionDataAbstractTpl<_Scalar> {
 
   VectorXs xu, calcout;
 
-  VectorXs calcDiffout;
+  VectorXs calcDiffout;  //!< Outputs of the generated calcDiff, i.e. the non-constant derivatives
+
+  std::vector<std::size_t> calcDiffout_indices;  //!< Indices (in increasing order and in the layout of
+                                                //!< `get_derivative_entries()`) written by each output of calcDiff
 
   void distribute_calcout() {
     cost = calcout[0];
@@ -294,24 +723,36 @@ struct ActionDataCodeGenTpl : public ActionDataAbstractTpl<_Scalar> {
   }
 
   void distribute_calcDiffout() {
-    VectorXs& Y = calcDiffout;
-    const std::size_t ndx = Fx.rows();
-    const std::size_t nu = Fu.cols();
+    // the entries are found from their indices, instead of stored pointers, so a copy of this data writes into its own
+    // derivatives
+    Scalar* const blocks[] = {Fx.data(), Fu.data(), Lx.data(), Lu.data(), Lxx.data(), Lxu.data(), Luu.data()};
+    const Eigen::DenseIndex sizes[] = {Fx.size(), Fu.size(), Lx.size(), Lu.size(), Lxx.size(), Lxu.size(), Luu.size()};
+    const std::size_t nY = calcDiffout_indices.size();
+    std::size_t b = 0;
+    std::size_t offset = 0;
+    for (std::size_t k = 0; k < nY; ++k) {
+      const std::size_t i = calcDiffout_indices[k];
+      while (i >= offset + static_cast<std::size_t>(sizes[b])) {
+        offset += static_cast<std::size_t>(sizes[b]);
+        ++b;
+      }
+      blocks[b][i - offset] = calcDiffout[k];
+    }
+  }
 
-    Eigen::DenseIndex it_Y = 0;
-    Fx = Eigen::Map<MatrixXs>(Y.data() + it_Y, ndx, ndx);
-    it_Y += ndx * ndx;
-    Fu = Eigen::Map<MatrixXs>(Y.data() + it_Y, ndx, nu);
-    it_Y += ndx * nu;
-    Lx = Eigen::Map<VectorXs>(Y.data() + it_Y, ndx);
-    it_Y += ndx;
-    Lu = Eigen::Map<VectorXs>(Y.data() + it_Y, nu);
-    it_Y += nu;
-    Lxx = Eigen::Map<MatrixXs>(Y.data() + it_Y, ndx, ndx);
-    it_Y += ndx * ndx;
-    Lxu = Eigen::Map<MatrixXs>(Y.data() + it_Y, ndx, nu);
-    it_Y += ndx * nu;
-    Luu = Eigen::Map<MatrixXs>(Y.data() + it_Y, nu, nu);
+  /**
+   * @brief Return the entries of the derivatives in the layout of `collect_calcDiffout()`
+   */
+  std::vector<Scalar*> get_derivative_entries() {
+    std::vector<Scalar*> entries;
+    Scalar* const blocks[] = {Fx.data(), Fu.data(), Lx.data(), Lu.data(), Lxx.data(), Lxu.data(), Luu.data()};
+    const Eigen::DenseIndex sizes[] = {Fx.size(), Fu.size(), Lx.size(), Lu.size(), Lxx.size(), Lxu.size(), Luu.size()};
+    for (std::size_t b = 0; b < 7; ++b) {
+      for (Eigen::DenseIndex i = 0; i < sizes[b]; ++i) {
+        entries.push_back(blocks[b] + i);
+      }
+    }
+    return entries;
   }
 
   template <template <typename Scalar> class Model>
@@ -320,10 +761,16 @@ struct ActionDataCodeGenTpl : public ActionDataAbstractTpl<_Scalar> {
     xu.resize(m->getInputDimension());
     xu.setZero();
     calcout.setZero();
-    const std::size_t ndx = model->get_state()->get_ndx();
-    const std::size_t nu = model->get_nu();
-    calcDiffout.resize(2 * ndx * ndx + 2 * ndx * nu + nu * nu + ndx + nu);
-    calcDiffout.setZero();
+
+    // the constant derivatives are written once, and the generated calcDiff only writes the other entries
+    const std::vector<std::size_t>& outputs = m->get_calcDiff_outputs();
+    const VectorXs& constants = m->get_calcDiff_constants();
+    const std::vector<Scalar*> entries = get_derivative_entries();
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      *entries[i] = constants[i];
+    }
+    calcDiffout = VectorXs::Zero(outputs.size());
+    calcDiffout_indices = outputs;
   }
 };
 
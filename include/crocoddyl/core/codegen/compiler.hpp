@@ -0,0 +1,227 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CROCODDYL_CORE_CODEGEN_COMPILER_HPP_
+#define CROCODDYL_CORE_CODEGEN_COMPILER_HPP_
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "pinocchio/codegen/cppadcg.hpp"
+
+#include "crocoddyl/core/utils/exception.hpp"
+
+namespace crocoddyl {
+
+/**
+ * @brief Return the 64-bit FNV-1a hash of a string as 16 hexadecimal digits
+ */
+inline std::string codegenHash(const std::string& content) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (std::size_t i = 0; i < content.size(); ++i) {
+    hash ^= static_cast<unsigned char>(content[i]);
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream key;
+  key << std::hex << std::setfill('0') << std::setw(16) << hash;
+  return key.str();
+}
+
+/**
+ * @brief Options of the generation and compilation of the code-generated libraries
+ */
+struct CodeGenOptions {
+  CodeGenOptions() : njobs(0), max_assignments(5000), object_cache(""), sparsity(true) {}
+
+  std::size_t njobs;            //!< Number of parallel compile jobs (0 for the number of hardware threads)
+  std::size_t max_assignments;  //!< Maximum number of assignments per generated function (0 for no limit)
+  std::string object_cache;     //!< Folder of the object files shared among libraries (empty to disable it)
+  bool sparsity;                //!< Generate only the non-constant derivatives (false to generate all of them)
+};
+
+/**
+ * @brief Compiler that builds the generated sources in parallel
+ *
+ * It behaves as the GCC compiler of CppADCodeGen, but it compiles each source file (i.e., each split generated
+ * function) in a separate job, and it runs several jobs in parallel before linking the library once. When an object
+ * cache is defined, each object file is named after the hash of its source and compile flags. Then, a new library
+ * only compiles the functions whose code changed since a previous build, and it links the other ones from the cache.
+ * The objects are published with an atomic rename, so concurrent processes can share the cache.
+ */
+template <typename Scalar>
+class CodeGenCompilerTpl : public CppAD::cg::GccCompiler<Scalar> {
+ public:
+  typedef CppAD::cg::GccCompiler<Scalar> Base;
+
+  /**
+   * @brief Initialize the compiler
+   *
+   * @param[in] njobs         Number of parallel compile jobs (0 for the number of hardware threads)
+   * @param[in] object_cache  Folder of the object files shared among libraries (empty to disable it)
+   */
+  explicit CodeGenCompilerTpl(const std::size_t njobs = 0, const std::string& object_cache = "")
+      : Base(), njobs_(njobs), object_cache_(object_cache), ncompiled_(0), nreused_(0) {
+    if (njobs_ == 0) {
+      njobs_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+  }
+
+  using Base::compileSources;
+
+  virtual void compileSources(const std::map<std::string, std::string>& sources, bool posIndepCode,
+                              CppAD::cg::JobTimer* timer = nullptr) override {
+    (void)timer;
+    const std::string tmp_folder = this->getTemporaryFolder();
+    const std::string object_folder = object_cache_.empty() ? tmp_folder : object_cache_;
+    createFolder(tmp_folder);
+    createFolder(object_folder);
+
+    // Collect the objects to compile, the cached ones are directly linked
+    std::string flags;
+    const std::vector<std::string> compile_flags = this->getCompileFlags();
+    for (std::size_t i = 0; i < compile_flags.size(); ++i) {
+      flags += " " + compile_flags[i];
+    }
+    if (posIndepCode) {
+      flags += " -fPIC";
+    }
+    std::vector<std::string> names, objects;
+    for (std::map<std::string, std::string>::const_iterator it = sources.begin(); it != sources.end(); ++it) {
+      std::string object = object_folder + "/" + it->first;
+      if (!object_cache_.empty()) {
+        object += "_" + codegenHash(this->getCompilerPath() + flags + "\n" + it->second);
+      }
+      object += ".o";
+      if (!object_cache_.empty() && std::ifstream(object.c_str()).good()) {
+        cached_objects_.insert(object);
+        ++nreused_;
+      } else {
+        names.push_back(it->first);
+        objects.push_back(object);
+      }
+      this->_ofiles.insert(object);
+    }
+
+    // Compile the sources in parallel
+    std::atomic<std::size_t> next(0);
+    std::vector<std::exception_ptr> errors(names.size());
+    const std::size_t nthreads = std::min(njobs_, names.size());
+    std::vector<std::thread> threads;
+    for (std::size_t n = 0; n < nthreads; ++n) {
+      threads.push_back(std::thread([&]() {
+        for (std::size_t i = next++; i < names.size(); i = next++) {
+          try {
+            compileObject(sources.find(names[i])->second, tmp_folder + "/" + names[i], objects[i], flags);
+          } catch (...) {
+            errors[i] = std::current_exception();
+          }
+        }
+      }));
+    }
+    for (std::size_t n = 0; n < nthreads; ++n) {
+      threads[n].join();
+    }
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+      if (errors[i]) {
+        std::rethrow_exception(errors[i]);
+      }
+    }
+    ncompiled_ += names.size();
+    if (!object_cache_.empty()) {
+      cached_objects_.insert(objects.begin(), objects.end());
+    }
+  }
+
+  virtual void cleanup() override {
+    // The cached objects are kept for the next libraries
+    for (std::set<std::string>::const_iterator it = cached_objects_.begin(); it != cached_objects_.end(); ++it) {
+      this->_ofiles.erase(*it);
+    }
+    cached_objects_.clear();
+    Base::cleanup();
+  }
+
+  /**
+   * @brief Return the number of parallel compile jobs
+   */
+  std::size_t get_njobs() const { return njobs_; }
+
+  /**
+   * @brief Return the number of compiled objects
+   */
+  std::size_t get_ncompiled() const { return ncompiled_; }
+
+  /**
+   * @brief Return the number of objects reused from the cache
+   */
+  std::size_t get_nreused() const { return nreused_; }
+
+ private:
+  static void createFolder(const std::string& folder) {
+    if (::mkdir(folder.c_str(), 0777) != 0 && errno != EEXIST) {
+      throw_pretty("Invalid argument: "
+                   << "cannot create the folder " + folder);
+    }
+  }
+
+  /**
+   * @brief Compile a source into an object file
+   *
+   * The source is written to a file, so each job runs the compiler without sharing any pipe with the other ones.
+   * The object is compiled under a temporary name and then renamed, so it never appears partially written.
+   */
+  void compileObject(const std::string& source, const std::string& source_file, const std::string& object,
+                     const std::string& flags) const {
+    {
+      std::ofstream file(source_file.c_str());
+      file << source;
+      if (!file.good()) {
+        throw_pretty("Invalid argument: "
+                     << "cannot write the source " + source_file);
+      }
+    }
+    const std::string tmp_object = object + ".tmp" + std::to_string(::getpid());
+    const std::string command =
+        "'" + this->getCompilerPath() + "'" + flags + " -c '" + source_file + "' -o '" + tmp_object + "'";
+    const int status = std::system(command.c_str());
+    std::remove(source_file.c_str());
+    if (status != 0) {
+      std::remove(tmp_object.c_str());
+      throw_pretty("Invalid argument: "
+                   << "failed to compile " + source_file + " (" + command + ")");
+    }
+    if (std::rename(tmp_object.c_str(), object.c_str()) != 0) {
+      std::remove(tmp_object.c_str());
+      throw_pretty("Invalid argument: "
+                   << "cannot move the object file to " + object);
+    }
+  }
+
+  std::size_t njobs_;                     //!< Number of parallel compile jobs
+  std::string object_cache_;              //!< Folder of the object files shared among libraries
+  std::size_t ncompiled_;                 //!< Number of compiled objects
+  std::size_t nreused_;                   //!< Number of objects reused from the cache
+  std::set<std::string> cached_objects_;  //!< Objects of the cache linked in the current library
+};
+
+}  // namespace crocoddyl
+
+#endif  // CROCODDYL_CORE_CODEGEN_COMPILER_HPP_
@@ -0,0 +1,781 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CROCODDYL_CORE_CODEGEN_PROBLEM_HPP_
+#define CROCODDYL_CORE_CODEGEN_PROBLEM_HPP_
+
+#include <sstream>
+#include <vector>
+#include "pinocchio/codegen/cppadcg.hpp"
+
+#include "crocoddyl/core/codegen/action-base.hpp"
+#include "crocoddyl/core/optctrl/shooting.hpp"
+#include "crocoddyl/core/utils/exception.hpp"
+
+namespace crocoddyl {
+
+/**
+ * @brief Code-generated evaluation of a fixed-structure shooting problem
+ *
+ * It records the `calc()` and `calcDiff()` of all the nodes of a shooting problem in a single tape, and it generates
+ * one fused function that evaluates the costs, next states, residuals and derivatives of the whole horizon into a
+ * contiguous buffer. Therefore a single call replaces the loop over the nodes, without any virtual call,
+ * shared-pointer dereference or `Eigen::Ref` check in between. As `ActionModelCodeGenTpl`, the entries that do not
+ * depend on the inputs are not computed by the generated function, and the library is cached under a key of its
+ * tape.
+ *
+ * The layout of the buffer is, for each running node, \f$[\ell, \mathbf{x}_{next}, \mathbf{r}, \mathbf{F_x},
+ * \mathbf{F_u}, \mathbf{\ell_x}, \mathbf{\ell_u}, \mathbf{\ell_{xx}}, \mathbf{\ell_{xu}}, \mathbf{\ell_{uu}}]\f$
+ * (column-major matrices), followed by \f$[\ell, \mathbf{r}, \mathbf{\ell_x}, \mathbf{\ell_{xx}}]\f$ of the terminal
+ * node.
+ *
+ * This class is a shooting problem itself: `calcDiff()` and `calcAndDiff()` run the fused function and copy its
+ * results into the datas, so the solvers use it without any change. Instead, `calc()` still runs the nodes (e.g.
+ * the rollouts of the line search), as the fused function always computes the derivatives. Optionally, the Riccati
+ * recursion of the backward pass is generated as well, which is run by `SolverCodeGen` (see `calcRiccati()`).
+ *
+ * The structure of the problem (number of nodes and their dimensions) is fixed when the function is generated, and
+ * the AD models must be equivalent to the models of the problem. The problem can still be shifted with
+ * `circularAppend()`, e.g. in a receding-horizon controller with a single running model. When a node does not hold
+ * its recorded model anymore, the problem falls back to the evaluation of the nodes.
+ */
+template <typename _Scalar>
+class ShootingProblemCodeGenTpl : public ShootingProblemTpl<_Scalar> {
+ public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  typedef _Scalar Scalar;
+  typedef MathBaseTpl<Scalar> MathBase;
+  typedef ShootingProblemTpl<Scalar> Base;
+  typedef ActionModelCodeGenTpl<Scalar> ActionModelCodeGen;
+  typedef ActionModelAbstractTpl<Scalar> ActionModelAbstract;
+  typedef ActionDataAbstractTpl<Scalar> ActionDataAbstract;
+  typedef typename MathBase::VectorXs VectorXs;
+  typedef typename MathBase::MatrixXs MatrixXs;
+
+  typedef CppAD::cg::CG<Scalar> CGScalar;
+  typedef CppAD::AD<CGScalar> ADScalar;
+  typedef ActionModelAbstractTpl<ADScalar> ADActionModelAbstract;
+  typedef ActionDataAbstractTpl<ADScalar> ADActionDataAbstract;
+  typedef typename MathBaseTpl<ADScalar>::VectorXs ADVectorXs;
+  typedef typename MathBaseTpl<ADScalar>::MatrixXs ADMatrixXs;
+  typedef CppAD::ADFun<CGScalar> ADFun;
+
+  static const int cache_version = 2;  //!< Version of the generated functions, which is part of the library key
+
+  /**
+   * @brief Initialize the shooting problem, and generate, compile (if needed) and load its fused function
+   *
+   * @param[in] x0                 Initial state
+   * @param[in] running_models     Running action models (size \f$T\f$)
+   * @param[in] terminal_model     Terminal action model
+   * @param[in] ad_running_models  Running action models with automatic-differentiation scalar (size \f$T\f$)
+   * @param[in] ad_terminal_model  Terminal action model with automatic-differentiation scalar
+   * @param[in] library_name       Name of the library
+   * @param[in] function_name      Name of the fused function
+   * @param[in] options            Options of the generation and compilation of the library
+   * @param[in] riccati            True for generating the Riccati recursion as well (default false)
+   */
+  ShootingProblemCodeGenTpl(const VectorXs& x0,
+                            const std::vector<boost::shared_ptr<ActionModelAbstract> >& running_models,
+                            boost::shared_ptr<ActionModelAbstract> terminal_model,
+                            const std::vector<boost::shared_ptr<ADActionModelAbstract> >& ad_running_models,
+                            boost::shared_ptr<ADActionModelAbstract> ad_terminal_model,
+                            const std::string& library_name,
+                            const std::string& function_name = "problemCalcAndDiff",
+                            const CodeGenOptions& options = CodeGenOptions(), const bool riccati = false)
+      : Base(x0, running_models, terminal_model),
+        recorded_running_models_(running_models),
+        recorded_terminal_model_(terminal_model),
+        ad_running_models_(ad_running_models),
+        ad_terminal_model_(ad_terminal_model),
+        library_name_(library_name),
+        function_name_(function_name),
+        options_(options),
+        riccati_(riccati) {
+    const std::size_t T = this->T_;
+    if (ad_running_models_.size() != T) {
+      throw_pretty("Invalid argument: "
+                   << "the number of AD running models is not equal to the number of nodes (it should be " +
+                          std::to_string(T) + ")");
+    }
+    nus_.resize(T);
+    nrs_.resize(T + 1);
+    for (std::size_t t = 0; t < T; ++t) {
+      const boost::shared_ptr<ADActionModelAbstract>& model = ad_running_models_[t];
+      if (model->get_state()->get_nx() != this->nx_ || model->get_state()->get_ndx() != this->ndx_ ||
+          model->get_nu() != running_models[t]->get_nu() || model->get_nr() != running_models[t]->get_nr()) {
+        throw_pretty("Invalid argument: "
+                     << "the dimensions of the AD running model " + std::to_string(t) +
+                            " are not consistent with the problem");
+      }
+      nus_[t] = model->get_nu();
+      nrs_[t] = model->get_nr();
+    }
+    if (ad_terminal_model_->get_state()->get_nx() != this->nx_ ||
+        ad_terminal_model_->get_state()->get_ndx() != this->ndx_ ||
+        ad_terminal_model_->get_nr() != terminal_model->get_nr()) {
+      throw_pretty("Invalid argument: "
+                   << "the dimensions of the AD terminal model are not consistent with the problem");
+    }
+    nrs_[T] = ad_terminal_model_->get_nr();
+    initLib();
+    loadLib();
+  }
+  virtual ~ShootingProblemCodeGenTpl() {}
+
+  /**
+   * @brief Compute the derivatives of the cost and dynamics with the fused function
+   *
+   * The fused function computes the costs and next states as well, which are the same as the ones of the last
+   * `calc()` at these trajectories. The incremental evaluation of the derivatives is not used by the fused function.
+   *
+   * @param[in] xs  State trajectory \f$\mathbf{x}_{s}\f$ (dimension \f$T+1\f$)
+   * @param[in] us  Control sequence \f$\mathbf{u}_{s}\f$ (dimension \f$T\f$)
+   * @return the total cost
+   */
+  virtual Scalar calcDiff(const std::vector<VectorXs>& xs, const std::vector<VectorXs>& us) {
+    if (!is_recorded()) {
+      return Base::calcDiff(xs, us);
+    }
+    evaluate(xs, us);
+    distribute();
+    return this->cost_;
+  }
+
+  /**
+   * @brief Compute the costs, next states, residuals and derivatives of all the nodes with the fused function
+   *
+   * It evaluates the fused function into the buffer, and then it copies the results into the running and terminal
+   * datas of the problem.
+   *
+   * @param[in] xs  State trajectory \f$\mathbf{x}_{s}\f$ (dimension \f$T+1\f$)
+   * @param[in] us  Control sequence \f$\mathbf{u}_{s}\f$ (dimension \f$T\f$)
+   * @return the total cost
+   */
+  virtual Scalar calcAndDiff(const std::vector<VectorXs>& xs, const std::vector<VectorXs>& us) {
+    if (!is_recorded()) {
+      return Base::calcAndDiff(xs, us);
+    }
+    evaluate(xs, us);
+    distribute();
+    return this->cost_;
+  }
+
+  /**
+   * @brief Evaluate the fused function into the buffer
+   *
+   * @param[in] xs  State trajectory \f$\mathbf{x}_{s}\f$ (dimension \f$T+1\f$)
+   * @param[in] us  Control sequence \f$\mathbf{u}_{s}\f$ (dimension \f$T\f$)
+   * @return the total cost
+   */
+  Scalar evaluate(const std::vector<VectorXs>& xs, const std::vector<VectorXs>& us) {
+    const std::size_t T = this->T_;
+    const std::size_t nx = this->nx_;
+    if (xs.size() != T + 1) {
+      throw_pretty("Invalid argument: "
+                   << "xs has wrong dimension (it should be " + std::to_string(T + 1) + ")");
+    }
+    if (us.size() != T) {
+      throw_pretty("Invalid argument: "
+                   << "us has wrong dimension (it should be " + std::to_string(T) + ")");
+    }
+    Eigen::DenseIndex it = 0;
+    for (std::size_t t = 0; t < T; ++t) {
+      X_.segment(it, nx) = xs[t];
+      it += nx;
+      X_.segment(it, nus_[t]) = us[t].head(nus_[t]);
+      it += nus_[t];
+    }
+    X_.segment(it, nx) = xs.back();
+
+    fun_ptr_->ForwardZero(X_, Y_);
+    const std::size_t nY = outputs_.size();
+    for (std::size_t k = 0; k < nY; ++k) {
+      buffer_[outputs_[k]] = Y_[k];
+    }
+
+    this->cost_ = Scalar(0.);
+    for (std::size_t t = 0; t <= T; ++t) {
+      this->cost_ += buffer_[offsets_[t]];
+    }
+    return this->cost_;
+  }
+
+  /**
+   * @brief Copy the buffer into the running and terminal datas of the problem
+   *
+   * The datas are written behind the nodes, so it also invalidates the incremental derivative cache.
+   */
+  void distribute() {
+    const std::size_t ndx = this->ndx_;
+    for (std::size_t t = 0; t < this->T_; ++t) {
+      ActionDataAbstract* d = this->running_datas_[t].get();
+      const std::size_t nu = nus_[t];
+      const Scalar* Y = buffer_.data() + offsets_[t];
+      d->cost = *Y;
+      Y += 1;
+      d->xnext = Eigen::Map<const VectorXs>(Y, this->nx_);
+      Y += this->nx_;
+      d->r = Eigen::Map<const VectorXs>(Y, nrs_[t]);
+      Y += nrs_[t];
+      unpackDerivatives(Y, nu, d);
+    }
+    ActionDataAbstract* d = this->terminal_data_.get();
+    const Scalar* Y = buffer_.data() + offsets_[this->T_];
+    d->cost = *Y;
+    d->r = Eigen::Map<const VectorXs>(Y + 1, nrs_[this->T_]);
+    Y += 1 + nrs_[this->T_];
+    d->Lx = Eigen::Map<const VectorXs>(Y, ndx);
+    d->Lxx = Eigen::Map<const MatrixXs>(Y + ndx, ndx, ndx);
+    this->invalidateDerivatives();
+  }
+
+  /**
+   * @brief Run the generated Riccati recursion on the derivatives of the datas
+   *
+   * It computes the terms of the backward pass of `SolverDDP` into the Riccati buffer, i.e., for each running node
+   * \f$[\mathbf{Q_{xx}}, \mathbf{Q_{xu}}, \mathbf{Q_{uu}}, \mathbf{Q_x}, \mathbf{Q_u}, \mathbf{K}, \mathbf{k},
+   * \mathbf{Q_{uu}k}, \mathbf{V_{xx}}, \mathbf{V_x}]\f$ (the feedback gain is row-major), followed by
+   * \f$[\mathbf{V_{xx}}, \mathbf{V_x}]\f$ of the terminal node. The generated code factorizes
+   * \f$\mathbf{Q_{uu}}\f$ without pivoting, so the buffer contains non-finite values if it is not positive definite.
+   * It requires the recorded models in the nodes (see `is_recorded()`).
+   *
+   * @param[in] xreg      State regularization
+   * @param[in] ureg      Control regularization
+   * @param[in] fs        Gaps between the nodes (size \f$T+1\f$)
+   * @param[in] feasible  True if the gaps are closed, in which case they are ignored
+   */
+  template <typename VectorList>
+  void calcRiccati(const Scalar xreg, const Scalar ureg, const VectorList& fs, const bool feasible) {
+    if (!riccati_) {
+      throw_pretty("Invalid argument: "
+                   << "the Riccati recursion was not generated");
+    }
+    const std::size_t T = this->T_;
+    const std::size_t ndx = this->ndx_;
+    for (std::size_t t = 0; t < T; ++t) {
+      packDerivatives(this->running_datas_[t].get(), nus_[t], D_.data() + derivative_offsets_[t]);
+    }
+    const ActionDataAbstract* d = this->terminal_data_.get();
+    Scalar* D = D_.data() + derivative_offsets_[T];
+    Eigen::Map<VectorXs>(D, ndx) = d->Lx;
+    Eigen::Map<MatrixXs>(D + ndx, ndx, ndx) = d->Lxx;
+
+    R_in_[0] = xreg;
+    R_in_[1] = ureg;
+    Eigen::DenseIndex it = 2;
+    const std::size_t nI = riccati_inputs_.size();
+    for (std::size_t k = 0; k < nI; ++k) {
+      R_in_[it++] = D_[riccati_inputs_[k]];
+    }
+    for (std::size_t t = 0; t <= T; ++t) {
+      if (feasible) {
+        R_in_.segment(it, ndx).setZero();
+      } else {
+        R_in_.segment(it, ndx) = fs[t];
+      }
+      it += ndx;
+    }
+    riccati_fun_ptr_->ForwardZero(R_in_, riccati_buffer_);
+  }
+
+  /**
+   * @brief Compute the terms of a node of the Riccati recursion
+   *
+   * It follows the backward pass of `SolverDDP`, but without any branch on the values, so it can be recorded. The
+   * terms are written as in the Riccati buffer (see `calcRiccati()`).
+   *
+   * @param[in]  ndx    State rate dimension
+   * @param[in]  nu     Control dimension
+   * @param[in]  D      Derivatives of the node \f$[\mathbf{F_x}, \mathbf{F_u}, \mathbf{\ell_x}, \mathbf{\ell_u},
+   * \mathbf{\ell_{xx}}, \mathbf{\ell_{xu}}, \mathbf{\ell_{uu}}]\f$
+   * @param[in]  Vxx_p  Hessian of the Value function of the next node
+   * @param[in]  Vx_p   Gradient of the Value function of the next node
+   * @param[in]  f      Gap of the node
+   * @param[in]  xreg   State regularization
+   * @param[in]  ureg   Control regularization
+   * @param[out] R      Terms of the node
+   */
+  template <typename S>
+  static void riccatiNode(const std::size_t ndx, const std::size_t nu, const S* D, const S* Vxx_p, const S* Vx_p,
+                          const S* f, const S& xreg, const S& ureg, S* R) {
+    typedef Eigen::Matrix<S, Eigen::Dynamic, Eigen::Dynamic> MatrixS;
+    typedef Eigen::Matrix<S, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> MatrixRowMajorS;
+    typedef Eigen::Matrix<S, Eigen::Dynamic, 1> VectorS;
+    const Eigen::Map<const MatrixS> Fx(D, ndx, ndx);
+    const Eigen::Map<const MatrixS> Fu(D + ndx * ndx, ndx, nu);
+    D += ndx * ndx + ndx * nu;
+    const Eigen::Map<const VectorS> Lx(D, ndx);
+    const Eigen::Map<const VectorS> Lu(D + ndx, nu);
+    D += ndx + nu;
+    const Eigen::Map<const MatrixS> Lxx(D, ndx, ndx);
+    const Eigen::Map<const MatrixS> Lxu(D + ndx * ndx, ndx, nu);
+    const Eigen::Map<const MatrixS> Luu(D + ndx * ndx + ndx * nu, nu, nu);
+    const Eigen::Map<const MatrixS> Vxx_next(Vxx_p, ndx, ndx);
+    const Eigen::Map<const VectorS> Vx_next(Vx_p, ndx);
+    const Eigen::Map<const VectorS> fs(f, ndx);
+
+    Eigen::Map<MatrixS> Qxx(R, ndx, ndx);
+    R += ndx * ndx;
+    Eigen::Map<MatrixS> Qxu(R, ndx, nu);
+    R += ndx * nu;
+    Eigen::Map<MatrixS> Quu(R, nu, nu);
+    R += nu * nu;
+    Eigen::Map<VectorS> Qx(R, ndx);
+    R += ndx;
+    Eigen::Map<VectorS> Qu(R, nu);
+    R += nu;
+    Eigen::Map<MatrixRowMajorS> K(R, nu, ndx);
+    R += nu * ndx;
+    Eigen::Map<VectorS> k(R, nu);
+    R += nu;
+    Eigen::Map<VectorS> Quuk(R, nu);
+    R += nu;
+    Eigen::Map<MatrixS> Vxx(R, ndx, ndx);
+    R += ndx * ndx;
+    Eigen::Map<VectorS> Vx(R, ndx);
+
+    const MatrixS FxTVxx_p = Fx.transpose() * Vxx_next;
+    const MatrixS FuTVxx_p = Fu.transpose() * Vxx_next;
+    Qxx = Lxx + FxTVxx_p * Fx;
+    Qxu = Lxu + FxTVxx_p * Fu;
+    Quu = Luu + FuTVxx_p * Fu;
+    Quu.diagonal().array() += ureg;
+    Qx = Lx + Fx.transpose() * Vx_next;
+    Qu = Lu + Fu.transpose() * Vx_next;
+
+    // Cholesky factorization of Quu, and solve of the gains with it
+    using std::sqrt;
+    MatrixS L = MatrixS::Zero(nu, nu);
+    for (std::size_t j = 0; j < nu; ++j) {
+      S Ljj = Quu(j, j);
+      for (std::size_t i = 0; i < j; ++i) {
+        Ljj -= L(j, i) * L(j, i);
+      }
+      L(j, j) = sqrt(Ljj);
+      for (std::size_t i = j + 1; i < nu; ++i) {
+        S Lij = Quu(i, j);
+        for (std::size_t l = 0; l < j; ++l) {
+          Lij -= L(i, l) * L(j, l);
+        }
+        L(i, j) = Lij / L(j, j);
+      }
+    }
+    K = Qxu.transpose();
+    k = Qu;
+    choleskySolveInPlace(L, K);
+    choleskySolveInPlace(L, k);
+
+    Quuk = Quu * k;
+    Vx = Qx + K.transpose() * Quuk - S(2.) * (K.transpose() * Qu);
+    Vxx = Qxx - Qxu * K;
+    const MatrixS Vxx_sym = S(0.5) * (Vxx + Vxx.transpose());
+    Vxx = Vxx_sym;
+    Vxx.diagonal().array() += xreg;
+    Vx += Vxx * fs;
+  }
+
+  /**
+   * @brief Return true if the nodes hold the recorded models
+   *
+   * Otherwise, the problem evaluates the nodes instead of the generated functions.
+   */
+  bool is_recorded() const {
+    for (std::size_t t = 0; t < this->T_; ++t) {
+      if (this->running_models_[t] != recorded_running_models_[t]) {
+        return false;
+      }
+    }
+    return this->terminal_model_ == recorded_terminal_model_;
+  }
+
+  /**
+   * @brief Return true if the Riccati recursion was generated
+   */
+  bool has_riccati() const { return riccati_; }
+
+  /**
+   * @brief Return the buffer with the results of all the nodes
+   */
+  const VectorXs& get_buffer() const { return buffer_; }
+
+  /**
+   * @brief Return the position of the results of each node in the buffer (the terminal node is the last one)
+   */
+  const std::vector<std::size_t>& get_offsets() const { return offsets_; }
+
+  /**
+   * @brief Return the positions of the entries computed by the generated function in the buffer
+   */
+  const std::vector<std::size_t>& get_outputs() const { return outputs_; }
+
+  /**
+   * @brief Return the buffer with the terms of the Riccati recursion
+   */
+  const VectorXs& get_riccati_buffer() const { return riccati_buffer_; }
+
+  /**
+   * @brief Return the position of the terms of each node in the Riccati buffer (the terminal node is the last one)
+   */
+  const std::vector<std::size_t>& get_riccati_offsets() const { return riccati_offsets_; }
+
+  /**
+   * @brief Return the key of the generated library, which is appended to its name
+   */
+  const std::string& get_library_key() const { return library_key_; }
+
+ protected:
+  /**
+   * @brief Solve \f$\mathbf{L}\mathbf{L}^T\mathbf{X}=\mathbf{B}\f$ in place, with the lower-triangular factor
+   * \f$\mathbf{L}\f$
+   */
+  template <typename MatrixType, typename Derived>
+  static void choleskySolveInPlace(const MatrixType& L, const Eigen::MatrixBase<Derived>& B_) {
+    Eigen::MatrixBase<Derived>& B = const_cast<Eigen::MatrixBase<Derived>&>(B_);
+    const Eigen::DenseIndex n = L.rows();
+    for (Eigen::DenseIndex i = 0; i < n; ++i) {
+      for (Eigen::DenseIndex j = 0; j < i; ++j) {
+        B.row(i) -= L(i, j) * B.row(j);
+      }
+      B.row(i) /= L(i, i);
+    }
+    for (Eigen::DenseIndex i = n - 1; i >= 0; --i) {
+      for (Eigen::DenseIndex j = i + 1; j < n; ++j) {
+        B.row(i) -= L(j, i) * B.row(j);
+      }
+      B.row(i) /= L(i, i);
+    }
+  }
+
+  /**
+   * @brief Return the position of the Value function in the terms of a running node of the Riccati recursion
+   */
+  static std::size_t riccatiValuePosition(const std::size_t ndx, const std::size_t nu) {
+    return ndx * ndx + 2 * ndx * nu + nu * nu + ndx + 3 * nu;
+  }
+
+  /**
+   * @brief Copy the derivatives of a running node from its layout in the buffer into its data
+   */
+  void unpackDerivatives(const Scalar* Y, const std::size_t nu, ActionDataAbstract* d) const {
+    const std::size_t ndx = this->ndx_;
+    d->Fx = Eigen::Map<const MatrixXs>(Y, ndx, ndx);
+    Y += ndx * ndx;
+    d->Fu = Eigen::Map<const MatrixXs>(Y, ndx, nu);
+    Y += ndx * nu;
+    d->Lx = Eigen::Map<const VectorXs>(Y, ndx);
+    Y += ndx;
+    d->Lu = Eigen::Map<const VectorXs>(Y, nu);
+    Y += nu;
+    d->Lxx = Eigen::Map<const MatrixXs>(Y, ndx, ndx);
+    Y += ndx * ndx;
+    d->Lxu = Eigen::Map<const MatrixXs>(Y, ndx, nu);
+    Y += ndx * nu;
+    d->Luu = Eigen::Map<const MatrixXs>(Y, nu, nu);
+  }
+
+  /**
+   * @brief Copy the derivatives of a running node from its data into their layout in the buffer
+   */
+  void packDerivatives(const ActionDataAbstract* d, const std::size_t nu, Scalar* Y) const {
+    const std::size_t ndx = this->ndx_;
+    Eigen::Map<MatrixXs>(Y, ndx, ndx) = d->Fx;
+    Y += ndx * ndx;
+    Eigen::Map<MatrixXs>(Y, ndx, nu) = d->Fu;
+    Y += ndx * nu;
+    Eigen::Map<VectorXs>(Y, ndx) = d->Lx;
+    Y += ndx;
+    Eigen::Map<VectorXs>(Y, nu) = d->Lu;
+    Y += nu;
+    Eigen::Map<MatrixXs>(Y, ndx, ndx) = d->Lxx;
+    Y += ndx * ndx;
+    Eigen::Map<MatrixXs>(Y, ndx, nu) = d->Lxu;
+    Y += ndx * nu;
+    Eigen::Map<MatrixXs>(Y, nu, nu) = d->Luu;
+  }
+
+  /**
+   * @brief Record the calc and calcDiff of all the nodes in a single tape
+   */
+  void record() {
+    const std::size_t T = this->T_;
+    const std::size_t nx = this->nx_;
+    const std::size_t ndx = this->ndx_;
+    std::size_t nX = nx;
+    std::size_t nY = 0;
+    std::size_t nD = 0;
+    offsets_.resize(T + 1);
+    derivative_offsets_.resize(T + 1);
+    for (std::size_t t = 0; t < T; ++t) {
+      const std::size_t nu = nus_[t];
+      const std::size_t nd = 2 * ndx * ndx + 2 * ndx * nu + nu * nu + ndx + nu;
+      nX += nx + nu;
+      offsets_[t] = nY;
+      derivative_offsets_[t] = nD;
+      nY += 1 + nx + nrs_[t] + nd;
+      nD += nd;
+    }
+    offsets_[T] = nY;
+    derivative_offsets_[T] = nD;
+    nY += 1 + nrs_[T] + ndx + ndx * ndx;
+    nD += ndx + ndx * ndx;
+
+    ADVectorXs ad_X = ADVectorXs::Zero(nX);
+    ADVectorXs ad_Y(nY);
+    CppAD::Independent(ad_X);
+    Eigen::DenseIndex it_X = 0, it_Y = 0;
+    for (std::size_t t = 0; t < T; ++t) {
+      const boost::shared_ptr<ADActionModelAbstract>& model = ad_running_models_[t];
+      const boost::shared_ptr<ADActionDataAbstract> data = model->createData();
+      const std::size_t nu = nus_[t];
+      const ADVectorXs x = ad_X.segment(it_X, nx);
+      const ADVectorXs u = ad_X.segment(it_X + nx, nu);
+      it_X += nx + nu;
+      model->calc(data, x, u);
+      model->calcDiff(data, x, u);
+      ad_Y[it_Y] = data->cost;
+      it_Y += 1;
+      ad_Y.segment(it_Y, nx) = data->xnext;
+      it_Y += nx;
+      ad_Y.segment(it_Y, nrs_[t]) = data->r;
+      it_Y += nrs_[t];
+      Eigen::Map<ADMatrixXs>(ad_Y.data() + it_Y, ndx, ndx) = data->Fx;
+      it_Y += ndx * ndx;
+      Eigen::Map<ADMatrixXs>(ad_Y.data() + it_Y, ndx, nu) = data->Fu;
+      it_Y += ndx * nu;
+      ad_Y.segment(it_Y, ndx) = data->Lx;
+      it_Y += ndx;
+      ad_Y.segment(it_Y, nu) = data->Lu;
+      it_Y += nu;
+      Eigen::Map<ADMatrixXs>(ad_Y.data() + it_Y, ndx, ndx) = data->Lxx;
+      it_Y += ndx * ndx;
+      Eigen::Map<ADMatrixXs>(ad_Y.data() + it_Y, ndx, nu) = data->Lxu;
+      it_Y += ndx * nu;
+      Eigen::Map<ADMatrixXs>(ad_Y.data() + it_Y, nu, nu) = data->Luu;
+      it_Y += nu * nu;
+    }
+    const boost::shared_ptr<ADActionDataAbstract> data = ad_terminal_model_->createData();
+    const ADVectorXs x = ad_X.segment(it_X, nx);
+    ad_terminal_model_->calc(data, x);
+    ad_terminal_model_->calcDiff(data, x);
+    ad_Y[it_Y] = data->cost;
+    it_Y += 1;
+    ad_Y.segment(it_Y, nrs_[T]) = data->r;
+    it_Y += nrs_[T];
+    ad_Y.segment(it_Y, ndx) = data->Lx;
+    it_Y += ndx;
+    Eigen::Map<ADMatrixXs>(ad_Y.data() + it_Y, ndx, ndx) = data->Lxx;
+
+    // the constant entries are written once in the buffer, and the generated function only computes the other ones
+    outputs_.clear();
+    buffer_ = VectorXs::Zero(nY);
+    std::vector<bool> variable(nY, false);
+    for (std::size_t i = 0; i < nY; ++i) {
+      const ADScalar& y = ad_Y[i];
+      if (!options_.sparsity || CppAD::Variable(y) || !CppAD::Value(y).isValueDefined()) {
+        outputs_.push_back(i);
+        variable[i] = true;
+      } else {
+        buffer_[i] = CppAD::Value(y).getValue();
+      }
+    }
+    ADVectorXs ad_outputs(outputs_.size());
+    for (std::size_t k = 0; k < outputs_.size(); ++k) {
+      ad_outputs[k] = ad_Y[outputs_[k]];
+    }
+    ad_fun_.Dependent(ad_X, ad_outputs);
+    ad_fun_.optimize("no_compare_op");
+
+    X_ = VectorXs::Zero(nX);
+    Y_ = VectorXs::Zero(outputs_.size());
+    D_ = VectorXs::Zero(nD);
+    if (riccati_) {
+      recordRiccati(variable);
+    }
+  }
+
+  /**
+   * @brief Record the Riccati recursion in a tape
+   *
+   * Its inputs are the regularizations, the derivatives that are computed by the fused function and the gaps. The
+   * constant derivatives are parameters of the tape instead, so the generated code skips their structural zeros.
+   *
+   * @param[in] variable  Entries of the buffer computed by the fused function
+   */
+  void recordRiccati(const std::vector<bool>& variable) {
+    const std::size_t T = this->T_;
+    const std::size_t ndx = this->ndx_;
+    riccati_inputs_.clear();
+    std::vector<std::size_t> positions;  // positions of the derivatives in the buffer
+    for (std::size_t t = 0; t <= T; ++t) {
+      const std::size_t begin = offsets_[t] + 1 + (t < T ? this->nx_ : 0) + nrs_[t];
+      const std::size_t nd = (t < T ? derivative_offsets_[t + 1] : D_.size()) - derivative_offsets_[t];
+      for (std::size_t i = 0; i < nd; ++i) {
+        positions.push_back(begin + i);
+        if (variable[begin + i]) {
+          riccati_inputs_.push_back(derivative_offsets_[t] + i);
+        }
+      }
+    }
+    const std::size_t nI = riccati_inputs_.size();
+    const std::size_t nR_in = 2 + nI + (T + 1) * ndx;
+    std::size_t nR = 0;
+    riccati_offsets_.resize(T + 1);
+    for (std::size_t t = 0; t < T; ++t) {
+      riccati_offsets_[t] = nR;
+      nR += riccatiValuePosition(ndx, nus_[t]) + ndx * ndx + ndx;
+    }
+    riccati_offsets_[T] = nR;
+    nR += ndx * ndx + ndx;
+
+    ADVectorXs ad_R_in = ADVectorXs::Zero(nR_in);
+    ADVectorXs ad_R(nR);
+    CppAD::Independent(ad_R_in);
+    ADVectorXs ad_D(positions.size());
+    for (std::size_t i = 0, k = 0; i < positions.size(); ++i) {
+      if (k < nI && riccati_inputs_[k] == i) {
+        ad_D[i] = ad_R_in[2 + k];
+        ++k;
+      } else {
+        ad_D[i] = ADScalar(buffer_[positions[i]]);
+      }
+    }
+    const ADScalar& xreg = ad_R_in[0];
+    const ADScalar& ureg = ad_R_in[1];
+    const ADScalar* fs = ad_R_in.data() + 2 + nI;
+    ADScalar* R_T = ad_R.data() + riccati_offsets_[T];
+    const ADScalar* D_T = ad_D.data() + derivative_offsets_[T];
+    Eigen::Map<ADMatrixXs> Vxx_T(R_T, ndx, ndx);
+    Eigen::Map<ADVectorXs> Vx_T(R_T + ndx * ndx, ndx);
+    Vxx_T = Eigen::Map<const ADMatrixXs>(D_T + ndx, ndx, ndx);
+    Vxx_T.diagonal().array() += xreg;
+    Vx_T = Eigen::Map<const ADVectorXs>(D_T, ndx) + Vxx_T * Eigen::Map<const ADVectorXs>(fs + T * ndx, ndx);
+    for (int t = static_cast<int>(T) - 1; t >= 0; --t) {
+      // the terminal node only contains the Value function
+      std::size_t Vxx_p = riccati_offsets_[t + 1];
+      if (t + 1 < static_cast<int>(T)) {
+        Vxx_p += riccatiValuePosition(ndx, nus_[t + 1]);
+      }
+      riccatiNode<ADScalar>(ndx, nus_[t], ad_D.data() + derivative_offsets_[t], ad_R.data() + Vxx_p,
+                            ad_R.data() + Vxx_p + ndx * ndx, fs + t * ndx, xreg, ureg,
+                            ad_R.data() + riccati_offsets_[t]);
+    }
+    riccati_fun_.Dependent(ad_R_in, ad_R);
+    riccati_fun_.optimize("no_compare_op");
+
+    R_in_ = VectorXs::Zero(nR_in);
+    riccati_buffer_ = VectorXs::Zero(nR);
+  }
+
+  void initLib() {
+    record();
+
+    // generates source code
+    gen_ptr_ = std::unique_ptr<CppAD::cg::ModelCSourceGen<Scalar> >(
+        new CppAD::cg::ModelCSourceGen<Scalar>(ad_fun_, function_name_));
+    gen_ptr_->setCreateForwardZero(true);
+    gen_ptr_->setCreateJacobian(false);
+    if (options_.max_assignments != 0) {
+      gen_ptr_->setMaxAssignmentsPerFunc(options_.max_assignments);
+    }
+    libcgen_ptr_ = std::unique_ptr<CppAD::cg::ModelLibraryCSourceGen<Scalar> >(
+        new CppAD::cg::ModelLibraryCSourceGen<Scalar>(*gen_ptr_));
+    if (riccati_) {
+      riccati_gen_ptr_ = std::unique_ptr<CppAD::cg::ModelCSourceGen<Scalar> >(
+          new CppAD::cg::ModelCSourceGen<Scalar>(riccati_fun_, function_name_ + "Riccati"));
+      riccati_gen_ptr_->setCreateForwardZero(true);
+      riccati_gen_ptr_->setCreateJacobian(false);
+      if (options_.max_assignments != 0) {
+        riccati_gen_ptr_->setMaxAssignmentsPerFunc(options_.max_assignments);
+      }
+      libcgen_ptr_->addModel(*riccati_gen_ptr_);
+    }
+
+    library_key_ = computeLibraryKey();
+    dynamicLibManager_ptr_ = std::unique_ptr<CppAD::cg::DynamicModelLibraryProcessor<Scalar> >(
+        new CppAD::cg::DynamicModelLibraryProcessor<Scalar>(*libcgen_ptr_, library_name_ + "_" + library_key_));
+  }
+
+  void loadLib() {
+    const std::string name = dynamicLibManager_ptr_->getLibraryName();
+    if (!ActionModelCodeGen::existLibrary(name)) {
+      ActionModelCodeGen::compileLibrary(*dynamicLibManager_ptr_, options_);
+    }
+    dynamicLib_ptr_.reset(
+        new CppAD::cg::LinuxDynamicLib<Scalar>(name + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION));
+    fun_ptr_ = dynamicLib_ptr_->model(function_name_.c_str());
+    if (riccati_) {
+      riccati_fun_ptr_ = dynamicLib_ptr_->model((function_name_ + "Riccati").c_str());
+    }
+  }
+
+  /**
+   * @brief Compute the key of the generated library
+   *
+   * \sa `ActionModelCodeGenTpl::computeLibraryKey()`
+   */
+  std::string computeLibraryKey() {
+    CppAD::cg::GccCompiler<Scalar> compiler;
+    std::ostringstream content;
+    content << "problem " << cache_version << " " << ActionModelCodeGen::cache_version << " " << function_name_
+            << " " << compiler.getCompilerPath();
+    const std::vector<std::string> compile_options = ActionModelCodeGen::getCompileFlags(compiler);
+    for (std::size_t i = 0; i < compile_options.size(); ++i) {
+      content << " " << compile_options[i];
+    }
+    ActionModelCodeGen::fingerprintTape(ad_fun_, content);
+    for (std::size_t k = 0; k < outputs_.size(); ++k) {
+      content << " " << outputs_[k];
+    }
+    if (riccati_) {
+      content << " riccati";
+      ActionModelCodeGen::fingerprintTape(riccati_fun_, content);
+    }
+    return codegenHash(content.str());
+  }
+
+  std::vector<boost::shared_ptr<ActionModelAbstract> > recorded_running_models_;  //!< Recorded running models
+  boost::shared_ptr<ActionModelAbstract> recorded_terminal_model_;                //!< Recorded terminal model
+  std::vector<boost::shared_ptr<ADActionModelAbstract> > ad_running_models_;      //!< AD running models
+  boost::shared_ptr<ADActionModelAbstract> ad_terminal_model_;                    //!< AD terminal model
+
+  const std::string library_name_;   //!< Name of the library
+  const std::string function_name_;  //!< Name of the fused function
+  std::string library_key_;          //!< Key of the library content
+  const CodeGenOptions options_;     //!< Options of the generation and compilation
+  const bool riccati_;               //!< True if the Riccati recursion is generated
+  std::vector<std::size_t> nus_;     //!< Control dimension of each running node
+  std::vector<std::size_t> nrs_;     //!< Residual dimension of each node
+
+  ADFun ad_fun_;                                //!< Tape of the fused function
+  std::vector<std::size_t> offsets_;            //!< Position of the results of each node in the buffer
+  std::vector<std::size_t> outputs_;            //!< Positions of the entries computed by the generated function
+  VectorXs X_;                                  //!< Inputs of the generated function
+  VectorXs Y_;                                  //!< Outputs of the generated function
+  VectorXs buffer_;                             //!< Results of all the nodes
+  ADFun riccati_fun_;                           //!< Tape of the Riccati recursion
+  std::vector<std::size_t> derivative_offsets_;  //!< Position of the derivatives of each node in D_
+  std::vector<std::size_t> riccati_inputs_;     //!< Positions in D_ of the inputs of the Riccati recursion
+  std::vector<std::size_t> riccati_offsets_;    //!< Position of the terms of each node in the Riccati buffer
+  VectorXs D_;                                  //!< Derivatives of all the nodes
+  VectorXs R_in_;                               //!< Inputs of the Riccati recursion
+  VectorXs riccati_buffer_;                     //!< Terms of the Riccati recursion
+
+  std::unique_ptr<CppAD::cg::ModelCSourceGen<Scalar> > gen_ptr_;
+  std::unique_ptr<CppAD::cg::ModelCSourceGen<Scalar> > riccati_gen_ptr_;
+  std::unique_ptr<CppAD::cg::ModelLibraryCSourceGen<Scalar> > libcgen_ptr_;
+  std::unique_ptr<CppAD::cg::DynamicModelLibraryProcessor<Scalar> > dynamicLibManager_ptr_;
+  std::unique_ptr<CppAD::cg::DynamicLib<Scalar> > dynamicLib_ptr_;
+  std::unique_ptr<CppAD::cg::GenericModel<Scalar> > fun_ptr_;
+  std::unique_ptr<CppAD::cg::GenericModel<Scalar> > riccati_fun_ptr_;
+};
+
+}  // namespace crocoddyl
+
+#endif  // CROCODDYL_CORE_CODEGEN_PROBLEM_HPP_
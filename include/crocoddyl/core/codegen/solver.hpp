@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CROCODDYL_CORE_CODEGEN_SOLVER_HPP_
+#define CROCODDYL_CORE_CODEGEN_SOLVER_HPP_
+
+#include <cmath>
+
+#include "crocoddyl/core/codegen/problem.hpp"
+#include "crocoddyl/core/solvers/ddp.hpp"
+#include "crocoddyl/core/solvers/fddp.hpp"
+#include "crocoddyl/core/utils/exception.hpp"
+#include "crocoddyl/core/utils/stop-watch.hpp"
+
+namespace crocoddyl {
+
+/**
+ * @brief Solver that runs the generated Riccati recursion of a code-generated shooting problem
+ *
+ * The derivatives of the problem are already computed by its fused function, as the solvers call its `calcDiff()`
+ * and `calcAndDiff()`. Furthermore, this solver replaces the backward pass of `Solver` by the Riccati recursion
+ * generated by the problem (see `ShootingProblemCodeGenTpl::calcRiccati()`), and it copies the resulting terms into
+ * its workspace. The rest of the solver (forward pass, line search, regularization and stopping criteria) is the one
+ * of `Solver`. It falls back to the backward pass of `Solver` when the problem did not generate the recursion, when
+ * its nodes do not hold the recorded models, or when the regularization is disabled.
+ *
+ * `Solver` has to be `SolverDDP` or `SolverFDDP`, as the box solvers run a different backward pass.
+ */
+template <class Solver>
+class SolverCodeGen : public Solver {
+ public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  typedef ShootingProblemCodeGenTpl<double> ShootingProblemCodeGen;
+  typedef typename Solver::MatrixXdRowMajor MatrixXdRowMajor;
+
+  /**
+   * @brief Initialize the solver
+   *
+   * @param[in] problem  Code-generated shooting problem
+   */
+  explicit SolverCodeGen(boost::shared_ptr<ShootingProblemCodeGen> problem) : Solver(problem), problem_cg_(problem) {}
+  virtual ~SolverCodeGen() {}
+
+  virtual void backwardPass() {
+    if (!problem_cg_->has_riccati() || !problem_cg_->is_recorded() || std::isnan(this->xreg_) ||
+        std::isnan(this->ureg_)) {
+      Solver::backwardPass();
+      return;
+    }
+    START_PROFILER("SolverCodeGen::backwardPass");
+    problem_cg_->calcRiccati(this->xreg_, this->ureg_, this->fs_, this->is_feasible_);
+    const Eigen::VectorXd& R = problem_cg_->get_riccati_buffer();
+    // a non-positive definite Quu leads to non-finite terms, as the generated factorization does not check it
+    if (!R.allFinite()) {
+      throw_pretty("backward_error");
+    }
+
+    const std::size_t T = problem_cg_->get_T();
+    const std::size_t ndx = problem_cg_->get_ndx();
+    const std::vector<std::size_t>& offsets = problem_cg_->get_riccati_offsets();
+    for (std::size_t t = 0; t < T; ++t) {
+      const std::size_t nu = problem_cg_->get_runningModels()[t]->get_nu();
+      const double* r = R.data() + offsets[t];
+      this->Qxx_[t] = Eigen::Map<const Eigen::MatrixXd>(r, ndx, ndx);
+      r += ndx * ndx;
+      this->Qxu_[t].leftCols(nu) = Eigen::Map<const Eigen::MatrixXd>(r, ndx, nu);
+      r += ndx * nu;
+      this->Quu_[t].topLeftCorner(nu, nu) = Eigen::Map<const Eigen::MatrixXd>(r, nu, nu);
+      r += nu * nu;
+      this->Qx_[t] = Eigen::Map<const Eigen::VectorXd>(r, ndx);
+      r += ndx;
+      this->Qu_[t].head(nu) = Eigen::Map<const Eigen::VectorXd>(r, nu);
+      r += nu;
+      this->K_[t].topRows(nu) = Eigen::Map<const MatrixXdRowMajor>(r, nu, ndx);
+      r += nu * ndx;
+      this->k_[t].head(nu) = Eigen::Map<const Eigen::VectorXd>(r, nu);
+      r += nu;
+      this->Quuk_[t].head(nu) = Eigen::Map<const Eigen::VectorXd>(r, nu);
+      r += nu;
+      this->Vxx_[t] = Eigen::Map<const Eigen::MatrixXd>(r, ndx, ndx);
+      r += ndx * ndx;
+      this->Vx_[t] = Eigen::Map<const Eigen::VectorXd>(r, ndx);
+    }
+    const double* r = R.data() + offsets[T];
+    this->Vxx_.back() = Eigen::Map<const Eigen::MatrixXd>(r, ndx, ndx);
+    this->Vx_.back() = Eigen::Map<const Eigen::VectorXd>(r + ndx * ndx, ndx);
+    STOP_PROFILER("SolverCodeGen::backwardPass");
+  }
+
+  /**
+   * @brief Return the code-generated shooting problem
+   */
+  const boost::shared_ptr<ShootingProblemCodeGen>& get_problem_codegen() const { return problem_cg_; }
+
+ protected:
+  boost::shared_ptr<ShootingProblemCodeGen> problem_cg_;  //!< Code-generated shooting problem
+};
+
+typedef SolverCodeGen<SolverDDP> SolverDDPCodeGen;
+typedef SolverCodeGen<SolverFDDP> SolverFDDPCodeGen;
+
+}  // namespace crocoddyl
+
+#endif  // CROCODDYL_CORE_CODEGEN_SOLVER_HPP_
@@ -97,6 +97,19 @@ class DifferentialActionModelAbstractTpl {
   virtual void calcDiff(const boost::shared_ptr<DifferentialActionDataAbstract>& data,
                         const Eigen::Ref<const VectorXs>& x, const Eigen::Ref<const VectorXs>& u) = 0;
 
+  /**
+   * @brief Compute the system acceleration, cost value and their derivatives
+   *
+   * It is equivalent to run `calc()` and then `calcDiff()`, which is the default behaviour. Models override it to
+   * share the computations of both functions, e.g. the rigid-body dynamics that are also obtained by its derivatives.
+   *
+   * @param[in] data  Differential action data
+   * @param[in] x     State point
+   * @param[in] u     Control input
+   */
+  virtual void calcAndDiff(const boost::shared_ptr<DifferentialActionDataAbstract>& data,
+                           const Eigen::Ref<const VectorXs>& x, const Eigen::Ref<const VectorXs>& u);
+
   /**
    * @brief Create the differential action data
    *
@@ -125,6 +138,14 @@ class DifferentialActionModelAbstractTpl {
    */
   void calcDiff(const boost::shared_ptr<DifferentialActionDataAbstract>& data, const Eigen::Ref<const VectorXs>& x);
 
+  /**
+   * @copybrief calcAndDiff()
+   *
+   * @param[in] data  Differential action data
+   * @param[in] x     State point
+   */
+  void calcAndDiff(const boost::shared_ptr<DifferentialActionDataAbstract>& data, const Eigen::Ref<const VectorXs>& x);
+
   /**
    * @brief Computes the quasic static commands
    *
@@ -82,6 +82,20 @@ void DifferentialActionModelAbstractTpl<Scalar>::calcDiff(
   calcDiff(data, x, unone_);
 }
 
+template <typename Scalar>
+void DifferentialActionModelAbstractTpl<Scalar>::calcAndDiff(
+    const boost::shared_ptr<DifferentialActionDataAbstract>& data, const Eigen::Ref<const VectorXs>& x,
+    const Eigen::Ref<const VectorXs>& u) {
+  calc(data, x, u);
+  calcDiff(data, x, u);
+}
+
+template <typename Scalar>
+void DifferentialActionModelAbstractTpl<Scalar>::calcAndDiff(
+    const boost::shared_ptr<DifferentialActionDataAbstract>& data, const Eigen::Ref<const VectorXs>& x) {
+  calcAndDiff(data, x, unone_);
+}
+
 template <typename Scalar>
 boost::shared_ptr<DifferentialActionDataAbstractTpl<Scalar> >
 DifferentialActionModelAbstractTpl<Scalar>::createData() {
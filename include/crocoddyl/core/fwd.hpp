@@ -180,6 +180,9 @@ class ActionModelCodeGenTpl;
 template <typename Scalar>
 struct ActionDataCodeGenTpl;
 
+template <typename Scalar>
+class ShootingProblemCodeGenTpl;
+
 /********************Template Instantiation*************/
 typedef ActionModelAbstractTpl<double> ActionModelAbstract;
 typedef ActionDataAbstractTpl<double> ActionDataAbstract;
@@ -254,6 +257,7 @@ typedef ActuationDataNumDiffTpl<double> ActuationDataNumDiff;
 
 typedef ActionModelCodeGenTpl<double> ActionModelCodeGen;
 typedef ActionDataCodeGenTpl<double> ActionDataCodeGen;
+typedef ShootingProblemCodeGenTpl<double> ShootingProblemCodeGen;
 
 }  // namespace crocoddyl
 
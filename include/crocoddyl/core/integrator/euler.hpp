@@ -37,6 +37,8 @@ class IntegratedActionModelEulerTpl : public ActionModelAbstractTpl<_Scalar> {
                     const Eigen::Ref<const VectorXs>& u);
   virtual void calcDiff(const boost::shared_ptr<ActionDataAbstract>& data, const Eigen::Ref<const VectorXs>& x,
                         const Eigen::Ref<const VectorXs>& u);
+  virtual void calcAndDiff(const boost::shared_ptr<ActionDataAbstract>& data, const Eigen::Ref<const VectorXs>& x,
+                           const Eigen::Ref<const VectorXs>& u);
   virtual boost::shared_ptr<ActionDataAbstract> createData();
   virtual bool checkData(const boost::shared_ptr<ActionDataAbstract>& data);
 
@@ -66,6 +68,16 @@ class IntegratedActionModelEulerTpl : public ActionModelAbstractTpl<_Scalar> {
   using Base::unone_;               //!< Neutral state
 
  private:
+  /**
+   * @brief Integrate the state and cost of the differential model, whose `calc()` has been run
+   */
+  void integrateDynamics(const boost::shared_ptr<Data>& d, const Eigen::Ref<const VectorXs>& x);
+
+  /**
+   * @brief Integrate the derivatives of the differential model, whose `calcDiff()` has been run
+   */
+  void integrateDerivatives(const boost::shared_ptr<Data>& d, const Eigen::Ref<const VectorXs>& x);
+
   boost::shared_ptr<DifferentialActionModelAbstract> differential_;
   Scalar time_step_;
   Scalar time_step2_;
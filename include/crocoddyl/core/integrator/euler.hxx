@@ -52,33 +52,12 @@ void IntegratedActionModelEulerTpl<Scalar>::calc(const boost::shared_ptr<ActionD
                  << "u has wrong dimension (it should be " + std::to_string(nu_) + ")");
   }
 
-  const std::size_t nv = differential_->get_state()->get_nv();
-
   // Static casting the data
   boost::shared_ptr<Data> d = boost::static_pointer_cast<Data>(data);
 
   // Computing the acceleration and cost
   differential_->calc(d->differential, x, u);
-
-  // Computing the next state (discrete time)
-  const Eigen::VectorBlock<const Eigen::Ref<const VectorXs>, Eigen::Dynamic> v =
-      x.tail(differential_->get_state()->get_nv());
-  const VectorXs& a = d->differential->xout;
-  if (enable_integration_) {
-    d->dx.head(nv).noalias() = v * time_step_ + a * time_step2_;
-    d->dx.tail(nv).noalias() = a * time_step_;
-    differential_->get_state()->integrate(x, d->dx, d->xnext);
-    d->cost = time_step_ * d->differential->cost;
-  } else {
-    d->dx.setZero();
-    d->xnext = x;
-    d->cost = d->differential->cost;
-  }
-
-  // Updating the cost value
-  if (with_cost_residual_) {
-    d->r = d->differential->r;
-  }
+  integrateDynamics(d, x);
 }
 
 template <typename Scalar>
@@ -94,42 +73,34 @@ void IntegratedActionModelEulerTpl<Scalar>::calcDiff(const boost::shared_ptr<Act
                  << "u has wrong dimension (it should be " + std::to_string(nu_) + ")");
   }
 
-  const std::size_t nv = differential_->get_state()->get_nv();
-
   // Static casting the data
   boost::shared_ptr<Data> d = boost::static_pointer_cast<Data>(data);
 
   // Computing the derivatives for the time-continuous model (i.e. differential model)
   differential_->calcDiff(d->differential, x, u);
+  integrateDerivatives(d, x);
+}
 
-  if (enable_integration_) {
-    const MatrixXs& da_dx = d->differential->Fx;
-    const MatrixXs& da_du = d->differential->Fu;
-    d->Fx.topRows(nv).noalias() = da_dx * time_step2_;
-    d->Fx.bottomRows(nv).noalias() = da_dx * time_step_;
-    d->Fx.topRightCorner(nv, nv).diagonal().array() += Scalar(time_step_);
-
-    d->Fu.topRows(nv).noalias() = da_du * time_step2_;
-    d->Fu.bottomRows(nv).noalias() = da_du * time_step_;
+template <typename Scalar>
+void IntegratedActionModelEulerTpl<Scalar>::calcAndDiff(const boost::shared_ptr<ActionDataAbstract>& data,
+                                                        const Eigen::Ref<const VectorXs>& x,
+                                                        const Eigen::Ref<const VectorXs>& u) {
+  if (static_cast<std::size_t>(x.size()) != state_->get_nx()) {
+    throw_pretty("Invalid argument: "
+                 << "x has wrong dimension (it should be " + std::to_string(state_->get_nx()) + ")");
+  }
+  if (static_cast<std::size_t>(u.size()) != nu_) {
+    throw_pretty("Invalid argument: "
+                 << "u has wrong dimension (it should be " + std::to_string(nu_) + ")");
+  }
 
-    differential_->get_state()->JintegrateTransport(x, d->dx, d->Fx, second);
-    differential_->get_state()->Jintegrate(x, d->dx, d->Fx, d->Fx, first, addto);
-    differential_->get_state()->JintegrateTransport(x, d->dx, d->Fu, second);
+  // Static casting the data
+  boost::shared_ptr<Data> d = boost::static_pointer_cast<Data>(data);
 
-    d->Lx.noalias() = time_step_ * d->differential->Lx;
-    d->Lu.noalias() = time_step_ * d->differential->Lu;
-    d->Lxx.noalias() = time_step_ * d->differential->Lxx;
-    d->Lxu.noalias() = time_step_ * d->differential->Lxu;
-    d->Luu.noalias() = time_step_ * d->differential->Luu;
-  } else {
-    differential_->get_state()->Jintegrate(x, d->dx, d->Fx, d->Fx);
-    d->Fu.setZero();
-    d->Lx = d->differential->Lx;
-    d->Lu = d->differential->Lu;
-    d->Lxx = d->differential->Lxx;
-    d->Lxu = d->differential->Lxu;
-    d->Luu = d->differential->Luu;
-  }
+  // Computing the acceleration, cost and their derivatives at once
+  differential_->calcAndDiff(d->differential, x, u);
+  integrateDynamics(d, x);
+  integrateDerivatives(d, x);
 }
 
 template <typename Scalar>
@@ -202,6 +173,73 @@ void IntegratedActionModelEulerTpl<Scalar>::quasiStatic(const boost::shared_ptr<
   differential_->quasiStatic(d->differential, u, x, maxiter, tol);
 }
 
+template <typename Scalar>
+void IntegratedActionModelEulerTpl<Scalar>::integrateDynamics(const boost::shared_ptr<Data>& d,
+                                                              const Eigen::Ref<const VectorXs>& x) {
+  const std::size_t nv = differential_->get_state()->get_nv();
+
+  // Computing the next state (discrete time)
+  const Eigen::VectorBlock<const Eigen::Ref<const VectorXs>, Eigen::Dynamic> v = x.tail(nv);
+  const VectorXs& a = d->differential->xout;
+  if (enable_integration_) {
+    d->dx.head(nv).noalias() = v * time_step_ + a * time_step2_;
+    d->dx.tail(nv).noalias() = a * time_step_;
+    differential_->get_state()->integrate(x, d->dx, d->xnext);
+    d->cost = time_step_ * d->differential->cost;
+  } else {
+    d->dx.setZero();
+    d->xnext = x;
+    d->cost = d->differential->cost;
+  }
+
+  // Updating the cost value
+  if (with_cost_residual_) {
+    d->r = d->differential->r;
+  }
+}
+
+template <typename Scalar>
+void IntegratedActionModelEulerTpl<Scalar>::integrateDerivatives(const boost::shared_ptr<Data>& d,
+                                                                 const Eigen::Ref<const VectorXs>& x) {
+  const std::size_t nv = differential_->get_state()->get_nv();
+
+  if (enable_integration_) {
+    const MatrixXs& da_dx = d->differential->Fx;
+    const MatrixXs& da_du = d->differential->Fu;
+    d->Fx.topRows(nv).noalias() = da_dx * time_step2_;
+    d->Fx.bottomRows(nv).noalias() = da_dx * time_step_;
+    d->Fx.topRightCorner(nv, nv).diagonal().array() += Scalar(time_step_);
+
+    d->Fu.topRows(nv).noalias() = da_du * time_step2_;
+    d->Fu.bottomRows(nv).noalias() = da_du * time_step_;
+
+    differential_->get_state()->JintegrateTransport(x, d->dx, d->Fx, second);
+    differential_->get_state()->Jintegrate(x, d->dx, d->Fx, d->Fx, first, addto);
+    differential_->get_state()->JintegrateTransport(x, d->dx, d->Fu, second);
+
+    // Advertise the block structure of the Jacobians, which the solvers exploit in their backward pass
+    const std::size_t ndx_lie = differential_->get_state()->get_ndx_lie();
+    d->F_structured = 2 * nv == state_->get_ndx() && ndx_lie <= nv;
+    d->F_dt = time_step_;
+    d->F_ndense = ndx_lie;
+
+    d->Lx.noalias() = time_step_ * d->differential->Lx;
+    d->Lu.noalias() = time_step_ * d->differential->Lu;
+    d->Lxx.noalias() = time_step_ * d->differential->Lxx;
+    d->Lxu.noalias() = time_step_ * d->differential->Lxu;
+    d->Luu.noalias() = time_step_ * d->differential->Luu;
+  } else {
+    differential_->get_state()->Jintegrate(x, d->dx, d->Fx, d->Fx);
+    d->Fu.setZero();
+    d->F_structured = false;
+    d->Lx = d->differential->Lx;
+    d->Lu = d->differential->Lu;
+    d->Lxx = d->differential->Lxx;
+    d->Lxu = d->differential->Lxu;
+    d->Luu = d->differential->Luu;
+  }
+}
+
 template <typename Scalar>
 std::ostream& operator<<(std::ostream& os, const IntegratedActionModelEulerTpl<Scalar>& model) {
   os << "IntegratedActionModelEuler (dt=" << model.get_dt() << ", differential of type '"
@@ -15,9 +15,23 @@
 #include "crocoddyl/core/utils/exception.hpp"
 #include "crocoddyl/core/action-base.hpp"
 #include "crocoddyl/core/utils/to-string.hpp"
+#include "crocoddyl/core/utils/scheduler.hpp"
 
 namespace crocoddyl {
 
+/**
+ * @brief Type of load balancing used to distribute the nodes among the threads
+ *
+ *  - LoadBalancingStatic: the nodes are handed to the scheduler as they are, which splits them uniformly.
+ *  - LoadBalancingCostAware: the horizon is split into contiguous chunks, one per thread, with the same measured cost.
+ *  - LoadBalancingDynamic: the nodes are handed out one by one, the most expensive first, to the threads as they
+ *    become idle.
+ *
+ * The cost of each node is measured online as a moving average of its `calc()` and `calcDiff()` durations. The load
+ * balancing only modifies which thread evaluates each node, so the results are identical in all the cases.
+ */
+enum LoadBalancingType { LoadBalancingStatic = 0, LoadBalancingCostAware, LoadBalancingDynamic };
+
 /**
  * @brief This class encapsulates a shooting problem
  *
@@ -65,7 +79,7 @@ class ShootingProblemTpl {
    * @brief Initialize the shooting problem
    */
   ShootingProblemTpl(const ShootingProblemTpl<Scalar>& problem);
-  ~ShootingProblemTpl();
+  virtual ~ShootingProblemTpl();
 
   /**
    * @brief Compute the cost and the next states
@@ -77,7 +91,7 @@ class ShootingProblemTpl {
    * @param[in] us  time-discrete control sequence \f$\mathbf{u_{s}}\f$ (size \f$T\f$)
    * @return The total cost value \f$l_{k}\f$
    */
-  Scalar calc(const std::vector<VectorXs>& xs, const std::vector<VectorXs>& us);
+  virtual Scalar calc(const std::vector<VectorXs>& xs, const std::vector<VectorXs>& us);
 
   /**
    * @brief Compute the derivatives of the cost and dynamics
@@ -91,7 +105,20 @@ class ShootingProblemTpl {
    * @param[in] us  time-discrete control sequence \f$\mathbf{u_{s}}\f$ (size \f$T\f$)
    * @return The total cost value \f$l_{k}\f$
    */
-  Scalar calcDiff(const std::vector<VectorXs>& xs, const std::vector<VectorXs>& us);
+  virtual Scalar calcDiff(const std::vector<VectorXs>& xs, const std::vector<VectorXs>& us);
+
+  /**
+   * @brief Compute the cost, the next states and their derivatives
+   *
+   * It is equivalent to run `calc()` and then `calcDiff()`, but each node runs the fused `calcAndDiff()` of its
+   * action model, which shares the computations of both functions. In incremental mode, the nodes whose derivatives
+   * are still valid only run `calc()`.
+   *
+   * @param[in] xs  time-discrete state trajectory \f$\mathbf{x_{s}}\f$ (size \f$T+1\f$)
+   * @param[in] us  time-discrete control sequence \f$\mathbf{u_{s}}\f$ (size \f$T\f$)
+   * @return The total cost value \f$l_{k}\f$
+   */
+  virtual Scalar calcAndDiff(const std::vector<VectorXs>& xs, const std::vector<VectorXs>& us);
 
   /**
    * @brief Integrate the dynamics given a control sequence
@@ -128,7 +155,9 @@ class ShootingProblemTpl {
   /**
    * @brief Circular append of the model and data onto the end running node
    *
-   * Once we update the end running node, the first running mode is removed as in a circular buffer.
+   * Once we update the end running node, the first running mode is removed as in a circular buffer. The nodes are
+   * rotated by swapping their pointers, and the removed node is kept in a pool of datas, so that it can be recycled
+   * by a later `circularAppend(model)` of the same model.
    *
    * @param[in] model  action model
    * @param[in] data   action data
@@ -139,7 +168,9 @@ class ShootingProblemTpl {
    * @copybrief circularAppend
    *
    * Once we update the end running node, the first running mode is removed as in a circular buffer.
-   * Note that this method allocates new data for the end running node.
+   * The data of the end running node is recycled from the pool of removed nodes if it contains a data of the same
+   * model, otherwise new data is allocated. Therefore, a receding horizon that cycles through a set of models does
+   * not allocate memory once each model has been removed once from the horizon.
    *
    * @param[in] model  action model
    */
@@ -163,6 +194,19 @@ class ShootingProblemTpl {
    */
   void updateModel(const std::size_t i, boost::shared_ptr<ActionModelAbstract> model);
 
+  /**
+   * @brief Exchange the action data of all the nodes with the given ones
+   *
+   * It allows a solver to evaluate the nodes into spare data (e.g. a speculative rollout), and then to adopt them
+   * without copies. The given data have to be created by the models of the nodes, and they receive the previous data
+   * of the problem.
+   *
+   * @param[in,out] running_datas  running action data
+   * @param[in,out] terminal_data  terminal action data
+   */
+  void swapDatas(std::vector<boost::shared_ptr<ActionDataAbstract> >& running_datas,
+                 boost::shared_ptr<ActionDataAbstract>& terminal_data);
+
   /**
    * @brief Return the number of running nodes
    */
@@ -209,12 +253,20 @@ class ShootingProblemTpl {
   void set_terminalModel(boost::shared_ptr<ActionModelAbstract> model);
 
   /**
-   * @brief Modify the number of threads using with multithreading support
+   * @brief Modify the number of threads used by the scheduler
    *
-   * For values lower than 1, the number of threads is chosen by CROCODDYL_WITH_NTHREADS macro
+   * The number of threads is changed at runtime. For values lower than 1, the number of threads is chosen by
+   * CROCODDYL_WITH_NTHREADS macro (or 1 without multithreading support)
    */
   void set_nthreads(const int nthreads);
 
+  /**
+   * @brief Modify the scheduler that runs the parallel loops over the nodes
+   *
+   * The scheduler is shared with the solvers, which run their parallel sections through it.
+   */
+  void set_scheduler(boost::shared_ptr<SchedulerAbstract> scheduler);
+
   /**
    * @brief Return the dimension of the state tuple
    */
@@ -235,6 +287,76 @@ class ShootingProblemTpl {
    */
   std::size_t get_nthreads() const;
 
+  /**
+   * @brief Return the scheduler that runs the parallel loops over the nodes
+   */
+  const boost::shared_ptr<SchedulerAbstract>& get_scheduler() const;
+
+  /**
+   * @brief Return the type of load balancing
+   */
+  LoadBalancingType get_load_balancing() const;
+
+  /**
+   * @brief Modify the type of load balancing
+   *
+   * The cost-aware and dynamic load balancing measure the duration of each node, which adds a small overhead per
+   * node. They pay off when the nodes have different costs (e.g. contact, impulse and terminal nodes).
+   */
+  void set_load_balancing(const LoadBalancingType type);
+
+  /**
+   * @brief Return the measured duration of `calc()` per running node (in microseconds)
+   */
+  const std::vector<double>& get_calc_durations() const;
+
+  /**
+   * @brief Return the measured duration of `calcDiff()` per running node (in microseconds)
+   */
+  const std::vector<double>& get_calcDiff_durations() const;
+
+  /**
+   * @brief Return true if `calcDiff()` only evaluates the nodes whose state or control changed
+   */
+  bool get_incremental_calcDiff() const;
+
+  /**
+   * @brief Modify the incremental evaluation of the derivatives
+   *
+   * In incremental mode, each node keeps the state and control of its last `calcDiff()`. The next `calcDiff()` skips
+   * the nodes whose state and control did not move beyond `calcDiff_tolerance`, and whose model and data were not
+   * replaced, since their data still contains the derivatives at that point. This pays off in late iterations and
+   * receding horizons (e.g. after `circularAppend()` and a shifted warm start), where many nodes do not change.
+   *
+   * The derivatives only depend on the state and control of the node, so modifying the parameters of a model (e.g.
+   * the reference of a cost) requires to call `invalidateDerivatives()`.
+   */
+  void set_incremental_calcDiff(const bool incremental);
+
+  /**
+   * @brief Return the tolerance of the incremental evaluation of the derivatives
+   */
+  Scalar get_calcDiff_tolerance() const;
+
+  /**
+   * @brief Modify the tolerance of the incremental evaluation of the derivatives
+   *
+   * A node is evaluated again if the infinity norm of the change of its state or control (in their coordinates) is
+   * greater than this tolerance. A zero tolerance (default) evaluates the nodes that changed at all, so the
+   * derivatives are exact. Otherwise the derivatives of the skipped nodes are an approximation.
+   */
+  void set_calcDiff_tolerance(const Scalar tol);
+
+  /**
+   * @brief Return the number of nodes (including the terminal one) skipped by the last `calcDiff()`
+   */
+  std::size_t get_calcDiff_skipped() const;
+
+  /**
+   * @brief Force the next `calcDiff()` to evaluate all the nodes
+   */
+  void invalidateDerivatives();
+
   /**
    * @brief Print information on the 'ShootingProblem'
    */
@@ -252,10 +374,84 @@ class ShootingProblemTpl {
   std::size_t nx_;                                                       //!< State dimension
   std::size_t ndx_;                                                      //!< State rate dimension
   std::size_t nu_max_;                                                   //!< Maximum control dimension
-  std::size_t nthreads_;  //!< Number of threach launch by the multi-threading application
+  boost::shared_ptr<SchedulerAbstract> scheduler_;                       //!< Scheduler of the parallel loops
+  LoadBalancingType load_balancing_;                                     //!< Type of load balancing
 
  private:
   void allocateData();
+
+  /**
+   * @brief Run a node function for all the running nodes with the current load balancing
+   *
+   * @param[in]  node       Function that evaluates the i-th running node
+   * @param[out] durations  Moving average of the node durations (in microseconds)
+   */
+  void runNodes(const SchedulerAbstract::TaskFunction& node, std::vector<double>& durations);
+
+  /**
+   * @brief Shift the measured durations after a circular append, the appended node is measured from scratch
+   */
+  void shiftDurations();
+
+  /**
+   * @brief Rotate the running nodes by one position, the first node is moved to the pool of removed nodes
+   */
+  void shiftNodes();
+
+  /**
+   * @brief Take the data of a model from the pool of removed nodes
+   *
+   * @param[in] model  action model
+   * @return Recycled data, or a null pointer if the pool does not contain a data of this model
+   */
+  boost::shared_ptr<ActionDataAbstract> popPooledData(const boost::shared_ptr<ActionModelAbstract>& model);
+
+  /**
+   * @brief Remove a data from the pool of removed nodes, as it is used again by a node
+   *
+   * @param[in] data  action data
+   */
+  void discardPooledData(const boost::shared_ptr<ActionDataAbstract>& data);
+
+  /**
+   * @brief Allocate the points of the last evaluation of the nodes, as required by the incremental calcDiff
+   */
+  void resizeDerivativeCache();
+
+  /**
+   * @brief Check if the derivatives of a node are still valid, as required by the incremental calcDiff
+   *
+   * @param[in] i  node index \f$(0\leq i \lt T+1)\f$
+   * @param[in] x  state of the node
+   * @param[in] u  control of the node (empty for the terminal node)
+   * @return True if the node has to be evaluated again
+   */
+  bool isNodeOutdated(const std::size_t i, const VectorXs& x, const Eigen::Ref<const VectorXs>& u) const;
+
+  /**
+   * @brief Record the point of the last evaluation of a node
+   *
+   * @param[in] i  node index \f$(0\leq i \lt T+1)\f$
+   * @param[in] x  state of the node
+   * @param[in] u  control of the node (empty for the terminal node)
+   */
+  void recordNode(const std::size_t i, const VectorXs& x, const Eigen::Ref<const VectorXs>& u);
+
+  std::vector<double> calc_durations_;      //!< Measured duration of calc per running node
+  std::vector<double> calcDiff_durations_;  //!< Measured duration of calcDiff per running node
+  std::vector<std::size_t> node_bounds_;    //!< Bounds of the chunks used by the cost-aware load balancing
+  std::vector<std::size_t> node_order_;     //!< Order of the nodes used by the dynamic load balancing
+
+  std::vector<boost::shared_ptr<ActionModelAbstract> > pool_models_;  //!< Models of the removed nodes
+  std::vector<boost::shared_ptr<ActionDataAbstract> > pool_datas_;    //!< Datas of the removed nodes
+
+  bool incremental_calcDiff_;                          //!< True for the incremental evaluation of the derivatives
+  Scalar calcDiff_tolerance_;                          //!< Tolerance of the incremental evaluation of the derivatives
+  std::size_t calcDiff_skipped_;                       //!< Number of nodes skipped by the last calcDiff
+  std::vector<VectorXs> diff_xs_;                      //!< State of the last calcDiff per node
+  std::vector<VectorXs> diff_us_;                      //!< Control of the last calcDiff per running node
+  std::vector<const ActionDataAbstract*> diff_datas_;  //!< Data of the last calcDiff per node (null if invalid)
+  std::vector<unsigned char> diff_skipped_;            //!< Nodes skipped by the last calcDiff
 };
 
 }  // namespace crocoddyl
@@ -7,9 +7,10 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <iostream>
-#ifdef CROCODDYL_WITH_MULTITHREADING
-#include <omp.h>
-#endif  // CROCODDYL_WITH_MULTITHREADING
+#include <algorithm>
+#include <atomic>
+#include "crocoddyl/core/utils/timer.hpp"
+#include "crocoddyl/core/utils/instrumentation.hpp"
 
 namespace crocoddyl {
 
@@ -25,7 +26,13 @@ ShootingProblemTpl<Scalar>::ShootingProblemTpl(
       nx_(running_models[0]->get_state()->get_nx()),
       ndx_(running_models[0]->get_state()->get_ndx()),
       nu_max_(running_models[0]->get_nu()),
-      nthreads_(1) {
+      scheduler_(createDefaultScheduler()),
+      load_balancing_(LoadBalancingStatic),
+      calc_durations_(T_, 0.),
+      calcDiff_durations_(T_, 0.),
+      incremental_calcDiff_(false),
+      calcDiff_tolerance_(Scalar(0.)),
+      calcDiff_skipped_(0) {
   for (std::size_t i = 1; i < T_; ++i) {
     const boost::shared_ptr<ActionModelAbstract>& model = running_models_[i];
     const std::size_t nu = model->get_nu();
@@ -57,10 +64,6 @@ ShootingProblemTpl<Scalar>::ShootingProblemTpl(
                  << "ndx in terminal node is not consistent with the other nodes")
   }
   allocateData();
-
-#ifdef CROCODDYL_WITH_MULTITHREADING
-  nthreads_ = CROCODDYL_WITH_NTHREADS;
-#endif
 }
 
 template <typename Scalar>
@@ -79,7 +82,13 @@ ShootingProblemTpl<Scalar>::ShootingProblemTpl(
       nx_(running_models[0]->get_state()->get_nx()),
       ndx_(running_models[0]->get_state()->get_ndx()),
       nu_max_(running_models[0]->get_nu()),
-      nthreads_(1) {
+      scheduler_(createDefaultScheduler()),
+      load_balancing_(LoadBalancingStatic),
+      calc_durations_(T_, 0.),
+      calcDiff_durations_(T_, 0.),
+      incremental_calcDiff_(false),
+      calcDiff_tolerance_(Scalar(0.)),
+      calcDiff_skipped_(0) {
   for (std::size_t i = 1; i < T_; ++i) {
     const boost::shared_ptr<ActionModelAbstract>& model = running_models_[i];
     const std::size_t nu = model->get_nu();
@@ -117,10 +126,6 @@ ShootingProblemTpl<Scalar>::ShootingProblemTpl(
     throw_pretty("Invalid argument: "
                  << "terminal action data is not consistent with the terminal action model")
   }
-
-#ifdef CROCODDYL_WITH_MULTITHREADING
-  nthreads_ = CROCODDYL_WITH_NTHREADS;
-#endif
 }
 
 template <typename Scalar>
@@ -134,7 +139,14 @@ ShootingProblemTpl<Scalar>::ShootingProblemTpl(const ShootingProblemTpl<Scalar>&
       running_datas_(problem.get_runningDatas()),
       nx_(problem.get_nx()),
       ndx_(problem.get_ndx()),
-      nu_max_(problem.get_nu_max()) {}
+      nu_max_(problem.get_nu_max()),
+      scheduler_(problem.get_scheduler()),
+      load_balancing_(problem.get_load_balancing()),
+      calc_durations_(problem.get_calc_durations()),
+      calcDiff_durations_(problem.get_calcDiff_durations()),
+      incremental_calcDiff_(problem.get_incremental_calcDiff()),
+      calcDiff_tolerance_(problem.get_calcDiff_tolerance()),
+      calcDiff_skipped_(0) {}
 
 template <typename Scalar>
 ShootingProblemTpl<Scalar>::~ShootingProblemTpl() {}
@@ -150,23 +162,23 @@ Scalar ShootingProblemTpl<Scalar>::calc(const std::vector<VectorXs>& xs, const s
                  << "us has wrong dimension (it should be " + std::to_string(T_) + ")");
   }
 
-#ifdef CROCODDYL_WITH_MULTITHREADING
-#pragma omp parallel for num_threads(nthreads_)
-#endif
-  for (std::size_t i = 0; i < T_; ++i) {
-    const std::size_t nu = running_models_[i]->get_nu();
-    if (nu != 0) {
-      running_models_[i]->calc(running_datas_[i], xs[i], us[i].head(nu));
-    } else {
-      running_models_[i]->calc(running_datas_[i], xs[i]);
-    }
+  runNodes(
+      [&](const std::size_t i) {
+        InstrumentationProbe probe(ProbeNodeCalc);
+        const std::size_t nu = running_models_[i]->get_nu();
+        if (nu != 0) {
+          running_models_[i]->calc(running_datas_[i], xs[i], us[i].head(nu));
+        } else {
+          running_models_[i]->calc(running_datas_[i], xs[i]);
+        }
+      },
+      calc_durations_);
+  {
+    InstrumentationProbe probe(ProbeNodeCalc);
+    terminal_model_->calc(terminal_data_, xs.back());
   }
-  terminal_model_->calc(terminal_data_, xs.back());
 
   cost_ = Scalar(0.);
-#ifdef CROCODDYL_WITH_MULTITHREADING
-#pragma omp simd reduction(+ : cost_)
-#endif
   for (std::size_t i = 0; i < T_; ++i) {
     cost_ += running_datas_[i]->cost;
   }
@@ -185,28 +197,131 @@ Scalar ShootingProblemTpl<Scalar>::calcDiff(const std::vector<VectorXs>& xs, con
                  << "us has wrong dimension (it should be " + std::to_string(T_) + ")");
   }
 
-#ifdef CROCODDYL_WITH_MULTITHREADING
-#pragma omp parallel for num_threads(nthreads_)
-#endif
+  if (!incremental_calcDiff_) {
+    runNodes(
+        [&](const std::size_t i) {
+          InstrumentationProbe probe(ProbeNodeCalcDiff);
+          if (running_models_[i]->get_nu() != 0) {
+            const std::size_t nu = running_models_[i]->get_nu();
+            running_models_[i]->calcDiff(running_datas_[i], xs[i], us[i].head(nu));
+          } else {
+            running_models_[i]->calcDiff(running_datas_[i], xs[i]);
+          }
+        },
+        calcDiff_durations_);
+    {
+      InstrumentationProbe probe(ProbeNodeCalcDiff);
+      terminal_model_->calcDiff(terminal_data_, xs.back());
+    }
+    calcDiff_skipped_ = 0;
+  } else {
+    resizeDerivativeCache();
+    runNodes(
+        [&](const std::size_t i) {
+          const std::size_t nu = running_models_[i]->get_nu();
+          diff_skipped_[i] = !isNodeOutdated(i, xs[i], us[i].head(nu));
+          if (diff_skipped_[i]) {
+            return;
+          }
+          InstrumentationProbe probe(ProbeNodeCalcDiff);
+          if (nu != 0) {
+            running_models_[i]->calcDiff(running_datas_[i], xs[i], us[i].head(nu));
+          } else {
+            running_models_[i]->calcDiff(running_datas_[i], xs[i]);
+          }
+          recordNode(i, xs[i], us[i].head(nu));
+        },
+        calcDiff_durations_);
+    const VectorXs u_terminal;
+    diff_skipped_[T_] = !isNodeOutdated(T_, xs.back(), u_terminal);
+    if (!diff_skipped_[T_]) {
+      InstrumentationProbe probe(ProbeNodeCalcDiff);
+      terminal_model_->calcDiff(terminal_data_, xs.back());
+      recordNode(T_, xs.back(), u_terminal);
+    }
+    calcDiff_skipped_ = 0;
+    for (std::size_t i = 0; i < T_ + 1; ++i) {
+      calcDiff_skipped_ += diff_skipped_[i];
+    }
+  }
+
+  cost_ = Scalar(0.);
   for (std::size_t i = 0; i < T_; ++i) {
-    if (running_models_[i]->get_nu() != 0) {
-      const std::size_t nu = running_models_[i]->get_nu();
-      running_models_[i]->calcDiff(running_datas_[i], xs[i], us[i].head(nu));
+    cost_ += running_datas_[i]->cost;
+  }
+  cost_ += terminal_data_->cost;
+
+  return cost_;
+}
+
+template <typename Scalar>
+Scalar ShootingProblemTpl<Scalar>::calcAndDiff(const std::vector<VectorXs>& xs, const std::vector<VectorXs>& us) {
+  if (xs.size() != T_ + 1) {
+    throw_pretty("Invalid argument: "
+                 << "xs has wrong dimension (it should be " + std::to_string(T_ + 1) + ")");
+  }
+  if (us.size() != T_) {
+    throw_pretty("Invalid argument: "
+                 << "us has wrong dimension (it should be " + std::to_string(T_) + ")");
+  }
+
+  if (incremental_calcDiff_) {
+    resizeDerivativeCache();
+  }
+  // In incremental mode, the nodes with valid derivatives only need their next state and cost
+  runNodes(
+      [&](const std::size_t i) {
+        const std::size_t nu = running_models_[i]->get_nu();
+        bool diff = true;
+        if (incremental_calcDiff_) {
+          diff = isNodeOutdated(i, xs[i], us[i].head(nu));
+          diff_skipped_[i] = !diff;
+        }
+        if (diff) {
+          InstrumentationProbe probe(ProbeNodeCalcAndDiff);
+          if (nu != 0) {
+            running_models_[i]->calcAndDiff(running_datas_[i], xs[i], us[i].head(nu));
+          } else {
+            running_models_[i]->calcAndDiff(running_datas_[i], xs[i]);
+          }
+          if (incremental_calcDiff_) {
+            recordNode(i, xs[i], us[i].head(nu));
+          }
+        } else {
+          InstrumentationProbe probe(ProbeNodeCalc);
+          if (nu != 0) {
+            running_models_[i]->calc(running_datas_[i], xs[i], us[i].head(nu));
+          } else {
+            running_models_[i]->calc(running_datas_[i], xs[i]);
+          }
+        }
+      },
+      calcDiff_durations_);
+  calcDiff_skipped_ = 0;
+  if (incremental_calcDiff_) {
+    const VectorXs u_terminal;
+    diff_skipped_[T_] = !isNodeOutdated(T_, xs.back(), u_terminal);
+    if (diff_skipped_[T_]) {
+      InstrumentationProbe probe(ProbeNodeCalc);
+      terminal_model_->calc(terminal_data_, xs.back());
     } else {
-      running_models_[i]->calcDiff(running_datas_[i], xs[i]);
+      InstrumentationProbe probe(ProbeNodeCalcAndDiff);
+      terminal_model_->calcAndDiff(terminal_data_, xs.back());
+      recordNode(T_, xs.back(), u_terminal);
+    }
+    for (std::size_t i = 0; i < T_ + 1; ++i) {
+      calcDiff_skipped_ += diff_skipped_[i];
     }
+  } else {
+    InstrumentationProbe probe(ProbeNodeCalcAndDiff);
+    terminal_model_->calcAndDiff(terminal_data_, xs.back());
   }
-  terminal_model_->calcDiff(terminal_data_, xs.back());
 
   cost_ = Scalar(0.);
-#ifdef CROCODDYL_WITH_MULTITHREADING
-#pragma omp simd reduction(+ : cost_)
-#endif
   for (std::size_t i = 0; i < T_; ++i) {
     cost_ += running_datas_[i]->cost;
   }
   cost_ += terminal_data_->cost;
-
   return cost_;
 }
 
@@ -258,13 +373,10 @@ void ShootingProblemTpl<Scalar>::quasiStatic(std::vector<VectorXs>& us, const st
                  << "us has wrong dimension (it should be " + std::to_string(T_) + ")");
   }
 
-#ifdef CROCODDYL_WITH_MULTITHREADING
-#pragma omp parallel for num_threads(nthreads_)
-#endif
-  for (std::size_t i = 0; i < T_; ++i) {
+  scheduler_->parallelFor(T_, [&](const std::size_t i) {
     const std::size_t nu = running_models_[i]->get_nu();
     running_models_[i]->quasiStatic(running_datas_[i], us[i].head(nu), xs[i]);
-  }
+  });
 }
 
 template <typename Scalar>
@@ -299,10 +411,9 @@ void ShootingProblemTpl<Scalar>::circularAppend(boost::shared_ptr<ActionModelAbs
                  << "nu node is greater than the maximum nu")
   }
 
-  for (std::size_t i = 0; i < T_ - 1; ++i) {
-    running_models_[i] = running_models_[i + 1];
-    running_datas_[i] = running_datas_[i + 1];
-  }
+  shiftNodes();
+  shiftDurations();
+  discardPooledData(data);
   running_models_.back() = model;
   running_datas_.back() = data;
 }
@@ -322,12 +433,14 @@ void ShootingProblemTpl<Scalar>::circularAppend(boost::shared_ptr<ActionModelAbs
                  << "nu node is greater than the maximum nu")
   }
 
-  for (std::size_t i = 0; i < T_ - 1; ++i) {
-    running_models_[i] = running_models_[i + 1];
-    running_datas_[i] = running_datas_[i + 1];
+  shiftNodes();
+  shiftDurations();
+  boost::shared_ptr<ActionDataAbstract> data = popPooledData(model);
+  if (!data) {
+    data = model->createData();
   }
   running_models_.back() = model;
-  running_datas_.back() = model->createData();
+  running_datas_.back() = data;
 }
 
 template <typename Scalar>
@@ -355,6 +468,10 @@ void ShootingProblemTpl<Scalar>::updateNode(const std::size_t i, boost::shared_p
                  << "nu node is greater than the maximum nu")
   }
 
+  discardPooledData(data);
+  if (i < diff_datas_.size()) {
+    diff_datas_[i] = NULL;  // the data could be kept with a different model
+  }
   if (i == T_) {
     terminal_model_ = model;
     terminal_data_ = data;
@@ -392,6 +509,29 @@ void ShootingProblemTpl<Scalar>::updateModel(const std::size_t i, boost::shared_
   }
 }
 
+template <typename Scalar>
+void ShootingProblemTpl<Scalar>::swapDatas(std::vector<boost::shared_ptr<ActionDataAbstract> >& running_datas,
+                                           boost::shared_ptr<ActionDataAbstract>& terminal_data) {
+  if (running_datas.size() != T_) {
+    throw_pretty("Invalid argument: "
+                 << "running_datas has wrong dimension (it should be " + std::to_string(T_) + ")");
+  }
+  for (std::size_t i = 0; i < T_; ++i) {
+    if (!running_models_[i]->checkData(running_datas[i])) {
+      throw_pretty("Invalid argument: "
+                   << "action data in " << i << " node is not consistent with the action model");
+    }
+  }
+  if (!terminal_model_->checkData(terminal_data)) {
+    throw_pretty("Invalid argument: "
+                 << "terminal action data is not consistent with the terminal action model");
+  }
+
+  running_datas_.swap(running_datas);
+  terminal_data_.swap(terminal_data);
+  invalidateDerivatives();  // the cached data could come back with other derivatives
+}
+
 template <typename Scalar>
 std::size_t ShootingProblemTpl<Scalar>::get_T() const {
   return T_;
@@ -489,18 +629,20 @@ void ShootingProblemTpl<Scalar>::set_terminalModel(boost::shared_ptr<ActionModel
 
 template <typename Scalar>
 void ShootingProblemTpl<Scalar>::set_nthreads(const int nthreads) {
-#ifndef CROCODDYL_WITH_MULTITHREADING
-  (void)nthreads;
-  std::cerr << "Warning: the number of threads won't affect the computational performance as multithreading "
-               "support is not enabled."
-            << std::endl;
-#else
   if (nthreads < 1) {
-    nthreads_ = CROCODDYL_WITH_NTHREADS;
+    scheduler_->set_nthreads(SchedulerOpenMP::getDefaultNumThreads());
   } else {
-    nthreads_ = static_cast<std::size_t>(nthreads);
+    scheduler_->set_nthreads(static_cast<std::size_t>(nthreads));
   }
-#endif
+}
+
+template <typename Scalar>
+void ShootingProblemTpl<Scalar>::set_scheduler(boost::shared_ptr<SchedulerAbstract> scheduler) {
+  if (!scheduler) {
+    throw_pretty("Invalid argument: "
+                 << "the scheduler is empty");
+  }
+  scheduler_ = scheduler;
 }
 
 template <typename Scalar>
@@ -520,12 +662,246 @@ std::size_t ShootingProblemTpl<Scalar>::get_nu_max() const {
 
 template <typename Scalar>
 std::size_t ShootingProblemTpl<Scalar>::get_nthreads() const {
-#ifndef CROCODDYL_WITH_MULTITHREADING
-  std::cerr << "Warning: the number of threads won't affect the computational performance as multithreading "
-               "support is not enabled."
-            << std::endl;
-#endif
-  return nthreads_;
+  return scheduler_->get_nthreads();
+}
+
+template <typename Scalar>
+const boost::shared_ptr<SchedulerAbstract>& ShootingProblemTpl<Scalar>::get_scheduler() const {
+  return scheduler_;
+}
+
+template <typename Scalar>
+LoadBalancingType ShootingProblemTpl<Scalar>::get_load_balancing() const {
+  return load_balancing_;
+}
+
+template <typename Scalar>
+void ShootingProblemTpl<Scalar>::set_load_balancing(const LoadBalancingType type) {
+  load_balancing_ = type;
+}
+
+template <typename Scalar>
+const std::vector<double>& ShootingProblemTpl<Scalar>::get_calc_durations() const {
+  return calc_durations_;
+}
+
+template <typename Scalar>
+const std::vector<double>& ShootingProblemTpl<Scalar>::get_calcDiff_durations() const {
+  return calcDiff_durations_;
+}
+
+template <typename Scalar>
+bool ShootingProblemTpl<Scalar>::get_incremental_calcDiff() const {
+  return incremental_calcDiff_;
+}
+
+template <typename Scalar>
+void ShootingProblemTpl<Scalar>::set_incremental_calcDiff(const bool incremental) {
+  incremental_calcDiff_ = incremental;
+  invalidateDerivatives();
+}
+
+template <typename Scalar>
+Scalar ShootingProblemTpl<Scalar>::get_calcDiff_tolerance() const {
+  return calcDiff_tolerance_;
+}
+
+template <typename Scalar>
+void ShootingProblemTpl<Scalar>::set_calcDiff_tolerance(const Scalar tol) {
+  if (tol < Scalar(0.)) {
+    throw_pretty("Invalid argument: "
+                 << "tol has to be positive or zero");
+  }
+  calcDiff_tolerance_ = tol;
+}
+
+template <typename Scalar>
+std::size_t ShootingProblemTpl<Scalar>::get_calcDiff_skipped() const {
+  return calcDiff_skipped_;
+}
+
+template <typename Scalar>
+void ShootingProblemTpl<Scalar>::invalidateDerivatives() {
+  std::fill(diff_datas_.begin(), diff_datas_.end(), static_cast<const ActionDataAbstract*>(NULL));
+}
+
+template <typename Scalar>
+void ShootingProblemTpl<Scalar>::resizeDerivativeCache() {
+  if (diff_datas_.size() != T_ + 1) {
+    diff_xs_.resize(T_ + 1);
+    diff_us_.resize(T_);
+    diff_datas_.assign(T_ + 1, NULL);
+    diff_skipped_.assign(T_ + 1, 0);
+  }
+}
+
+template <typename Scalar>
+bool ShootingProblemTpl<Scalar>::isNodeOutdated(const std::size_t i, const VectorXs& x,
+                                                const Eigen::Ref<const VectorXs>& u) const {
+  const ActionDataAbstract* data = i == T_ ? terminal_data_.get() : running_datas_[i].get();
+  if (diff_datas_[i] != data || diff_xs_[i].size() != x.size() || (i < T_ && diff_us_[i].size() != u.size())) {
+    return true;
+  }
+  if (calcDiff_tolerance_ == Scalar(0.)) {
+    return x != diff_xs_[i] || (i < T_ && u != diff_us_[i]);
+  }
+  if ((x - diff_xs_[i]).template lpNorm<Eigen::Infinity>() > calcDiff_tolerance_) {
+    return true;
+  }
+  return i < T_ && u.size() != 0 && (u - diff_us_[i]).template lpNorm<Eigen::Infinity>() > calcDiff_tolerance_;
+}
+
+template <typename Scalar>
+void ShootingProblemTpl<Scalar>::recordNode(const std::size_t i, const VectorXs& x,
+                                            const Eigen::Ref<const VectorXs>& u) {
+  diff_xs_[i] = x;
+  if (i < T_) {
+    diff_us_[i] = u;
+    diff_datas_[i] = running_datas_[i].get();
+  } else {
+    diff_datas_[i] = terminal_data_.get();
+  }
+}
+
+template <typename Scalar>
+void ShootingProblemTpl<Scalar>::runNodes(const SchedulerAbstract::TaskFunction& node,
+                                          std::vector<double>& durations) {
+  const std::size_t nchunks = std::min(scheduler_->get_nthreads(), T_);
+  if (load_balancing_ == LoadBalancingStatic || nchunks < 2) {
+    scheduler_->parallelFor(T_, node);
+    return;
+  }
+  if (durations.size() != T_) {
+    durations.assign(T_, 0.);
+  }
+  const std::size_t T = T_;
+  SchedulerAbstract::TaskFunction timed_node = [&node, &durations](const std::size_t i) {
+    Timer timer;
+    node(i);
+    const double duration = timer.get_us_duration();
+    if (durations[i] == 0.) {
+      durations[i] = duration;
+    } else {
+      durations[i] += 0.2 * (duration - durations[i]);  // moving average
+    }
+  };
+
+  switch (load_balancing_) {
+    case LoadBalancingCostAware: {
+      // Split the horizon into contiguous chunks with the same measured cost
+      double total = 0.;
+      for (std::size_t i = 0; i < T; ++i) {
+        total += durations[i];
+      }
+      node_bounds_.resize(nchunks + 1);
+      node_bounds_.front() = 0;
+      node_bounds_.back() = T;
+      std::size_t i = 0;
+      double cumulative = 0.;
+      for (std::size_t k = 1; k < nchunks; ++k) {
+        if (total == 0.) {  // nodes not measured yet
+          node_bounds_[k] = k * T / nchunks;
+          continue;
+        }
+        const double target = total * static_cast<double>(k) / static_cast<double>(nchunks);
+        do {
+          cumulative += durations[i];
+          ++i;
+        } while (i < T - nchunks + k && cumulative + 0.5 * durations[i] < target);
+        node_bounds_[k] = i;
+      }
+      scheduler_->parallelFor(nchunks, [this, &timed_node](const std::size_t k) {
+        for (std::size_t i = node_bounds_[k]; i < node_bounds_[k + 1]; ++i) {
+          timed_node(i);
+        }
+      });
+      break;
+    }
+    case LoadBalancingDynamic: {
+      // Hand out the nodes, the most expensive first, to the idle threads
+      node_order_.resize(T);
+      for (std::size_t i = 0; i < T; ++i) {
+        node_order_[i] = i;
+      }
+      std::stable_sort(node_order_.begin(), node_order_.end(),
+                       [&durations](const std::size_t a, const std::size_t b) { return durations[a] > durations[b]; });
+      std::atomic<std::size_t> next(0);
+      scheduler_->parallelFor(nchunks, [this, T, &next, &timed_node](const std::size_t) {
+        for (std::size_t j = next++; j < T; j = next++) {
+          timed_node(node_order_[j]);
+        }
+      });
+      break;
+    }
+    default:
+      scheduler_->parallelFor(T, timed_node);
+      break;
+  }
+}
+
+template <typename Scalar>
+void ShootingProblemTpl<Scalar>::shiftDurations() {
+  if (calc_durations_.size() == T_ && T_ > 0) {
+    std::rotate(calc_durations_.begin(), calc_durations_.begin() + 1, calc_durations_.end());
+    calc_durations_.back() = 0.;
+  }
+  if (calcDiff_durations_.size() == T_ && T_ > 0) {
+    std::rotate(calcDiff_durations_.begin(), calcDiff_durations_.begin() + 1, calcDiff_durations_.end());
+    calcDiff_durations_.back() = 0.;
+  }
+}
+
+template <typename Scalar>
+void ShootingProblemTpl<Scalar>::shiftNodes() {
+  if (T_ == 0) {
+    return;
+  }
+  // The pool keeps the last T removed nodes, and its storage is reserved once
+  if (pool_models_.capacity() < T_) {
+    pool_models_.reserve(T_);
+    pool_datas_.reserve(T_);
+  }
+  while (pool_models_.size() >= T_) {
+    pool_models_.erase(pool_models_.begin());
+    pool_datas_.erase(pool_datas_.begin());
+  }
+  pool_models_.push_back(running_models_.front());
+  pool_datas_.push_back(running_datas_.front());
+  // Rotating swaps the pointers, so it does not update the reference counters
+  std::rotate(running_models_.begin(), running_models_.begin() + 1, running_models_.end());
+  std::rotate(running_datas_.begin(), running_datas_.begin() + 1, running_datas_.end());
+  // The shifted nodes keep their derivatives, while the appended node is evaluated from scratch
+  if (diff_datas_.size() == T_ + 1) {
+    std::rotate(diff_xs_.begin(), diff_xs_.begin() + 1, diff_xs_.begin() + T_);
+    std::rotate(diff_us_.begin(), diff_us_.begin() + 1, diff_us_.end());
+    std::rotate(diff_datas_.begin(), diff_datas_.begin() + 1, diff_datas_.begin() + T_);
+    diff_datas_[T_ - 1] = NULL;
+  }
+}
+
+template <typename Scalar>
+boost::shared_ptr<ActionDataAbstractTpl<Scalar> > ShootingProblemTpl<Scalar>::popPooledData(
+    const boost::shared_ptr<ActionModelAbstract>& model) {
+  boost::shared_ptr<ActionDataAbstract> data;
+  for (std::size_t i = pool_models_.size(); i-- > 0;) {  // the most recently removed first
+    if (pool_models_[i] == model) {
+      data.swap(pool_datas_[i]);
+      pool_models_.erase(pool_models_.begin() + i);
+      pool_datas_.erase(pool_datas_.begin() + i);
+      break;
+    }
+  }
+  return data;
+}
+
+template <typename Scalar>
+void ShootingProblemTpl<Scalar>::discardPooledData(const boost::shared_ptr<ActionDataAbstract>& data) {
+  for (std::size_t i = pool_datas_.size(); i-- > 0;) {
+    if (pool_datas_[i] == data) {
+      pool_models_.erase(pool_models_.begin() + i);
+      pool_datas_.erase(pool_datas_.begin() + i);
+    }
+  }
 }
 
 template <typename Scalar>
@@ -136,6 +136,17 @@ class SolverAbstract {
   void setCandidate(const std::vector<Eigen::VectorXd>& xs_warm = DEFAULT_VECTOR,
                     const std::vector<Eigen::VectorXd>& us_warm = DEFAULT_VECTOR, const bool is_feasible = false);
 
+  /**
+   * @brief Shift the solver warm-point by one node
+   *
+   * It is used by receding-horizon (MPC) loops after shifting the problem with
+   * `ShootingProblem::circularAppend()`. The state and control trajectories are rotated one node towards the
+   * beginning of the horizon, and the new end running node repeats the previous one. The rotation swaps the
+   * trajectory vectors, so it does not allocate memory. The shifted warm-point is used by calling
+   * `solve(get_xs(), get_us())`.
+   */
+  virtual void shiftWarmStart();
+
   /**
    * @brief Set a list of callback functions using for diagnostic
    *
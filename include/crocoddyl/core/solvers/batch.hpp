@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CROCODDYL_CORE_SOLVERS_BATCH_HPP_
+#define CROCODDYL_CORE_SOLVERS_BATCH_HPP_
+
+#include <vector>
+#include <boost/function.hpp>
+
+#include "crocoddyl/core/solver-base.hpp"
+#include "crocoddyl/core/utils/arena.hpp"
+
+namespace crocoddyl {
+
+/**
+ * @brief Batch solver
+ *
+ * It solves many instances of the same optimal control problem, which only differ on their initial state and
+ * warm-start (e.g. for multi-start or scenario sampling). All the instances share the action models of the given
+ * problem, while each one allocates its own datas and solver. The workspaces of the per-node terms of the DDP-based
+ * solvers (see `SolverDDP::get_workspace_size()`) are laid out contiguously in a single block, one instance after
+ * the other. The datas of the action models are still allocated by each model in `createData()`.
+ *
+ * The instances are solved in parallel through the scheduler of the given problem, i.e. one instance per iteration
+ * of `SchedulerAbstract::parallelFor()`, and the parallel loops inside each instance run serially. The convergence,
+ * iterations and cost of each instance are tracked independently.
+ *
+ * \sa `solve()`, `get_converged()`, `get_solvers()`
+ */
+class SolverBatch {
+ public:
+  typedef boost::function<boost::shared_ptr<SolverAbstract>(boost::shared_ptr<ShootingProblem>)> SolverCreator;
+
+  /**
+   * @brief Initialize the batch solver
+   *
+   * @param[in] problem  Shooting problem that defines the action models of all the instances
+   * @param[in] nbatch   Number of instances
+   * @param[in] creator  Function that creates the solver of each instance (default SolverFDDP)
+   */
+  SolverBatch(boost::shared_ptr<ShootingProblem> problem, const std::size_t nbatch,
+              SolverCreator creator = &SolverBatch::createSolverFDDP);
+
+  /**
+   * @brief Destroy the batch solver
+   *
+   * The solvers that are still shared (e.g. returned by `get_solvers()`) move their workspace to their own storage.
+   */
+  ~SolverBatch();
+
+  /**
+   * @brief Solve all the instances in parallel
+   *
+   * Empty lists keep the current initial state of each instance, and use the default warm-start of the solver.
+   * Otherwise, they must contain one element per instance.
+   *
+   * @param[in] x0s         Initial state of each instance (default [])
+   * @param[in] init_xs     Initial guess for the state trajectory of each instance (default [])
+   * @param[in] init_us     Initial guess for the control trajectory of each instance (default [])
+   * @param[in] maxiter     Maximum allowed number of iterations (default 100)
+   * @param[in] is_feasible True if the \p init_xs are obtained from integrating the \p init_us (default false)
+   * @param[in] reg_init    Initial guess for the regularization value (default 1e-9)
+   * @return True if all the instances converged
+   */
+  bool solve(const std::vector<Eigen::VectorXd>& x0s = DEFAULT_VECTOR,
+             const std::vector<std::vector<Eigen::VectorXd> >& init_xs = std::vector<std::vector<Eigen::VectorXd> >(),
+             const std::vector<std::vector<Eigen::VectorXd> >& init_us = std::vector<std::vector<Eigen::VectorXd> >(),
+             const std::size_t maxiter = 100, const bool is_feasible = false, const double reg_init = 1e-9);
+
+  /**
+   * @brief Return the shooting problem that defines the instances
+   */
+  const boost::shared_ptr<ShootingProblem>& get_problem() const;
+
+  /**
+   * @brief Return the number of instances
+   */
+  std::size_t get_nbatch() const;
+
+  /**
+   * @brief Return the shooting problem of each instance
+   */
+  const std::vector<boost::shared_ptr<ShootingProblem> >& get_problems() const;
+
+  /**
+   * @brief Return the solver of each instance
+   */
+  const std::vector<boost::shared_ptr<SolverAbstract> >& get_solvers() const;
+
+  /**
+   * @brief Return true for the instances that converged in the last `solve()`
+   */
+  std::vector<bool> get_converged() const;
+
+  /**
+   * @brief Return the number of instances that converged in the last `solve()`
+   */
+  std::size_t get_nconverged() const;
+
+  /**
+   * @brief Create a FDDP solver, it is the default creator
+   */
+  static boost::shared_ptr<SolverAbstract> createSolverFDDP(boost::shared_ptr<ShootingProblem> problem);
+
+ protected:
+  boost::shared_ptr<ShootingProblem> problem_;                 //!< Shooting problem that defines the instances
+  std::size_t nbatch_;                                         //!< Number of instances
+  std::vector<boost::shared_ptr<ShootingProblem> > problems_;  //!< Shooting problem of each instance
+  std::vector<boost::shared_ptr<SolverAbstract> > solvers_;    //!< Solver of each instance
+  std::vector<char> converged_;                                //!< True if the instance converged
+  MemoryArena workspace_;                                      //!< Block of the workspaces of the DDP-based solvers
+};
+
+}  // namespace crocoddyl
+
+#endif  // CROCODDYL_CORE_SOLVERS_BATCH_HPP_
@@ -25,8 +25,20 @@ class SolverBoxDDP : public SolverDDP {
   virtual ~SolverBoxDDP();
 
   virtual void allocateData();
+
+  /**
+   * @copybrief SolverDDP::backwardPass
+   *
+   * The box-QP gains cannot be condensed into Riccati elements, so this solver always runs the serial sweep.
+   */
+  virtual void backwardPass();
   virtual void computeGains(const std::size_t t);
   virtual void forwardPass(const double steplength);
+  virtual double computeRollout(const double steplength,
+                                const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas,
+                                const boost::shared_ptr<ActionDataAbstract>& data_T,
+                                std::vector<Eigen::VectorXd>& xs_try, std::vector<Eigen::VectorXd>& us_try,
+                                std::vector<Eigen::VectorXd>& dx, Eigen::VectorXd& xnext);
 
   const std::vector<Eigen::MatrixXd>& get_Quu_inv() const;
 
@@ -25,8 +25,27 @@ class SolverBoxFDDP : public SolverFDDP {
   virtual ~SolverBoxFDDP();
 
   virtual void allocateData();
+
+  /**
+   * @copybrief SolverDDP::backwardPass
+   *
+   * The box-QP gains cannot be condensed into Riccati elements, so this solver always runs the serial sweep.
+   */
+  virtual void backwardPass();
   virtual void computeGains(const std::size_t t);
+
+  /**
+   * @copybrief SolverFDDP::forwardPass
+   *
+   * The box-QP is only solved on feasible iterates, so the partitioned rollout is only used for the trials that keep
+   * the gaps open (i.e. infeasible guess and step length lower than one).
+   */
   virtual void forwardPass(const double steplength);
+  virtual double computeRollout(const double steplength,
+                                const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas,
+                                const boost::shared_ptr<ActionDataAbstract>& data_T,
+                                std::vector<Eigen::VectorXd>& xs_try, std::vector<Eigen::VectorXd>& us_try,
+                                std::vector<Eigen::VectorXd>& dx, Eigen::VectorXd& xnext);
 
   const std::vector<Eigen::MatrixXd>& get_Quu_inv() const;
 
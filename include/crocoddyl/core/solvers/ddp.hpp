@@ -9,14 +9,143 @@
 #ifndef CROCODDYL_CORE_SOLVERS_DDP_HPP_
 #define CROCODDYL_CORE_SOLVERS_DDP_HPP_
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <vector>
 #include <Eigen/Cholesky>
+#include <Eigen/LU>
 #include "crocoddyl/core/solver-base.hpp"
 #include "crocoddyl/core/mathbase.hpp"
+#include "crocoddyl/core/utils/arena.hpp"
 #include "crocoddyl/core/utils/deprecate.hpp"
 
 namespace crocoddyl {
 
+/**
+ * @brief Type of Riccati recursion run by the backward pass
+ *
+ *  - BackwardPassSerial: sequential sweep from \f$T-1\f$ to \f$0\f$
+ *  - BackwardPassPartitioned: the horizon is split into one segment per thread. The Value function at the segment
+ *    boundaries is obtained by an associative combination of the segments, and then each segment runs its own sweep in
+ *    parallel
+ */
+enum BackwardPassType { BackwardPassSerial = 0, BackwardPassPartitioned };
+
+/**
+ * @brief Type of line search run by the solver
+ *
+ *  - LineSearchSerial: the step lengths are tried one after the other
+ *  - LineSearchConcurrent: the step lengths are tried in batches of one per thread, each one rolled out on its own
+ *    action data. The largest accepted step length is the same as in the serial line search
+ */
+enum LineSearchType { LineSearchSerial = 0, LineSearchConcurrent };
+
+/**
+ * @brief Conditional Value function of a horizon segment
+ *
+ * It describes the optimal cost-to-go from \f$\delta\mathbf{x}_i\f$ to a given \f$\delta\mathbf{x}_j\f$ as
+ * \f{equation}
+ *   V_{i\rightarrow j} = \max_{\boldsymbol{\lambda}} \frac{1}{2}\delta\mathbf{x}_i^\top\mathbf{J}\delta\mathbf{x}_i
+ * - \boldsymbol{\eta}^\top\delta\mathbf{x}_i + \boldsymbol{\lambda}^\top(\delta\mathbf{x}_j -
+ * \mathbf{A}\delta\mathbf{x}_i - \mathbf{b}) - \frac{1}{2}\boldsymbol{\lambda}^\top\mathbf{C}\boldsymbol{\lambda}.
+ * \f}
+ * These elements are combined associatively, which allows us to compute the Value function at the segment boundaries
+ * without running a sequential sweep over the entire horizon.
+ */
+struct RiccatiElement {
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  /**
+   * @brief Initialize the Riccati element
+   */
+  RiccatiElement() {}
+
+  /**
+   * @brief Initialize the Riccati element
+   *
+   * @param[in] ndx  Dimension of the tangent space of the state manifold
+   */
+  explicit RiccatiElement(const std::size_t ndx)
+      : A(Eigen::MatrixXd::Zero(ndx, ndx)),
+        b(Eigen::VectorXd::Zero(ndx)),
+        C(Eigen::MatrixXd::Zero(ndx, ndx)),
+        eta(Eigen::VectorXd::Zero(ndx)),
+        J(Eigen::MatrixXd::Zero(ndx, ndx)) {}
+
+  Eigen::MatrixXd A;    //!< Transition matrix of the segment
+  Eigen::VectorXd b;    //!< Drift of the segment
+  Eigen::MatrixXd C;    //!< Control reachability matrix of the segment
+  Eigen::VectorXd eta;  //!< Negative gradient of the conditional Value function
+  Eigen::MatrixXd J;    //!< Hessian of the conditional Value function
+};
+
+/**
+ * @brief Temporaries of the Riccati sweep
+ *
+ * Each segment of the partitioned backward pass owns one, so that the segments can be swept in parallel.
+ */
+struct RiccatiSweepData {
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  typedef MathBaseTpl<double>::MatrixXsRowMajor MatrixXdRowMajor;
+
+  /**
+   * @brief Initialize the temporaries of the Riccati sweep
+   */
+  RiccatiSweepData() {}
+
+  /**
+   * @brief Initialize the temporaries of the Riccati sweep
+   *
+   * @param[in] ndx  Dimension of the tangent space of the state manifold
+   * @param[in] nu   Maximum dimension of the control vector
+   */
+  RiccatiSweepData(const std::size_t ndx, const std::size_t nu)
+      : FxTVxx_p(MatrixXdRowMajor::Zero(ndx, ndx)),
+        Vxx_tmp(Eigen::MatrixXd::Zero(ndx, ndx)),
+        MTVxx_p(Eigen::MatrixXd::Zero(ndx / 2, ndx)),
+        FxTVxx_pM(Eigen::MatrixXd::Zero(ndx, ndx / 2)),
+        Fx_dense(Eigen::MatrixXd::Zero(ndx, ndx)),
+        Fu_dense(Eigen::MatrixXd::Zero(ndx, nu)),
+        Vxx_first(Eigen::MatrixXd::Zero(ndx, ndx)),
+        Vx_first(Eigen::VectorXd::Zero(ndx)) {}
+
+  MatrixXdRowMajor FxTVxx_p;  //!< fxTVxx_p term
+  Eigen::MatrixXd Vxx_tmp;    //!< Temporary variable for ensuring symmetry of Vxx
+  Eigen::MatrixXd MTVxx_p;    //!< Rows of Vxx_p reduced by the Euler step, i.e. dt Vxx_p[q] + Vxx_p[v]
+  Eigen::MatrixXd FxTVxx_pM;  //!< Columns of fxTVxx_p reduced by the Euler step, i.e. dt fxTVxx_p[q] + fxTVxx_p[v]
+  Eigen::MatrixXd Fx_dense;   //!< Residual of the dense rows of fx with respect to the Euler step
+  Eigen::MatrixXd Fu_dense;   //!< Residual of the dense rows of fu with respect to the Euler step
+  Eigen::MatrixXd Vxx_first;  //!< Hessian of the Value function at the first node of a deferred segment
+  Eigen::VectorXd Vx_first;   //!< Gradient of the Value function at the first node of a deferred segment
+};
+
+/**
+ * @brief Rollout of a step length tried by the concurrent line search
+ *
+ * Each thread owns one trial, with its own action data, in order to roll out a different step length.
+ */
+struct LineSearchTrial {
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  /**
+   * @brief Initialize the line-search trial
+   */
+  LineSearchTrial() : cost(0.), success(false) {}
+
+  std::vector<boost::shared_ptr<ActionModelAbstract> > models;  //!< Running models used to create the data
+  std::vector<boost::shared_ptr<ActionDataAbstract> > datas;    //!< Running data of the trial
+  boost::shared_ptr<ActionModelAbstract> terminal_model;        //!< Terminal model used to create the data
+  boost::shared_ptr<ActionDataAbstract> terminal_data;          //!< Terminal data of the trial
+  std::vector<Eigen::VectorXd> xs;                              //!< State trajectory of the trial
+  std::vector<Eigen::VectorXd> us;                              //!< Control trajectory of the trial
+  std::vector<Eigen::VectorXd> dx;                              //!< State deviation of the trial
+  Eigen::VectorXd xnext;                                        //!< Next state
+  double cost;                                                  //!< Total cost of the trial
+  bool success;                                                 //!< True if the rollout was computed
+};
+
 /**
  * @brief Differential Dynamic Programming (DDP) solver
  *
@@ -44,6 +173,14 @@ namespace crocoddyl {
  *   \mathbf{\hat{x}}_{k+1} &=& \mathbf{f}_k(\mathbf{\hat{x}}_k,\mathbf{\hat{u}}_k).
  * \f}
  *
+ * The per-node terms of the Riccati sweep (i.e. Value function, Hamiltonian, gains and gaps) are stored in a single
+ * workspace allocated at construction, where the terms of each node are contiguous. It allows the backward pass to
+ * stream through memory, and MPC loops to reuse the solver without further allocations.
+ *
+ * When the action data advertises the block structure of an explicit Euler step (see `ActionDataAbstract`), the
+ * products of the Riccati sweep with \f$\mathbf{f}_\mathbf{x}\f$ and \f$\mathbf{f}_\mathbf{u}\f$ only run over
+ * their velocity rows and their dense (Lie-group) configuration rows.
+ *
  * \sa `backwardPass()` and `forwardPass()`
  */
 class SolverDDP : public SolverAbstract {
@@ -51,6 +188,9 @@ class SolverDDP : public SolverAbstract {
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
   typedef typename MathBaseTpl<double>::MatrixXsRowMajor MatrixXdRowMajor;
+  typedef Eigen::Map<Eigen::MatrixXd, Eigen::AlignedMax> MatrixXdMap;
+  typedef Eigen::Map<MatrixXdRowMajor, Eigen::AlignedMax> MatrixXdRowMajorMap;
+  typedef Eigen::Map<Eigen::VectorXd, Eigen::AlignedMax> VectorXdMap;
 
   /**
    * @brief Initialize the DDP solver
@@ -68,6 +208,15 @@ class SolverDDP : public SolverAbstract {
   virtual double stoppingCriteria();
   virtual const Eigen::Vector2d& expectedImprovement();
 
+  /**
+   * @copybrief SolverAbstract::shiftWarmStart()
+   *
+   * Additionally, it rotates the per-node terms of the workspace (e.g. the value function and the feedback and
+   * feed-forward gains) by rebinding their maps, so it neither copies nor allocates them. The gains of the new end
+   * running node repeat the previous ones.
+   */
+  virtual void shiftWarmStart();
+
   /**
    * @brief Update the Jacobian and Hessian of the optimal control problem
    *
@@ -104,6 +253,9 @@ class SolverDDP : public SolverAbstract {
    * Hessians of the cost function, \f$V_{\mathbf{x}_{k+1}}\f$ and \f$V_{\mathbf{xx}_{k+1}}\f$ defines the
    * linear-quadratic approximation of the Value function, and \f$\mathbf{\bar{f}}_{k+1}\f$ describes the gaps of the
    * dynamics.
+   *
+   * The sweep is run serially or partitioned across threads depending on `get_backward_type()`. Both produce the same
+   * Value function and gains up to round-off errors.
    */
   virtual void backwardPass();
 
@@ -123,6 +275,60 @@ class SolverDDP : public SolverAbstract {
    */
   virtual void forwardPass(const double stepLength);
 
+  /**
+   * @brief Rollout the policy into the given data and trajectories
+   *
+   * This is the rollout run by `forwardPass()`. It only reads the solver state, so that the concurrent line search
+   * can run it from several threads, each one with its own data and trajectories. Overrides have to call
+   * `notifyRolloutNode()` after computing each running node.
+   *
+   * @param[in]  stepLength  applied step length (\f$0\leq\alpha\leq1\f$)
+   * @param[in]  datas       running action data
+   * @param[in]  data_T      terminal action data
+   * @param[out] xs_try      state trajectory
+   * @param[out] us_try      control trajectory
+   * @param[out] dx          deviation of the state trajectory
+   * @param[out] xnext       next state
+   * @return the total cost of the rollout
+   */
+  virtual double computeRollout(const double stepLength,
+                                const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas,
+                                const boost::shared_ptr<ActionDataAbstract>& data_T,
+                                std::vector<Eigen::VectorXd>& xs_try, std::vector<Eigen::VectorXd>& us_try,
+                                std::vector<Eigen::VectorXd>& dx, Eigen::VectorXd& xnext);
+
+  /**
+   * @brief Run the preparation phase of a Real-Time Iteration (RTI)
+   *
+   * The RTI scheme runs one iteration per control cycle, split into two phases. The preparation phase linearizes the
+   * problem around the current guess (e.g. after `shiftWarmStart()`, so its first state is the predicted one) and runs
+   * the backward pass. It contains all the derivative evaluations, so it can run before the new measurement arrives.
+   * If the backward pass fails, the regularization is increased as in `solve()`; if it succeeds at the first attempt,
+   * the regularization is decreased for the next cycle.
+   *
+   * @return True if the search direction was computed
+   */
+  bool preparationPhase();
+
+  /**
+   * @brief Run the feedback phase of a Real-Time Iteration (RTI)
+   *
+   * Once the new measurement arrives, it updates the initial state of the problem and the gap of the first node, and
+   * applies the full step of the prepared search direction with the linearized dynamics:
+   * \f{eqnarray}
+   *   \delta\mathbf{x}_0 &=& \mathbf{\tilde{x}}_0\ominus\mathbf{x}_0,\\
+   *   \delta\mathbf{u}_k &=& -\mathbf{k}_k - \mathbf{K}_k\delta\mathbf{x}_k,\\
+   *   \delta\mathbf{x}_{k+1} &=& \mathbf{F_x}\delta\mathbf{x}_k + \mathbf{F_u}\delta\mathbf{u}_k +
+   *   \mathbf{\bar{f}}_{k+1}.
+   * \f}
+   * It does not evaluate the action models, so its latency is a fraction of an iteration. The control to apply is
+   * the first element of `get_us()`, and the updated guess is linearized by the next preparation phase. The
+   * regularization is left unchanged.
+   *
+   * @param[in] x0  Measured initial state
+   */
+  void feedbackPhase(const Eigen::VectorXd& x0);
+
   /**
    * @brief Compute the feedforward and feedback terms using a Cholesky decomposition
    *
@@ -138,6 +344,21 @@ class SolverDDP : public SolverAbstract {
    */
   virtual void computeGains(const std::size_t t);
 
+  /**
+   * @brief Run the backward pass sequentially over the entire horizon
+   */
+  void backwardPassSerial();
+
+  /**
+   * @brief Run the backward pass partitioned over horizon segments
+   *
+   * The horizon is split into one segment per thread. First, each segment is condensed into a `RiccatiElement` in
+   * parallel. Second, these elements are combined from the terminal node in order to obtain the Value function at
+   * each segment boundary. Finally, each segment runs the standard Riccati sweep in parallel. If the element of a node
+   * cannot be computed (i.e. \f$\mathbf{l}_{\mathbf{uu}}\f$ is not positive definite), then it runs the serial sweep.
+   */
+  void backwardPassPartitioned();
+
   /**
    * @brief Increase the state and control regularization values by a `regfactor_` factor
    */
@@ -153,6 +374,36 @@ class SolverDDP : public SolverAbstract {
    */
   virtual void allocateData();
 
+  /**
+   * @brief Return the type of Riccati recursion run by the backward pass
+   */
+  BackwardPassType get_backward_type() const;
+
+  /**
+   * @brief Return the type of line search run by the solver
+   */
+  LineSearchType get_linesearch_type() const;
+
+  /**
+   * @brief Return true if the backward pass runs the fixed-size kernels
+   */
+  bool get_fixed_size() const;
+
+  /**
+   * @brief Return true if the backward pass exploits the block structure of the dynamics
+   */
+  bool get_structured() const;
+
+  /**
+   * @brief Return true if the full step speculatively computes its derivatives during its rollout
+   */
+  bool get_speculative_calcDiff() const;
+
+  /**
+   * @brief Return true if a solve after `shiftWarmStart()` starts from the closed-loop rollout of the previous policy
+   */
+  bool get_warm_start_policy() const;
+
   /**
    * @brief Return the regularization factor used to increase the damping value
    */
@@ -208,52 +459,135 @@ class SolverDDP : public SolverAbstract {
   /**
    * @brief Return the Hessian of the Value function \f$V_{\mathbf{xx}_s}\f$
    */
-  const std::vector<Eigen::MatrixXd>& get_Vxx() const;
+  const std::vector<MatrixXdMap>& get_Vxx() const;
 
   /**
    * @brief Return the Hessian of the Value function \f$V_{\mathbf{x}_s}\f$
    */
-  const std::vector<Eigen::VectorXd>& get_Vx() const;
+  const std::vector<VectorXdMap>& get_Vx() const;
 
   /**
    * @brief Return the Hessian of the Hamiltonian function \f$\mathbf{Q}_{\mathbf{xx}_s}\f$
    */
-  const std::vector<Eigen::MatrixXd>& get_Qxx() const;
+  const std::vector<MatrixXdMap>& get_Qxx() const;
 
   /**
    * @brief Return the Hessian of the Hamiltonian function \f$\mathbf{Q}_{\mathbf{xu}_s}\f$
    */
-  const std::vector<Eigen::MatrixXd>& get_Qxu() const;
+  const std::vector<MatrixXdMap>& get_Qxu() const;
 
   /**
    * @brief Return the Hessian of the Hamiltonian function \f$\mathbf{Q}_{\mathbf{uu}_s}\f$
    */
-  const std::vector<Eigen::MatrixXd>& get_Quu() const;
+  const std::vector<MatrixXdMap>& get_Quu() const;
 
   /**
    * @brief Return the Jacobian of the Hamiltonian function \f$\mathbf{Q}_{\mathbf{x}_s}\f$
    */
-  const std::vector<Eigen::VectorXd>& get_Qx() const;
+  const std::vector<VectorXdMap>& get_Qx() const;
 
   /**
    * @brief Return the Jacobian of the Hamiltonian function \f$\mathbf{Q}_{\mathbf{u}_s}\f$
    */
-  const std::vector<Eigen::VectorXd>& get_Qu() const;
+  const std::vector<VectorXdMap>& get_Qu() const;
 
   /**
    * @brief Return the feedback gains \f$\mathbf{K}_{s}\f$
    */
-  const std::vector<MatrixXdRowMajor>& get_K() const;
+  const std::vector<MatrixXdRowMajorMap>& get_K() const;
 
   /**
    * @brief Return the feedforward gains \f$\mathbf{k}_{s}\f$
    */
-  const std::vector<Eigen::VectorXd>& get_k() const;
+  const std::vector<VectorXdMap>& get_k() const;
 
   /**
    * @brief Return the gaps \f$\mathbf{\bar{f}}_{s}\f$
    */
-  const std::vector<Eigen::VectorXd>& get_fs() const;
+  const std::vector<VectorXdMap>& get_fs() const;
+
+  /**
+   * @brief Return the size in bytes of the workspace of the per-node terms
+   */
+  std::size_t get_workspace_size() const;
+
+  /**
+   * @brief Return the size in bytes used by each node in the workspace
+   */
+  const std::vector<std::size_t>& get_workspace_nodes() const;
+
+  /**
+   * @brief Modify the type of Riccati recursion run by the backward pass
+   */
+  void set_backward_type(const BackwardPassType type);
+
+  /**
+   * @brief Modify the type of line search run by the solver
+   *
+   * Note that the concurrent line search always runs the serial rollout of each step length.
+   */
+  void set_linesearch_type(const LineSearchType type);
+
+  /**
+   * @brief Enable or disable the fixed-size kernels of the backward pass
+   *
+   * Crocoddyl compiles the Riccati sweep and the gains computation for a set of dimensions known at compile time,
+   * i.e. \f$(n_{dx}, n_u)\f$ equal to (3, 2) for the unicycle, (14, 7) for 7-DoF manipulators and (36, 12) for
+   * 12-DoF legged robots. With these dimensions, Eigen unrolls and vectorizes the products and the Cholesky
+   * decomposition. The kernels run in the nodes with the maximum number of controls, while the other nodes (e.g.
+   * impulse ones) and the other dimensions run the dynamic-size path. The kernels are selected again in each backward
+   * pass, so they follow the nodes after `ShootingProblem::circularAppend()` or `ShootingProblem::updateModel()`.
+   * They are disabled by default.
+   */
+  void set_fixed_size(const bool fixed_size);
+
+  /**
+   * @brief Enable or disable the structured products of the backward pass
+   *
+   * The products with the Jacobians of an explicit Euler step only run over their velocity rows and their dense
+   * configuration rows, which reduces the cost of \f$\mathbf{f}^\top_\mathbf{x}V_{\mathbf{xx}}\mathbf{f}_\mathbf{x}\f$
+   * from \f$2n_{dx}^3\f$ to \f$n_{dx}^2(n_{dx}+2n_{lie})\f$ flops, where \f$n_{lie}\f$ is the number of Lie-group
+   * directions of the state (e.g. 6 for a floating base). These nodes run the structured products instead of the
+   * fixed-size kernels. They are enabled by default.
+   */
+  void set_structured(const bool structured);
+
+  /**
+   * @brief Enable or disable the speculative derivatives of the full step
+   *
+   * The serial line search rolls out the first step length into spare data, while the other threads compute the
+   * derivatives of each node as soon as the rollout has passed it. Until then, these threads sleep on a condition
+   * variable. If the step is accepted, the spare data are exchanged with the problem ones, so the next iteration does
+   * not run `calcDiff()`. Otherwise, the line search continues as usual and only the speculative derivatives are
+   * wasted. It requires more than one thread, and it is disabled by default.
+   *
+   * Note that the speculative full step always runs the serial rollout.
+   */
+  void set_speculative_calcDiff(const bool speculative);
+
+  /**
+   * @brief Enable or disable the Riccati-based warm start of receding-horizon solves
+   *
+   * After `shiftWarmStart()`, the next `solve()` keeps the regularization of the previous one and replaces the guess
+   * by the closed-loop rollout of the shifted policy from the current initial state, i.e.
+   * \f$\mathbf{u}_t = \mathbf{u}_{s,t} - \mathbf{K}_t(\mathbf{x}_t\ominus\mathbf{x}_{s,t})\f$. This rollout is
+   * feasible and it corrects the guess with the value function of the previous solve, which usually reduces the
+   * number of iterations. Furthermore, the problem data already contain it, so the first `calcDiff()` only computes
+   * the derivatives. It is disabled by default.
+   */
+  void set_warm_start_policy(const bool warm_start);
+
+  /**
+   * @brief Place the workspace of the per-node terms in an external block
+   *
+   * The block has to contain `get_workspace_size()` bytes aligned to `MemoryArena::alignment`, and it has to outlive
+   * its use by the solver. It allows to lay out the workspaces of many solvers contiguously (e.g. in `SolverBatch`).
+   * It allocates the data of the solver again, so it is meant to be called before solving. A NULL block, or a new
+   * allocation of the data with another workspace size, returns to the own storage of the solver.
+   *
+   * @param[in] block  Aligned start of the external block
+   */
+  void set_workspace(double* block);
 
   /**
    * @brief Modify the regularization factor used to increase the damping value
@@ -319,30 +653,198 @@ class SolverDDP : public SolverAbstract {
   std::vector<Eigen::VectorXd> dx_;
 
   // allocate data
-  std::vector<Eigen::MatrixXd> Vxx_;  //!< Hessian of the Value function
-  Eigen::MatrixXd Vxx_tmp_;           //!< Temporary variable for ensuring symmetry of Vxx
-  std::vector<Eigen::VectorXd> Vx_;   //!< Gradient of the Value function
-  std::vector<Eigen::MatrixXd> Qxx_;  //!< Hessian of the Hamiltonian
-  std::vector<Eigen::MatrixXd> Qxu_;  //!< Hessian of the Hamiltonian
-  std::vector<Eigen::MatrixXd> Quu_;  //!< Hessian of the Hamiltonian
-  std::vector<Eigen::VectorXd> Qx_;   //!< Gradient of the Hamiltonian
-  std::vector<Eigen::VectorXd> Qu_;   //!< Gradient of the Hamiltonian
-  std::vector<MatrixXdRowMajor> K_;   //!< Feedback gains
-  std::vector<Eigen::VectorXd> k_;    //!< Feed-forward terms
-  std::vector<Eigen::VectorXd> fs_;   //!< Gaps/defects between shooting nodes
+  MemoryArena workspace_;                    //!< Contiguous storage of the per-node terms (node-major layout)
+  std::vector<std::size_t> workspace_nodes_;  //!< Bytes used by each node in the workspace
+  double* workspace_block_;                   //!< External block of the workspace (NULL for its own storage)
+  std::size_t workspace_block_size_;          //!< Size in bytes of the external block
+  std::vector<MatrixXdMap> Vxx_;              //!< Hessian of the Value function
+  std::vector<VectorXdMap> Vx_;               //!< Gradient of the Value function
+  std::vector<MatrixXdMap> Qxx_;              //!< Hessian of the Hamiltonian
+  std::vector<MatrixXdMap> Qxu_;              //!< Hessian of the Hamiltonian
+  std::vector<MatrixXdMap> Quu_;              //!< Hessian of the Hamiltonian
+  std::vector<VectorXdMap> Qx_;               //!< Gradient of the Hamiltonian
+  std::vector<VectorXdMap> Qu_;               //!< Gradient of the Hamiltonian
+  std::vector<MatrixXdRowMajorMap> K_;        //!< Feedback gains
+  std::vector<VectorXdMap> k_;                //!< Feed-forward terms
+  std::vector<VectorXdMap> fs_;               //!< Gaps/defects between shooting nodes
 
   Eigen::VectorXd xnext_;                              //!< Next state
-  MatrixXdRowMajor FxTVxx_p_;                          //!< fxTVxx_p_
-  std::vector<MatrixXdRowMajor> FuTVxx_p_;             //!< fuTVxx_p_
+  RiccatiSweepData sweep_;                             //!< Temporaries of the serial Riccati sweep
+  std::vector<MatrixXdRowMajorMap> FuTVxx_p_;          //!< fuTVxx_p_
   Eigen::VectorXd fTVxx_p_;                            //!< fTVxx_p term
   std::vector<Eigen::LLT<Eigen::MatrixXd> > Quu_llt_;  //!< Cholesky LLT solver
-  std::vector<Eigen::VectorXd> Quuk_;                  //!< Quuk term
+  std::vector<VectorXdMap> Quuk_;                      //!< Quuk term
   std::vector<double> alphas_;                         //!< Set of step lengths using by the line-search procedure
   double th_grad_;     //!< Tolerance of the expected gradient used for testing the step
   double th_gaptol_;   //!< Threshold limit to check non-zero gaps
   double th_stepdec_;  //!< Step-length threshold used to decrease regularization
   double th_stepinc_;  //!< Step-length threshold used to increase regularization
   bool was_feasible_;  //!< Label that indicates in the previous iterate was feasible
+
+  BackwardPassType backward_type_;  //!< Type of Riccati recursion run by the backward pass
+  LineSearchType linesearch_type_;  //!< Type of line search run by the solver
+  bool fixed_size_;                 //!< True if the backward pass runs the fixed-size kernels
+  bool structured_;                 //!< True if the backward pass exploits the block structure of the dynamics
+
+  /**
+   * @brief Try the i-th step length of `alphas_`
+   *
+   * The serial line search runs `tryStep()`. Instead, the concurrent line search rolls out a batch of step lengths,
+   * one per thread, when the i-th step length is the first one of the batch. Then it loads the rollout of the i-th
+   * step length into `xs_try_` and `us_try_`.
+   *
+   * @param[in] i  index of the step length
+   * @return the cost reduction
+   */
+  double tryLineSearchStep(const std::size_t i);
+
+  /**
+   * @brief Notify that the rollout has computed the node \f$t\f$
+   *
+   * The rollouts call it after each running node, so that the speculative derivatives can start on this node. It
+   * does nothing for the other rollouts.
+   */
+  void notifyRolloutNode(const std::size_t t);
+
+  /**
+   * @brief Apply the Riccati-based warm start at the beginning of a solve
+   *
+   * It has to be called after setting the candidate. It does nothing if the warm start is disabled or if the horizon
+   * was not shifted after the last solve.
+   *
+   * @return true if the guess was replaced by the closed-loop rollout of the shifted policy
+   */
+  bool applyWarmStart();
+
+ private:
+  /**
+   * @brief Run the Riccati sweep from \f$t_1-1\f$ down to \f$t_0\f$
+   *
+   * It assumes that the Value function at \f$t_1\f$ has been computed. When `defer_first` is true, the Value
+   * function of \f$t_0\f$ is written into `sweep.Vxx_first` and `sweep.Vx_first` instead of the workspace, so a
+   * concurrent sweep of the previous segment can read the value of \f$t_0\f$ meanwhile.
+   */
+  void backwardPassSegment(const std::size_t t0, const std::size_t t1, RiccatiSweepData& sweep,
+                           const bool defer_first = false);
+
+  /**
+   * @brief Add the dynamics terms of the node \f$t\f$ to its Hamiltonian by exploiting the structure of an Euler step
+   *
+   * Let \f$\mathbf{F}_v\f$ be the velocity rows of \f$\mathbf{f}_\mathbf{x}\f$, then
+   * \f$\mathbf{f}_\mathbf{x} = \mathbf{M}\mathbf{F}_v + \mathbf{C}\f$ with \f$\mathbf{M} = [dt\mathbf{I};
+   * \mathbf{I}]\f$, where \f$\mathbf{C}\f$ only has the dense configuration rows and an identity block (and
+   * similarly for \f$\mathbf{f}_\mathbf{u}\f$). It computes the Hessian terms of the Hamiltonian, and the fuTVxx_p
+   * term, with these factors.
+   */
+  void computeStructuredTerms(const std::size_t t, RiccatiSweepData& sweep);
+
+  /**
+   * @brief Condense the node \f$t\f$ into a Riccati element
+   *
+   * @return false if \f$\mathbf{l}_{\mathbf{uu}}\f$ is not positive definite
+   */
+  bool computeRiccatiElement(const std::size_t t, RiccatiElement& e);
+
+  /**
+   * @brief Combine the elements of two consecutive segments, i.e. \f$e_{ik} = e_{ij}\otimes e_{jk}\f$
+   */
+  void combineRiccatiElements(const RiccatiElement& e_ij, const RiccatiElement& e_jk, RiccatiElement& e_ik,
+                              Eigen::PartialPivLU<Eigen::MatrixXd>& lu, Eigen::MatrixXd& MA, Eigen::MatrixXd& MC,
+                              Eigen::VectorXd& Mb);
+
+  /**
+   * @brief Allocate the segment workspaces used by the partitioned backward pass
+   */
+  void allocatePartitionData(const std::size_t nsegments);
+
+  std::vector<std::size_t> seg_bounds_;                        //!< First node of each segment (plus T)
+  std::vector<RiccatiElement> seg_elems_;                      //!< Condensed element of each segment
+  std::vector<RiccatiElement> seg_nodes_;                      //!< Node element of each segment
+  std::vector<RiccatiElement> seg_tmps_;                       //!< Temporary element of each segment
+  std::vector<Eigen::PartialPivLU<Eigen::MatrixXd> > seg_lu_;  //!< LU solvers used to combine the elements
+  std::vector<Eigen::MatrixXd> seg_MA_;                        //!< Temporary (I + C_ij J_jk)^{-1} A_ij terms
+  std::vector<Eigen::MatrixXd> seg_MC_;                        //!< Temporary (I + C_ij J_jk)^{-1} C_ij terms
+  std::vector<Eigen::VectorXd> seg_Mb_;                        //!< Temporary (I + C_ij J_jk)^{-1} b_ij terms
+  std::vector<RiccatiSweepData> seg_sweeps_;                   //!< Temporaries of the Riccati sweep of each segment
+  std::vector<char> seg_success_;                              //!< True if the segment element was computed
+  RiccatiElement suffix_;                                      //!< Value function at the current segment boundary
+
+  /**
+   * @brief Allocate the trials used by the concurrent line search
+   *
+   * The action data are only created for new nodes or models, so that it can be called before each batch.
+   */
+  void allocateLineSearchData(const std::size_t ntrials);
+
+  /**
+   * @brief Allocate the data and trajectories of a trial
+   *
+   * @param[in] trial     trial to allocate
+   * @param[in] own_data  true if the trial rolls out into its own action data
+   */
+  void allocateTrialData(LineSearchTrial& trial, const bool own_data);
+
+  std::vector<LineSearchTrial> ls_trials_;  //!< Trials of the concurrent line search
+  bool calc_outdated_;                      //!< True if the problem data was not computed for the accepted trial
+
+  /**
+   * @brief Roll out the first step length and compute its derivatives on the spare data
+   *
+   * Task 0 runs the rollout, while the other tasks differentiate the nodes already rolled out. Then task 0 joins the
+   * derivatives. A task that starts before the rollout returns at once, so it never waits for a task that its own
+   * thread has still to run.
+   *
+   * @return the cost reduction
+   */
+  double trySpeculativeStep();
+
+  /**
+   * @brief Return true if the spare data contain the derivatives of the current guess
+   */
+  bool hasSpeculativeDerivatives() const;
+
+  bool speculative_;                     //!< True if the full step speculatively computes its derivatives
+  LineSearchTrial spec_trial_;           //!< Spare data of the speculative full step
+  bool spec_available_;                  //!< True if the spare data contain the derivatives of the last rollout
+  bool spec_rollout_;                    //!< True while the speculative rollout runs
+  std::atomic<std::size_t> spec_nodes_;  //!< Number of nodes computed by the speculative rollout
+  std::mutex spec_mutex_;                //!< Mutex that guards the notifications of the speculative rollout
+  std::condition_variable spec_cond_;    //!< Wakes the tasks that wait for a node of the speculative rollout
+  std::size_t spec_waiting_;             //!< Number of tasks that wait for a node of the speculative rollout
+
+  typedef void (SolverDDP::*FixedNodeFunction)(const std::size_t, RiccatiSweepData&, double*, double*);
+  typedef void (SolverDDP::*FixedGainsFunction)(const std::size_t);
+
+  /**
+   * @brief Run the Riccati sweep of the node \f$t\f$ with compile-time dimensions
+   *
+   * The Hessian and gradient of its Value function are written into `Vxx` and `Vx`.
+   */
+  template <int NX, int NU>
+  void backwardPassNodeFixed(const std::size_t t, RiccatiSweepData& sweep, double* Vxx, double* Vx);
+
+  /**
+   * @brief Compute the gains of the node \f$t\f$ with compile-time dimensions
+   */
+  template <int NX, int NU>
+  void computeGainsFixed(const std::size_t t);
+
+  /**
+   * @brief Select the fixed-size kernels that match the problem dimensions
+   */
+  void selectFixedSizeKernels();
+
+  FixedNodeFunction fixed_node_;    //!< Fixed-size Riccati sweep of a node (NULL if not compiled)
+  FixedGainsFunction fixed_gains_;  //!< Fixed-size gains of a node (NULL if not compiled)
+  std::size_t fixed_nu_;            //!< Number of controls of the nodes that run the fixed-size kernels
+
+  bool warm_start_policy_;  //!< True if a shifted solve starts from the closed-loop rollout of the previous policy
+  bool shifted_;            //!< True if the horizon was shifted after the last solve
+  bool warm_rollout_;       //!< True if the problem data contain the rollout of the warm start
+
+  bool rti_prepared_;            //!< True if the search direction of the feedback phase was prepared
+  Eigen::VectorXd rti_dx_;       //!< State deviation of the feedback phase
+  Eigen::VectorXd rti_dx_next_;  //!< State deviation of the next node in the feedback phase
 };
 
 }  // namespace crocoddyl
@@ -13,9 +13,29 @@
 #include <vector>
 
 #include "crocoddyl/core/solvers/ddp.hpp"
+#include "crocoddyl/core/utils/timer.hpp"
 
 namespace crocoddyl {
 
+/**
+ * @brief Type of rollout run by the forward pass
+ *
+ *  - ForwardPassSerial: sequential rollout from \f$0\f$ to \f$T\f$
+ *  - ForwardPassPartitioned: the horizon is split into one segment per thread. The initial state of each segment is
+ *    predicted with the linearized dynamics, and then each segment runs its own rollout in parallel. It leaves a
+ *    second-order gap at the segment boundaries, as in a multiple-shooting update
+ */
+enum ForwardPassType { ForwardPassSerial = 0, ForwardPassPartitioned };
+
+/**
+ * @brief Phase of the iteration in which the time budget of `solve()` expired
+ *
+ *  - DeadlineNotReached: the solver finished within its time budget
+ *  - DeadlineComputeDirection: the budget expired before computing the search direction of a new iteration
+ *  - DeadlineLineSearch: the budget expired during the line search, before accepting a step
+ */
+enum DeadlinePhase { DeadlineNotReached = 0, DeadlineComputeDirection, DeadlineLineSearch };
+
 /**
  * @brief Feasibility-driven Differential Dynamic Programming (FDDP) solver
  *
@@ -57,6 +77,17 @@ class SolverFDDP : public SolverDDP {
   explicit SolverFDDP(boost::shared_ptr<ShootingProblem> problem);
   virtual ~SolverFDDP();
 
+  /**
+   * @copybrief SolverAbstract::solve
+   *
+   * The solver also stops once the time budget given by `set_deadline()` expires. The budget is checked between the
+   * phases of each iteration, i.e. before computing the search direction and between the trials of the line search.
+   * In that case, it returns false and keeps the last accepted iterate. The phase in which the budget expired is
+   * reported by `get_deadline_phase()`. Note that the search direction (e.g. the feedback gains) is the one of the
+   * last backward pass, so it was computed around the previous iterate if a step was accepted after it, see
+   * `get_direction_outdated()`. Furthermore, the problem data might contain the last trial of the line search
+   * instead of the accepted iterate.
+   */
   virtual bool solve(const std::vector<Eigen::VectorXd>& init_xs = DEFAULT_VECTOR,
                      const std::vector<Eigen::VectorXd>& init_us = DEFAULT_VECTOR, const std::size_t maxiter = 100,
                      const bool is_feasible = false, const double regInit = 1e-9);
@@ -79,25 +110,145 @@ class SolverFDDP : public SolverDDP {
    * @brief Update internal values for computing the expected improvement
    */
   void updateExpectedImprovement();
+
+  /**
+   * @copybrief SolverDDP::forwardPass
+   *
+   * The rollout is run serially or partitioned across threads depending on `get_forward_type()`.
+   */
   virtual void forwardPass(const double stepLength);
 
+  /**
+   * @copybrief SolverDDP::computeRollout
+   *
+   * It keeps the gaps open according to the step length, as described in `SolverFDDP`.
+   */
+  virtual double computeRollout(const double stepLength,
+                                const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas,
+                                const boost::shared_ptr<ActionDataAbstract>& data_T,
+                                std::vector<Eigen::VectorXd>& xs_try, std::vector<Eigen::VectorXd>& us_try,
+                                std::vector<Eigen::VectorXd>& dx, Eigen::VectorXd& xnext);
+
+  /**
+   * @brief Run the rollout partitioned in segments, one per thread
+   *
+   * The initial state of each segment is predicted by rolling out the linearized dynamics, i.e.
+   * \f$\delta\mathbf{x}_{k+1} = \mathbf{F_x}\delta\mathbf{x}_k + \mathbf{F_u}\delta\mathbf{u}_k +
+   * \alpha\mathbf{\bar{f}}_{k+1}\f$, then the nonlinear rollout of each segment is computed in parallel. Contrary to
+   * the serial rollout, the step does not close the gaps at the segment boundaries, and their largest infinity norm
+   * is stored for the acceptance of the step. With a single segment, it reduces to the serial rollout.
+   *
+   * @param[in] stepLength  Step length
+   * @param[in] clamp       True for clamping the controls within their limits
+   */
+  void forwardPassPartitioned(const double stepLength, const bool clamp = false);
+
   /**
    * @brief Return the threshold used for accepting step along ascent direction
    */
   double get_th_acceptnegstep() const;
 
+  /**
+   * @brief Return the type of rollout run by the forward pass
+   */
+  ForwardPassType get_forward_type() const;
+
+  /**
+   * @brief Return the threshold for accepting the segment boundaries of the partitioned rollout as closed
+   */
+  double get_th_boundgap() const;
+
+  /**
+   * @brief Return the time budget of `solve()` (in milliseconds)
+   */
+  double get_deadline() const;
+
+  /**
+   * @brief Return the phase in which the time budget of the last `solve()` expired
+   */
+  DeadlinePhase get_deadline_phase() const;
+
+  /**
+   * @brief Return true if a step was accepted after computing the search direction
+   *
+   * In that case, the search direction (e.g. the feedback gains) was computed around the previous iterate.
+   */
+  bool get_direction_outdated() const;
+
   /**
    * @brief Modify the threshold used for accepting step along ascent direction
    */
   void set_th_acceptnegstep(const double th_acceptnegstep);
 
+  /**
+   * @brief Modify the type of rollout run by the forward pass
+   *
+   * Note that the partitioned rollout leaves gaps at the segment boundaries. An accepted full step (or a step from a
+   * feasible guess) is marked as feasible only if these gaps are below `get_th_boundgap()`; otherwise they are closed
+   * by the next iterations as in a multiple-shooting update.
+   */
+  void set_forward_type(const ForwardPassType type);
+
+  /**
+   * @brief Modify the threshold for accepting the segment boundaries of the partitioned rollout as closed
+   *
+   * The boundary gaps are second order in the step, so they reach the round-off level of the states only at
+   * convergence. Its default value is 1e-9, whereas `get_th_gaptol()` is kept for the gaps of the guess.
+   */
+  void set_th_boundgap(const double th_boundgap);
+
+  /**
+   * @brief Modify the time budget of `solve()` (in milliseconds)
+   *
+   * The budget is measured with a monotonic clock from the beginning of `solve()`. Its default value is infinity,
+   * i.e. the solver only stops after reaching the stopping criteria or the maximum number of iterations.
+   */
+  void set_deadline(const double deadline);
+
  protected:
-  double dg_;  //!< Internal data for computing the expected improvement
-  double dq_;  //!< Internal data for computing the expected improvement
-  double dv_;  //!< Internal data for computing the expected improvement
+  double dg_;                     //!< Internal data for computing the expected improvement
+  double dq_;                     //!< Internal data for computing the expected improvement
+  double dv_;                     //!< Internal data for computing the expected improvement
+  ForwardPassType forward_type_;  //!< Type of rollout run by the forward pass
 
  private:
-  double th_acceptnegstep_;  //!< Threshold used for accepting step along ascent direction
+  /**
+   * @brief Allocate the segment workspaces used by the partitioned forward pass
+   */
+  void allocateRolloutData(const std::size_t nsegments);
+
+  /**
+   * @brief Check if the accepted step leads to a feasible guess
+   *
+   * The serial rollout closes the gaps with a full step (or keeps them closed from a feasible guess), while the
+   * partitioned one also needs its boundary gaps to be below `get_th_boundgap()`.
+   */
+  bool isStepFeasible() const;
+
+  /**
+   * @brief Check if the time budget of `solve()` expired
+   *
+   * @param[in] phase  Phase that is reported if the budget expired
+   * @return True if the budget expired
+   */
+  bool checkDeadline(const DeadlinePhase phase);
+
+  double th_acceptnegstep_;                  //!< Threshold used for accepting step along ascent direction
+  double th_boundgap_;                       //!< Threshold for accepting the segment boundaries as closed
+  std::vector<std::size_t> roll_bounds_;     //!< First node of each segment (plus T)
+  std::vector<Eigen::VectorXd> roll_dx_;     //!< Predicted state deviation at the first node of each segment
+  std::vector<Eigen::VectorXd> roll_xnext_;  //!< Next state of each segment
+  std::vector<double> roll_cost_;            //!< Cost of each segment
+  std::vector<char> roll_success_;           //!< True if the segment rollout was computed
+  Eigen::VectorXd roll_fs_;                  //!< Gap at a segment boundary
+  double roll_gap_;                          //!< Largest infinity norm of the boundary gaps of the last rollout
+  Eigen::VectorXd dx_lin_;                   //!< Predicted state deviation
+  Eigen::VectorXd dx_lin_next_;              //!< Predicted state deviation of the next node
+
+  double deadline_;               //!< Time budget of solve (in milliseconds)
+  DeadlinePhase deadline_phase_;  //!< Phase in which the time budget expired
+  Timer deadline_timer_;          //!< Monotonic clock started at the beginning of solve
+  bool direction_outdated_;       //!< True if a step was accepted after computing the search direction
 };
 
 }  // namespace crocoddyl
@@ -17,6 +17,25 @@
 
 namespace crocoddyl {
 
+/**
+ * @brief Type of factorization of the KKT system
+ *
+ *  - KKTFactorizationRiccati: block-tridiagonal factorization of the KKT system, i.e. a Riccati recursion over the
+ *    node blocks of the action data. It runs in \f$O(T)\f$ time and memory
+ *  - KKTFactorizationDense: LU decomposition of the dense KKT matrix. It runs in \f$O(T^3)\f$ time and
+ *    \f$O(T^2)\f$ memory, and it is kept for validation
+ */
+enum KKTFactorizationType { KKTFactorizationRiccati = 0, KKTFactorizationDense };
+
+/**
+ * @brief KKT solver
+ *
+ * It computes the primal and dual search direction of the equality-constrained quadratic subproblem. The KKT matrix
+ * is block tridiagonal, with the node blocks (i.e. cost Hessians and dynamics Jacobians) given by the action data. By
+ * default, it is factorized by a Riccati recursion over these blocks and the dense matrix is never formed.
+ *
+ * \sa `computeDirection()`, `set_factorization_type()`
+ */
 class SolverKKT : public SolverAbstract {
  public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -32,6 +51,11 @@ class SolverKKT : public SolverAbstract {
   virtual double stoppingCriteria();
   virtual const Eigen::Vector2d& expectedImprovement();
 
+  /**
+   * @brief Return the dense KKT matrix
+   *
+   * With the Riccati factorization, it is assembled from the action data on demand.
+   */
   const Eigen::MatrixXd& get_kkt() const;
   const Eigen::VectorXd& get_kktref() const;
   const Eigen::VectorXd& get_primaldual() const;
@@ -42,6 +66,16 @@ class SolverKKT : public SolverAbstract {
   std::size_t get_ndx() const;
   std::size_t get_nu() const;
 
+  /**
+   * @brief Return the type of factorization of the KKT system
+   */
+  KKTFactorizationType get_factorization_type() const;
+
+  /**
+   * @brief Modify the type of factorization of the KKT system
+   */
+  void set_factorization_type(const KKTFactorizationType type);
+
  protected:
   double reg_incfactor_;
   double reg_decfactor_;
@@ -54,6 +88,21 @@ class SolverKKT : public SolverAbstract {
  private:
   double calcDiff();
   void computePrimalDual();
+
+  /**
+   * @brief Factorize and solve the KKT system with a Riccati recursion over the node blocks
+   *
+   * The backward recursion computes the quadratic Value function \f$(\mathbf{P}_t, \mathbf{p}_t)\f$ and the gains of
+   * each node, then the forward recursion rolls out the primal direction. The multipliers are the negative gradient
+   * of the Value function, i.e. \f$\boldsymbol{\lambda}_t = -(\mathbf{P}_t\delta\mathbf{x}_t + \mathbf{p}_t)\f$.
+   */
+  void computePrimalDualRiccati();
+
+  /**
+   * @brief Fill the dense KKT matrix from the action data
+   */
+  void assembleKKT(Eigen::MatrixXd& kkt) const;
+
   void increaseRegularization();
   void decreaseRegularization();
   void allocateData();
@@ -66,7 +115,8 @@ class SolverKKT : public SolverAbstract {
   std::vector<Eigen::VectorXd> lambdas_;
 
   // allocate data
-  Eigen::MatrixXd kkt_;
+  KKTFactorizationType factorization_type_;
+  mutable Eigen::MatrixXd kkt_;
   Eigen::VectorXd kktref_;
   Eigen::VectorXd primaldual_;
   Eigen::VectorXd primal_;
@@ -76,6 +126,20 @@ class SolverKKT : public SolverAbstract {
   bool was_feasible_;
   Eigen::VectorXd kkt_primal_;
   Eigen::VectorXd dF;
+
+  // Riccati factorization
+  std::vector<Eigen::MatrixXd> P_;                       //!< Hessian of the Value function
+  std::vector<Eigen::VectorXd> p_;                       //!< Gradient of the Value function
+  std::vector<Eigen::MatrixXd> K_;                       //!< Feedback gains
+  std::vector<Eigen::VectorXd> k_;                       //!< Feed-forward terms
+  std::vector<Eigen::LDLT<Eigen::MatrixXd> > Quu_ldlt_;  //!< LDLT solver of the control Hessian of each node
+  Eigen::MatrixXd P_tmp_;                                //!< Temporary variable for ensuring symmetry of P
+  Eigen::MatrixXd Qxu_;                                  //!< Temporary Hessian of the Hamiltonian
+  Eigen::MatrixXd Quu_;                                  //!< Temporary Hessian of the Hamiltonian
+  Eigen::VectorXd Qu_;                                   //!< Temporary gradient of the Hamiltonian
+  Eigen::MatrixXd FxTP_;                                 //!< Temporary fx^T P term
+  Eigen::MatrixXd FuTP_;                                 //!< Temporary fu^T P term
+  Eigen::VectorXd Pb_;                                   //!< Temporary P b + p term
 };
 
 }  // namespace crocoddyl
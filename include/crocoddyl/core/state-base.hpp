@@ -254,6 +254,15 @@ class StateAbstractTpl {
    */
   std::size_t get_nv() const;
 
+  /**
+   * @brief Return the number of leading directions of the tangent space that are not integrated as a vector space
+   *
+   * The integration of the remaining directions is Euclidean, i.e. `Jintegrate()` and `JintegrateTransport()` act as
+   * the identity on them. Integrators use it to advertise the block structure of their Jacobians. By default it is
+   * equal to `ndx`, i.e. no structure is assumed.
+   */
+  std::size_t get_ndx_lie() const;
+
   /**
    * @brief Return the state lower bound
    */
@@ -282,13 +291,14 @@ class StateAbstractTpl {
  protected:
   void update_has_limits();
 
-  std::size_t nx_;   //!< State dimension
-  std::size_t ndx_;  //!< State rate dimension
-  std::size_t nq_;   //!< Configuration dimension
-  std::size_t nv_;   //!< Velocity dimension
-  VectorXs lb_;      //!< Lower state limits
-  VectorXs ub_;      //!< Upper state limits
-  bool has_limits_;  //!< Indicates whether any of the state limits is finite
+  std::size_t nx_;       //!< State dimension
+  std::size_t ndx_;      //!< State rate dimension
+  std::size_t nq_;       //!< Configuration dimension
+  std::size_t nv_;       //!< Velocity dimension
+  std::size_t ndx_lie_;  //!< Number of leading directions of the tangent space that are not Euclidean
+  VectorXs lb_;          //!< Lower state limits
+  VectorXs ub_;          //!< Upper state limits
+  bool has_limits_;      //!< Indicates whether any of the state limits is finite
 };
 
 }  // namespace crocoddyl
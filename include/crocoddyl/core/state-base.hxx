@@ -12,6 +12,7 @@ template <typename Scalar>
 StateAbstractTpl<Scalar>::StateAbstractTpl(const std::size_t nx, const std::size_t ndx)
     : nx_(nx),
       ndx_(ndx),
+      ndx_lie_(ndx),
       lb_(VectorXs::Constant(nx_, -std::numeric_limits<Scalar>::infinity())),
       ub_(VectorXs::Constant(nx_, std::numeric_limits<Scalar>::infinity())),
       has_limits_(false) {
@@ -23,6 +24,7 @@ template <typename Scalar>
 StateAbstractTpl<Scalar>::StateAbstractTpl()
     : nx_(0),
       ndx_(0),
+      ndx_lie_(0),
       lb_(MathBase::VectorXs::Constant(nx_, -std::numeric_limits<Scalar>::infinity())),
       ub_(MathBase::VectorXs::Constant(nx_, std::numeric_limits<Scalar>::infinity())),
       has_limits_(false) {}
@@ -120,6 +122,11 @@ std::size_t StateAbstractTpl<Scalar>::get_nv() const {
   return nv_;
 }
 
+template <typename Scalar>
+std::size_t StateAbstractTpl<Scalar>::get_ndx_lie() const {
+  return ndx_lie_;
+}
+
 template <typename Scalar>
 const typename MathBaseTpl<Scalar>::VectorXs& StateAbstractTpl<Scalar>::get_lb() const {
   return lb_;
@@ -43,6 +43,7 @@ class StateVectorTpl : public StateAbstractTpl<_Scalar> {
  protected:
   using StateAbstractTpl<Scalar>::nx_;
   using StateAbstractTpl<Scalar>::ndx_;
+  using StateAbstractTpl<Scalar>::ndx_lie_;
   using StateAbstractTpl<Scalar>::nq_;
   using StateAbstractTpl<Scalar>::nv_;
   using StateAbstractTpl<Scalar>::lb_;
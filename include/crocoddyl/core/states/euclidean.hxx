@@ -9,7 +9,9 @@
 namespace crocoddyl {
 
 template <typename Scalar>
-StateVectorTpl<Scalar>::StateVectorTpl(const std::size_t nx) : StateAbstractTpl<Scalar>(nx, nx) {}
+StateVectorTpl<Scalar>::StateVectorTpl(const std::size_t nx) : StateAbstractTpl<Scalar>(nx, nx) {
+  ndx_lie_ = 0;
+}
 
 template <typename Scalar>
 StateVectorTpl<Scalar>::~StateVectorTpl() {}
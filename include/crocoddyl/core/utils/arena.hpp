@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CROCODDYL_CORE_UTILS_ARENA_HPP_
+#define CROCODDYL_CORE_UTILS_ARENA_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace crocoddyl {
+
+/**
+ * @brief Arena allocator of dense buffers
+ *
+ * It places a set of dense buffers (e.g. the per-node terms of a solver) in a single contiguous block. The buffers are
+ * first registered with `push()`, which returns their offset inside the block, and then the block is allocated once
+ * with `allocate()`. Each buffer starts at a cache-line boundary, so it can be mapped as an aligned Eigen object, and
+ * buffers written by different threads never share a cache line.
+ *
+ * The arena is not copyable, as the objects that map its buffers would still point to the original block.
+ */
+class MemoryArena {
+ public:
+  static const std::size_t alignment = 64;  //!< Alignment in bytes of each buffer
+
+  MemoryArena();
+  ~MemoryArena();
+
+  /**
+   * @brief Register a buffer of `rows x cols` scalars
+   *
+   * @param[in] rows  Number of rows
+   * @param[in] cols  Number of columns (default 1)
+   * @return Offset of the buffer in the block
+   */
+  std::size_t push(const std::size_t rows, const std::size_t cols = 1);
+
+  /**
+   * @brief Allocate the block of the registered buffers and set it to zero
+   */
+  void allocate();
+
+  /**
+   * @brief Place the registered buffers in an external block and set it to zero
+   *
+   * The block is owned by the caller, it has to contain `get_size()` bytes aligned to `alignment`, and it has to
+   * outlive the arena (or its next `clear()`). It allows to place several arenas in the buffers of another one.
+   *
+   * @param[in] block  Aligned start of the external block
+   */
+  void allocate(double* block);
+
+  /**
+   * @brief Release the block and the registered buffers
+   */
+  void clear();
+
+  /**
+   * @brief Return the address of the buffer at a given offset
+   *
+   * @param[in] offset  Offset returned by `push()`
+   */
+  double* get_data(const std::size_t offset);
+
+  /**
+   * @brief Return the size of the block in bytes
+   */
+  std::size_t get_size() const;
+
+ private:
+  MemoryArena(const MemoryArena&);
+  MemoryArena& operator=(const MemoryArena&);
+
+  std::vector<double> buffer_;  //!< Storage of the block (with room to align its start), empty for external blocks
+  double* data_;                //!< Aligned start of the block
+  std::size_t size_;            //!< Number of scalars of the registered buffers
+};
+
+}  // namespace crocoddyl
+
+#endif  // CROCODDYL_CORE_UTILS_ARENA_HPP_
@@ -13,6 +13,7 @@
 #include <iomanip>
 
 #include "crocoddyl/core/solver-base.hpp"
+#include "crocoddyl/core/utils/policy-buffer.hpp"
 
 namespace crocoddyl {
 
@@ -28,6 +29,35 @@ class CallbackVerbose : public CallbackAbstract {
   VerboseLevel level;
 };
 
+/**
+ * @brief Callback that publishes the feedback policy of a DDP-based solver
+ *
+ * After each iteration of the solver, it copies the first nodes of \f$\mathbf{x}_s\f$, \f$\mathbf{u}_s\f$ and
+ * \f$\mathbf{K}\f$ into a `PolicyBuffer`. The solver thread never blocks on the control thread that reads them, and
+ * the copies do not allocate memory. It can also be called directly, e.g. after the feedback phase of a real-time
+ * iteration.
+ */
+class CallbackPolicyPublisher : public CallbackAbstract {
+ public:
+  /**
+   * @brief Initialize the policy publisher
+   *
+   * @param[in] buffer  Buffer that receives the policies
+   */
+  explicit CallbackPolicyPublisher(boost::shared_ptr<PolicyBuffer> buffer);
+  ~CallbackPolicyPublisher();
+
+  virtual void operator()(SolverAbstract& solver);
+
+  /**
+   * @brief Return the buffer that receives the policies
+   */
+  const boost::shared_ptr<PolicyBuffer>& get_buffer() const;
+
+ private:
+  boost::shared_ptr<PolicyBuffer> buffer_;  //!< Buffer that receives the policies
+};
+
 }  // namespace crocoddyl
 
 #endif  // CROCODDYL_CORE_UTILS_CALLBACKS_HPP_
@@ -0,0 +1,240 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CROCODDYL_CORE_UTILS_INSTRUMENTATION_HPP_
+#define CROCODDYL_CORE_UTILS_INSTRUMENTATION_HPP_
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace crocoddyl {
+
+/**
+ * @brief Probes of the instrumentation layer
+ *
+ * Each probe measures the latency of a solver phase or of the model calls of a single node:
+ *  - ProbeCalcDiff: `calcDiff()` of the solver
+ *  - ProbeBackwardPass: backward pass of the solver
+ *  - ProbeForwardPass: rollout of a line-search trial
+ *  - ProbeComputeGains: computation of the gains of a node in the backward pass
+ *  - ProbeNodeCalc: `calc()` of a node run by the shooting problem
+ *  - ProbeNodeCalcDiff: `calcDiff()` of a node run by the shooting problem
+ *  - ProbeNodeCalcAndDiff: `calcAndDiff()` of a node run by the shooting problem
+ */
+enum ProbeType {
+  ProbeCalcDiff = 0,
+  ProbeBackwardPass,
+  ProbeForwardPass,
+  ProbeComputeGains,
+  ProbeNodeCalc,
+  ProbeNodeCalcDiff,
+  ProbeNodeCalcAndDiff,
+  NbProbeTypes
+};
+
+/**
+ * @brief Latency histogram with log-linear buckets
+ *
+ * As in HDR histograms, each power of two is split into `sub_buckets` linear buckets. It covers latencies from 1 ns
+ * to several hours with a constant relative resolution of 1 / `sub_buckets`, and it keeps the exact minimum and
+ * maximum values.
+ */
+class LatencyHistogram {
+ public:
+  static const std::size_t sub_bits = 5;                               //!< Number of bits of the sub-bucket index
+  static const std::size_t sub_buckets = 1 << sub_bits;                //!< Number of buckets per power of two
+  static const std::size_t magnitudes = 40;                            //!< Number of powers of two above 32 ns
+  static const std::size_t nbuckets = (magnitudes + 1) * sub_buckets;  //!< Number of buckets
+
+  LatencyHistogram();
+  ~LatencyHistogram();
+
+  /**
+   * @brief Record a latency
+   *
+   * @param[in] ns  Latency in nanoseconds
+   */
+  void record(const uint64_t ns);
+
+  /**
+   * @brief Add the records of another histogram
+   */
+  void merge(const LatencyHistogram& other);
+
+  /**
+   * @brief Remove all the records
+   */
+  void reset();
+
+  /**
+   * @brief Return the bucket of a latency
+   *
+   * @param[in] ns  Latency in nanoseconds
+   */
+  static std::size_t bucketIndex(const uint64_t ns);
+
+  /**
+   * @brief Return the highest latency (in nanoseconds) of a bucket
+   */
+  static uint64_t bucketUpperBound(const std::size_t i);
+
+  /**
+   * @brief Return the number of records
+   */
+  uint64_t get_count() const;
+
+  /**
+   * @brief Return the number of records of a bucket
+   */
+  uint64_t get_bucket(const std::size_t i) const;
+
+  /**
+   * @brief Return the minimum latency in microseconds
+   */
+  double get_min() const;
+
+  /**
+   * @brief Return the maximum latency in microseconds
+   */
+  double get_max() const;
+
+  /**
+   * @brief Return the mean latency in microseconds
+   */
+  double get_mean() const;
+
+  /**
+   * @brief Return the latency (in microseconds) below which a fraction of the records lies
+   *
+   * The value is the upper bound of the bucket that contains the percentile, and it never exceeds the maximum.
+   *
+   * @param[in] p  Fraction of the records, in [0, 1]
+   */
+  double get_percentile(const double p) const;
+
+ private:
+  friend class Instrumentation;
+
+  std::vector<uint64_t> counts_;  //!< Number of records per bucket
+  uint64_t count_;                //!< Number of records
+  uint64_t sum_;                  //!< Sum of the latencies in nanoseconds
+  uint64_t min_;                  //!< Minimum latency in nanoseconds
+  uint64_t max_;                  //!< Maximum latency in nanoseconds
+};
+
+/**
+ * @brief Runtime-switchable latency instrumentation of the solvers
+ *
+ * Unlike the `START_PROFILER`/`STOP_PROFILER` macros, the probes are identified by a static `ProbeType`, and each
+ * thread records into its own histograms. Therefore recording a latency does not lock, hash strings nor allocate
+ * memory (besides the first record of a thread), and a disabled probe only costs the load of an atomic flag. This
+ * makes it suitable to remain compiled in production code and be enabled to chase tail latencies.
+ *
+ * The histograms of all the threads are merged when they are retrieved, which can be done while the solver runs.
+ * The shared instance is obtained with `getInstrumentation()`.
+ *
+ * \sa `InstrumentationProbe`
+ */
+class Instrumentation {
+ public:
+  Instrumentation();
+  ~Instrumentation();
+
+  /**
+   * @brief Record a latency of a probe in the histogram of the current thread
+   *
+   * @param[in] probe  Probe type
+   * @param[in] ns     Latency in nanoseconds
+   */
+  void record(const ProbeType probe, const uint64_t ns);
+
+  /**
+   * @brief Remove the records of all the threads
+   */
+  void reset();
+
+  /**
+   * @brief Print the count, mean, percentiles and maximum latency of the probes with records
+   */
+  void report(std::ostream& os = std::cout) const;
+
+  /**
+   * @brief Return the histogram of a probe merged over all the threads
+   */
+  LatencyHistogram get_histogram(const ProbeType probe) const;
+
+  /**
+   * @brief Return the name of a probe
+   */
+  static const char* get_name(const ProbeType probe);
+
+  /**
+   * @brief Return true if the probes are enabled
+   */
+  static bool get_enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Enable or disable the probes
+   */
+  static void set_enabled(const bool enabled);
+
+ private:
+  Instrumentation(const Instrumentation&);
+  Instrumentation& operator=(const Instrumentation&);
+
+  struct ThreadRecords;
+  ThreadRecords* get_thread_records();
+
+  static std::atomic<bool> enabled_;     //!< True if the probes are enabled
+  std::size_t id_;                       //!< Unique identifier of the instrumentation
+  mutable std::mutex mutex_;             //!< Mutex of the registry of threads
+  std::vector<ThreadRecords*> records_;  //!< Records of each thread that used a probe
+};
+
+Instrumentation& getInstrumentation();
+
+/**
+ * @brief Scoped probe that records the latency of its lifetime
+ *
+ * It does nothing if the instrumentation was disabled when the probe was created.
+ */
+class InstrumentationProbe {
+ public:
+  typedef std::chrono::steady_clock clock;
+
+  explicit InstrumentationProbe(const ProbeType probe) : probe_(probe), active_(Instrumentation::get_enabled()) {
+    if (active_) {
+      start_ = clock::now();
+    }
+  }
+
+  ~InstrumentationProbe() {
+    if (active_) {
+      const clock::duration duration = clock::now() - start_;
+      getInstrumentation().record(
+          probe_, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+    }
+  }
+
+ private:
+  InstrumentationProbe(const InstrumentationProbe&);
+  InstrumentationProbe& operator=(const InstrumentationProbe&);
+
+  ProbeType probe_;          //!< Probe type
+  bool active_;              //!< True if the probe records its latency
+  clock::time_point start_;  //!< Creation time of the probe
+};
+
+}  // namespace crocoddyl
+
+#endif  // CROCODDYL_CORE_UTILS_INSTRUMENTATION_HPP_
@@ -0,0 +1,128 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CROCODDYL_CORE_UTILS_POLICY_BUFFER_HPP_
+#define CROCODDYL_CORE_UTILS_POLICY_BUFFER_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "crocoddyl/core/mathbase.hpp"
+
+namespace crocoddyl {
+
+/**
+ * @brief Feedback policy of the first nodes of the horizon
+ *
+ * The control of the node \f$t\f$ is \f$\mathbf{u}_t = \mathbf{u}_{s,t} - \mathbf{K}_t(\mathbf{x}\ominus
+ * \mathbf{x}_{s,t})\f$, as in the forward pass of the DDP-based solvers.
+ */
+struct Policy {
+  typedef MathBaseTpl<double>::MatrixXsRowMajor MatrixXdRowMajor;
+
+  /**
+   * @brief Initialize the policy
+   *
+   * @param[in] nodes  Number of nodes
+   * @param[in] nx     Dimension of the state
+   * @param[in] ndx    Dimension of the tangent space of the state manifold
+   * @param[in] nu     Dimension of the control
+   */
+  Policy(const std::size_t nodes, const std::size_t nx, const std::size_t ndx, const std::size_t nu);
+
+  /**
+   * @brief Compute the control of a node given the deviation from its state
+   *
+   * @param[in]  t   Node index
+   * @param[in]  dx  Deviation \f$\mathbf{x}\ominus\mathbf{x}_{s,t}\f$
+   * @param[out] u   Control
+   */
+  void computeControl(const std::size_t t, const Eigen::Ref<const Eigen::VectorXd>& dx, Eigen::VectorXd& u) const;
+
+  std::vector<Eigen::VectorXd> xs;  //!< State trajectory
+  std::vector<Eigen::VectorXd> us;  //!< Control trajectory
+  std::vector<MatrixXdRowMajor> K;  //!< Feedback gains
+  std::size_t iter;                 //!< Iteration of the solver that produced the policy
+  std::size_t sequence;             //!< Number of the publication (0 if nothing has been published)
+  double timestamp;                 //!< Time of the publication in seconds (monotonic clock)
+};
+
+/**
+ * @brief Lock-free triple buffer of feedback policies
+ *
+ * It transfers the latest policy from the solver thread (writer) to a control thread (reader). The writer fills the
+ * policy returned by `get_back()` and then calls `publish()`, while the reader obtains the latest published policy
+ * with `read()`. The three policies are allocated once, and both sides only exchange their indices through an atomic
+ * variable. Therefore the writer never blocks, and the reader gets wait-free access to a consistent policy that is
+ * not modified until its next `read()`.
+ *
+ * The buffer supports a single writer and a single reader thread.
+ *
+ * \sa `CallbackPolicyPublisher`
+ */
+class PolicyBuffer {
+ public:
+  /**
+   * @brief Initialize the buffer
+   *
+   * @param[in] nodes  Number of nodes of the policy
+   * @param[in] nx     Dimension of the state
+   * @param[in] ndx    Dimension of the tangent space of the state manifold
+   * @param[in] nu     Dimension of the control
+   */
+  PolicyBuffer(const std::size_t nodes, const std::size_t nx, const std::size_t ndx, const std::size_t nu);
+  ~PolicyBuffer();
+
+  /**
+   * @brief Return the policy that is filled by the writer
+   */
+  Policy& get_back();
+
+  /**
+   * @brief Publish the policy filled by the writer, which then receives a new policy to fill
+   *
+   * @param[in] iter  Iteration of the solver that produced the policy
+   */
+  void publish(const std::size_t iter);
+
+  /**
+   * @brief Return the latest published policy
+   *
+   * The returned policy is owned by the reader until its next call, so it is safe to access it meanwhile.
+   */
+  const Policy& read();
+
+  /**
+   * @brief Return true if a policy was published after the last `read()`
+   */
+  bool has_update() const;
+
+  /**
+   * @brief Return the number of nodes of the policy
+   */
+  std::size_t get_nodes() const;
+
+ private:
+  PolicyBuffer(const PolicyBuffer&);
+  PolicyBuffer& operator=(const PolicyBuffer&);
+
+  static const unsigned char fresh = 4;  //!< Flag of the middle index that indicates an unread policy
+  static const unsigned char index = 3;  //!< Mask of the policy index
+
+  std::size_t nodes_;                  //!< Number of nodes of the policy
+  std::vector<Policy> policies_;       //!< Storage of the three policies
+  std::atomic<unsigned char> middle_;  //!< Index of the policy exchanged between writer and reader
+  unsigned char back_;                 //!< Index of the policy owned by the writer
+  unsigned char front_;                //!< Index of the policy owned by the reader
+  std::size_t sequence_;               //!< Number of publications
+};
+
+}  // namespace crocoddyl
+
+#endif  // CROCODDYL_CORE_UTILS_POLICY_BUFFER_HPP_
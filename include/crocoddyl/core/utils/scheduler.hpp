@@ -0,0 +1,219 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CROCODDYL_CORE_UTILS_SCHEDULER_HPP_
+#define CROCODDYL_CORE_UTILS_SCHEDULER_HPP_
+
+#include <cstddef>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace crocoddyl {
+
+/**
+ * @brief Abstract class for task schedulers
+ *
+ * A scheduler distributes the iterations of a parallel loop (e.g. the nodes of a shooting problem) among a number of
+ * threads. It decouples the parallel sections of Crocoddyl from a specific threading runtime, which allows us to run
+ * them with OpenMP, with the built-in work-stealing pool, or inside the thread pool of the host application. The
+ * number of threads is a runtime value, `CROCODDYL_WITH_NTHREADS` only defines its default.
+ *
+ * The loop body is called once per index and in any order. Therefore each iteration has to write only on its own
+ * data, which keeps the results independent of the scheduling. If an iteration throws an exception, then
+ * `parallelFor()` rethrows it once the running iterations have finished (the pending ones might be skipped).
+ *
+ * \sa `parallelFor()`, `set_nthreads()`
+ */
+class SchedulerAbstract {
+ public:
+  typedef boost::function<void(const std::size_t)> TaskFunction;
+
+  /**
+   * @brief Initialize the scheduler
+   *
+   * @param[in] nthreads  Number of threads (it has to be positive)
+   */
+  explicit SchedulerAbstract(const std::size_t nthreads = 1);
+  virtual ~SchedulerAbstract();
+
+  /**
+   * @brief Run the task for every index in \f$[0, n)\f$ and wait until all of them are completed
+   *
+   * @param[in] n     Number of iterations
+   * @param[in] task  Loop body that receives the iteration index
+   */
+  virtual void parallelFor(const std::size_t n, const TaskFunction& task) = 0;
+
+  /**
+   * @brief Return the number of threads
+   */
+  std::size_t get_nthreads() const;
+
+  /**
+   * @brief Modify the number of threads
+   *
+   * @param[in] nthreads  Number of threads (it has to be positive)
+   */
+  virtual void set_nthreads(const std::size_t nthreads);
+
+ protected:
+  std::size_t nthreads_;  //!< Number of threads used by the parallel loops
+};
+
+/**
+ * @brief OpenMP scheduler
+ *
+ * It runs the loops with `#pragma omp parallel for`, which is the default scheduler when Crocoddyl is built with
+ * multithreading support. Without it, the loops run serially. Thread pinning is handled by the OpenMP runtime (e.g.
+ * through the `OMP_PROC_BIND` and `OMP_PLACES` environment variables).
+ */
+class SchedulerOpenMP : public SchedulerAbstract {
+ public:
+  /**
+   * @brief Initialize the OpenMP scheduler
+   *
+   * @param[in] nthreads  Number of threads (default `CROCODDYL_WITH_NTHREADS`)
+   */
+  explicit SchedulerOpenMP(const std::size_t nthreads = getDefaultNumThreads());
+  virtual ~SchedulerOpenMP();
+
+  virtual void parallelFor(const std::size_t n, const TaskFunction& task);
+  virtual void set_nthreads(const std::size_t nthreads);
+
+  /**
+   * @brief Return the default number of threads, i.e., `CROCODDYL_WITH_NTHREADS` or 1 without multithreading
+   */
+  static std::size_t getDefaultNumThreads();
+};
+
+/**
+ * @brief Work-stealing thread pool
+ *
+ * The pool keeps `nthreads - 1` worker threads alive; the calling thread takes part in the loop as the first worker.
+ * The iterations are split into one contiguous range per thread. Each thread consumes its own range from the front,
+ * and once it is empty, it steals the back half of the largest remaining range, so the threads that run cheaper
+ * iterations (e.g. impulse nodes) take over part of the range of the others. OpenMP is still the default scheduler,
+ * since the benefit depends on the machine and the problem: the quadruped and biped benchmarks compare both of them.
+ *
+ * The workers can be pinned to specific cores through `set_affinity()` (only supported in Linux). Loops launched from
+ * inside a task (e.g. by a problem solved within another parallel loop) run serially in the calling thread.
+ */
+class SchedulerThreadPool : public SchedulerAbstract {
+ public:
+  /**
+   * @brief Initialize the thread pool
+   *
+   * @param[in] nthreads  Number of threads, including the calling one (default hardware concurrency)
+   */
+  explicit SchedulerThreadPool(const std::size_t nthreads = getDefaultNumThreads());
+  virtual ~SchedulerThreadPool();
+
+  virtual void parallelFor(const std::size_t n, const TaskFunction& task);
+
+  /**
+   * @brief Modify the number of threads
+   *
+   * It stops the current workers and launches the new ones, so it should not be called at every iteration.
+   *
+   * @param[in] nthreads  Number of threads, including the calling one
+   */
+  virtual void set_nthreads(const std::size_t nthreads);
+
+  /**
+   * @brief Return the cores in which the workers are pinned
+   */
+  const std::vector<std::size_t>& get_affinity() const;
+
+  /**
+   * @brief Pin the workers to a set of cores
+   *
+   * The i-th worker is pinned to `cores[i % cores.size()]`, while the calling thread is never pinned. An empty list
+   * disables the pinning. Note that it relaunches the workers.
+   *
+   * @param[in] cores  List of core ids
+   */
+  void set_affinity(const std::vector<std::size_t>& cores);
+
+  /**
+   * @brief Return the default number of threads, i.e., the hardware concurrency
+   */
+  static std::size_t getDefaultNumThreads();
+
+ private:
+  struct WorkRange {
+    std::mutex mutex;   //!< Mutex that protects the range
+    std::size_t begin;  //!< First pending iteration
+    std::size_t end;    //!< End of the pending iterations
+  };
+
+  void startWorkers();
+  void stopWorkers();
+  void pinWorker(const std::size_t i);
+  void workerLoop(const std::size_t id, std::size_t generation);
+  void runTasks(const std::size_t id);
+  bool popTask(const std::size_t id, std::size_t& i);
+  bool stealTasks(const std::size_t id);
+
+  std::vector<std::thread> workers_;                   //!< Worker threads
+  std::vector<boost::shared_ptr<WorkRange> > ranges_;  //!< Pending iterations per thread
+  std::vector<std::size_t> affinity_;                  //!< Cores of the workers
+  std::mutex mutex_;                                   //!< Mutex that protects the pool state
+  std::mutex call_mutex_;                              //!< Mutex that serializes concurrent loops
+  std::condition_variable start_cv_;                   //!< Signals a new loop to the workers
+  std::condition_variable done_cv_;                    //!< Signals the end of the workers' tasks
+  const TaskFunction* task_;                           //!< Loop body of the current loop
+  std::size_t generation_;                             //!< Counter of launched loops
+  std::size_t pending_;                                //!< Number of workers still running the current loop
+  bool stop_;                                          //!< True if the workers have to finish
+  std::exception_ptr error_;                           //!< First exception thrown by the current loop
+};
+
+/**
+ * @brief Scheduler based on a user-supplied executor
+ *
+ * It allows us to run the parallel loops inside the thread pool of the host application, avoiding the
+ * oversubscription produced by a second threading runtime. The loop is split into `nthreads` contiguous chunks, and
+ * the executor receives the number of chunks and the function that runs a chunk. The executor has to call this
+ * function once per chunk index (from any thread and in any order), and it can return only when all of them are
+ * completed.
+ */
+class SchedulerExecutor : public SchedulerAbstract {
+ public:
+  typedef boost::function<void(const std::size_t, const TaskFunction&)> ExecutorFunction;
+
+  /**
+   * @brief Initialize the executor scheduler
+   *
+   * @param[in] executor  Function that runs a batch of tasks and waits for them
+   * @param[in] nthreads  Number of chunks in which the loops are split
+   */
+  SchedulerExecutor(ExecutorFunction executor, const std::size_t nthreads);
+  virtual ~SchedulerExecutor();
+
+  virtual void parallelFor(const std::size_t n, const TaskFunction& task);
+
+ private:
+  ExecutorFunction executor_;  //!< User-supplied executor
+};
+
+/**
+ * @brief Create the default scheduler
+ *
+ * It returns an OpenMP scheduler if Crocoddyl is built with multithreading support, otherwise a thread pool with a
+ * single thread (i.e. no worker is launched until the number of threads is increased).
+ */
+boost::shared_ptr<SchedulerAbstract> createDefaultScheduler();
+
+}  // namespace crocoddyl
+
+#endif  // CROCODDYL_CORE_UTILS_SCHEDULER_HPP_
@@ -50,6 +50,15 @@ class DifferentialActionModelFreeFwdDynamicsTpl : public DifferentialActionModel
                     const Eigen::Ref<const VectorXs>& u);
   virtual void calcDiff(const boost::shared_ptr<DifferentialActionDataAbstract>& data,
                         const Eigen::Ref<const VectorXs>& x, const Eigen::Ref<const VectorXs>& u);
+
+  /**
+   * @brief Compute the system acceleration, cost value and their derivatives
+   *
+   * Without armature, the derivatives of the articulated-body algorithm also provide the acceleration, so the
+   * forward dynamics are not computed twice.
+   */
+  virtual void calcAndDiff(const boost::shared_ptr<DifferentialActionDataAbstract>& data,
+                           const Eigen::Ref<const VectorXs>& x, const Eigen::Ref<const VectorXs>& u);
   virtual boost::shared_ptr<DifferentialActionDataAbstract> createData();
   virtual bool checkData(const boost::shared_ptr<DifferentialActionDataAbstract>& data);
 
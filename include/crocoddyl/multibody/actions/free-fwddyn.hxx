@@ -119,6 +119,49 @@ void DifferentialActionModelFreeFwdDynamicsTpl<Scalar>::calcDiff(
   costs_->calcDiff(d->costs, x, u);
 }
 
+template <typename Scalar>
+void DifferentialActionModelFreeFwdDynamicsTpl<Scalar>::calcAndDiff(
+    const boost::shared_ptr<DifferentialActionDataAbstract>& data, const Eigen::Ref<const VectorXs>& x,
+    const Eigen::Ref<const VectorXs>& u) {
+  if (!without_armature_) {
+    calc(data, x, u);
+    calcDiff(data, x, u);
+    return;
+  }
+  if (static_cast<std::size_t>(x.size()) != state_->get_nx()) {
+    throw_pretty("Invalid argument: "
+                 << "x has wrong dimension (it should be " + std::to_string(state_->get_nx()) + ")");
+  }
+  if (static_cast<std::size_t>(u.size()) != nu_) {
+    throw_pretty("Invalid argument: "
+                 << "u has wrong dimension (it should be " + std::to_string(nu_) + ")");
+  }
+
+  const std::size_t nv = state_->get_nv();
+  const Eigen::VectorBlock<const Eigen::Ref<const VectorXs>, Eigen::Dynamic> q = x.head(state_->get_nq());
+  const Eigen::VectorBlock<const Eigen::Ref<const VectorXs>, Eigen::Dynamic> v = x.tail(nv);
+
+  Data* d = static_cast<Data*>(data.get());
+
+  actuation_->calc(d->multibody.actuation, x, u);
+  actuation_->calcDiff(d->multibody.actuation, x, u);
+
+  // Computing the dynamics and its derivatives, the ABA derivatives also compute the acceleration
+  pinocchio::computeABADerivatives(pinocchio_, d->pinocchio, q, v, d->multibody.actuation->tau, d->Fx.leftCols(nv),
+                                   d->Fx.rightCols(nv), d->pinocchio.Minv);
+  d->xout = d->pinocchio.ddq;
+  d->Fx.noalias() += d->pinocchio.Minv * d->multibody.actuation->dtau_dx;
+  d->Fu.noalias() = d->pinocchio.Minv * d->multibody.actuation->dtau_du;
+
+  // Updating the local kinematics used by the costs, which are expressed in the world frame by the ABA derivatives
+  pinocchio::forwardKinematics(pinocchio_, d->pinocchio, q, v, d->xout);
+
+  // Computing the cost value, residuals and their derivatives
+  costs_->calc(d->costs, x, u);
+  d->cost = d->costs->cost;
+  costs_->calcDiff(d->costs, x, u);
+}
+
 template <typename Scalar>
 boost::shared_ptr<DifferentialActionDataAbstractTpl<Scalar> >
 DifferentialActionModelFreeFwdDynamicsTpl<Scalar>::createData() {
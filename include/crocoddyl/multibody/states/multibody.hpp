@@ -84,6 +84,7 @@ class StateMultibodyTpl : public StateAbstractTpl<_Scalar> {
   using Base::has_limits_;
   using Base::lb_;
   using Base::ndx_;
+  using Base::ndx_lie_;
   using Base::nq_;
   using Base::nv_;
   using Base::nx_;
@@ -33,6 +33,14 @@ StateMultibodyTpl<Scalar>::StateMultibodyTpl(boost::shared_ptr<PinocchioModel> m
   lb_.tail(nv_) = -pinocchio_->velocityLimit;
   ub_.tail(nv_) = pinocchio_->velocityLimit;
   Base::update_has_limits();
+
+  // The Lie-group directions finish at the last joint whose configuration is not Euclidean, i.e. nq != nv
+  ndx_lie_ = 0;
+  for (std::size_t i = 1; i < model->joints.size(); ++i) {
+    if (model->nqs[i] != model->nvs[i]) {
+      ndx_lie_ = static_cast<std::size_t>(model->idx_vs[i] + model->nvs[i]);
+    }
+  }
 }
 
 template <typename Scalar>
@@ -6,6 +6,8 @@
 // All rights reserved.
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include "crocoddyl/core/utils/exception.hpp"
 #include "crocoddyl/core/solver-base.hpp"
 
@@ -90,6 +92,20 @@ void SolverAbstract::setCandidate(const std::vector<Eigen::VectorXd>& xs_warm,
   is_feasible_ = is_feasible;
 }
 
+void SolverAbstract::shiftWarmStart() {
+  const std::size_t T = problem_->get_T();
+  if (T == 0) {
+    return;
+  }
+  std::rotate(xs_.begin(), xs_.begin() + 1, xs_.end());
+  std::rotate(us_.begin(), us_.begin() + 1, us_.end());
+  xs_[T] = xs_[T - 1];
+  if (T > 1) {
+    us_[T - 1] = us_[T - 2];
+  }
+  is_feasible_ = false;
+}
+
 void SolverAbstract::setCallbacks(const std::vector<boost::shared_ptr<CallbackAbstract> >& callbacks) {
   callbacks_ = callbacks;
 }
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "crocoddyl/core/solvers/batch.hpp"
+#include "crocoddyl/core/solvers/fddp.hpp"
+#include "crocoddyl/core/utils/exception.hpp"
+
+namespace crocoddyl {
+
+SolverBatch::SolverBatch(boost::shared_ptr<ShootingProblem> problem, const std::size_t nbatch,
+                         SolverCreator creator)
+    : problem_(problem), nbatch_(nbatch), converged_(nbatch, false) {
+  if (nbatch == 0) {
+    throw_pretty("Invalid argument: "
+                 << "nbatch has to be positive");
+  }
+  if (!creator) {
+    throw_pretty("Invalid argument: "
+                 << "the solver creator is empty");
+  }
+  problems_.reserve(nbatch_);
+  solvers_.reserve(nbatch_);
+  for (std::size_t k = 0; k < nbatch_; ++k) {
+    boost::shared_ptr<ShootingProblem> instance = boost::make_shared<ShootingProblem>(
+        problem_->get_x0(), problem_->get_runningModels(), problem_->get_terminalModel());
+    instance->set_scheduler(boost::make_shared<SchedulerThreadPool>(1));
+    problems_.push_back(instance);
+    solvers_.push_back(creator(instance));
+  }
+
+  // Lay out the workspaces of the DDP-based solvers contiguously, one instance after the other
+  std::vector<std::size_t> offsets(nbatch_);
+  for (std::size_t k = 0; k < nbatch_; ++k) {
+    SolverDDP* ddp = dynamic_cast<SolverDDP*>(solvers_[k].get());
+    if (ddp != NULL) {
+      offsets[k] = workspace_.push(ddp->get_workspace_size() / sizeof(double));
+    }
+  }
+  workspace_.allocate();
+  for (std::size_t k = 0; k < nbatch_; ++k) {
+    SolverDDP* ddp = dynamic_cast<SolverDDP*>(solvers_[k].get());
+    if (ddp != NULL) {
+      ddp->set_workspace(workspace_.get_data(offsets[k]));
+    }
+  }
+}
+
+SolverBatch::~SolverBatch() {
+  for (std::size_t k = 0; k < nbatch_; ++k) {
+    SolverDDP* ddp = dynamic_cast<SolverDDP*>(solvers_[k].get());
+    if (ddp != NULL && solvers_[k].use_count() > 1) {
+      ddp->set_workspace(NULL);
+    }
+  }
+}
+
+bool SolverBatch::solve(const std::vector<Eigen::VectorXd>& x0s,
+                        const std::vector<std::vector<Eigen::VectorXd> >& init_xs,
+                        const std::vector<std::vector<Eigen::VectorXd> >& init_us, const std::size_t maxiter,
+                        const bool is_feasible, const double reg_init) {
+  if (!x0s.empty() && x0s.size() != nbatch_) {
+    throw_pretty("Invalid argument: "
+                 << "x0s has wrong dimension (it should be " + std::to_string(nbatch_) + ")");
+  }
+  if (!init_xs.empty() && init_xs.size() != nbatch_) {
+    throw_pretty("Invalid argument: "
+                 << "init_xs has wrong dimension (it should be " + std::to_string(nbatch_) + ")");
+  }
+  if (!init_us.empty() && init_us.size() != nbatch_) {
+    throw_pretty("Invalid argument: "
+                 << "init_us has wrong dimension (it should be " + std::to_string(nbatch_) + ")");
+  }
+  for (std::size_t k = 0; k < x0s.size(); ++k) {
+    problems_[k]->set_x0(x0s[k]);
+  }
+
+  problem_->get_scheduler()->parallelFor(nbatch_, [&](const std::size_t k) {
+    converged_[k] = solvers_[k]->solve(init_xs.empty() ? DEFAULT_VECTOR : init_xs[k],
+                                       init_us.empty() ? DEFAULT_VECTOR : init_us[k], maxiter, is_feasible, reg_init);
+  });
+  return get_nconverged() == nbatch_;
+}
+
+const boost::shared_ptr<ShootingProblem>& SolverBatch::get_problem() const { return problem_; }
+
+std::size_t SolverBatch::get_nbatch() const { return nbatch_; }
+
+const std::vector<boost::shared_ptr<ShootingProblem> >& SolverBatch::get_problems() const { return problems_; }
+
+const std::vector<boost::shared_ptr<SolverAbstract> >& SolverBatch::get_solvers() const { return solvers_; }
+
+std::vector<bool> SolverBatch::get_converged() const {
+  return std::vector<bool>(converged_.begin(), converged_.end());
+}
+
+std::size_t SolverBatch::get_nconverged() const {
+  std::size_t nconverged = 0;
+  for (std::size_t k = 0; k < nbatch_; ++k) {
+    if (converged_[k]) {
+      ++nconverged;
+    }
+  }
+  return nconverged;
+}
+
+boost::shared_ptr<SolverAbstract> SolverBatch::createSolverFDDP(boost::shared_ptr<ShootingProblem> problem) {
+  return boost::make_shared<SolverFDDP>(problem);
+}
+
+}  // namespace crocoddyl
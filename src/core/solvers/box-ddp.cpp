@@ -44,6 +44,8 @@ void SolverBoxDDP::allocateData() {
   du_ub_.resize(nu);
 }
 
+void SolverBoxDDP::backwardPass() { backwardPassSerial(); }
+
 void SolverBoxDDP::computeGains(const std::size_t t) {
   const std::size_t nu = problem_->get_runningModels()[t]->get_nu();
   if (nu > 0) {
@@ -77,56 +79,65 @@ void SolverBoxDDP::computeGains(const std::size_t t) {
   }
 }
 
-void SolverBoxDDP::forwardPass(double steplength) {
+void SolverBoxDDP::forwardPass(const double steplength) {
   if (steplength > 1. || steplength < 0.) {
     throw_pretty("Invalid argument: "
                  << "invalid step length, value is between 0. to 1.");
   }
-  cost_try_ = 0.;
-  xnext_ = problem_->get_x0();
+  cost_try_ = computeRollout(steplength, problem_->get_runningDatas(), problem_->get_terminalData(), xs_try_, us_try_,
+                             dx_, xnext_);
+}
+
+double SolverBoxDDP::computeRollout(const double steplength,
+                                    const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas,
+                                    const boost::shared_ptr<ActionDataAbstract>& data_T,
+                                    std::vector<Eigen::VectorXd>& xs_try, std::vector<Eigen::VectorXd>& us_try,
+                                    std::vector<Eigen::VectorXd>& dx, Eigen::VectorXd& xnext) {
+  double cost_try = 0.;
+  xnext = problem_->get_x0();
   const std::size_t T = problem_->get_T();
   const std::vector<boost::shared_ptr<ActionModelAbstract> >& models = problem_->get_runningModels();
-  const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas = problem_->get_runningDatas();
   for (std::size_t t = 0; t < T; ++t) {
     const boost::shared_ptr<ActionModelAbstract>& m = models[t];
     const boost::shared_ptr<ActionDataAbstract>& d = datas[t];
     const std::size_t nu = m->get_nu();
 
-    xs_try_[t] = xnext_;
-    m->get_state()->diff(xs_[t], xs_try_[t], dx_[t]);
+    xs_try[t] = xnext;
+    m->get_state()->diff(xs_[t], xs_try[t], dx[t]);
     if (nu != 0) {
-      us_try_[t].head(nu).noalias() = us_[t].head(nu) - k_[t].head(nu) * steplength - K_[t].topRows(nu) * dx_[t];
+      us_try[t].head(nu).noalias() = us_[t].head(nu) - k_[t].head(nu) * steplength - K_[t].topRows(nu) * dx[t];
       if (m->get_has_control_limits()) {  // clamp control
-        us_try_[t].head(nu) = us_try_[t].head(nu).cwiseMax(m->get_u_lb()).cwiseMin(m->get_u_ub());
+        us_try[t].head(nu) = us_try[t].head(nu).cwiseMax(m->get_u_lb()).cwiseMin(m->get_u_ub());
       }
-      m->calc(d, xs_try_[t], us_try_[t].head(nu));
+      m->calc(d, xs_try[t], us_try[t].head(nu));
     } else {
-      m->calc(d, xs_try_[t]);
+      m->calc(d, xs_try[t]);
     }
-    xnext_ = d->xnext;
-    cost_try_ += d->cost;
+    xnext = d->xnext;
+    cost_try += d->cost;
 
-    if (raiseIfNaN(cost_try_)) {
+    if (raiseIfNaN(cost_try)) {
       throw_pretty("forward_error");
     }
-    if (raiseIfNaN(xnext_.lpNorm<Eigen::Infinity>())) {
+    if (raiseIfNaN(xnext.lpNorm<Eigen::Infinity>())) {
       throw_pretty("forward_error");
     }
+    notifyRolloutNode(t);
   }
 
   const boost::shared_ptr<ActionModelAbstract>& m = problem_->get_terminalModel();
-  const boost::shared_ptr<ActionDataAbstract>& d = problem_->get_terminalData();
   if ((is_feasible_) || (steplength == 1)) {
-    xs_try_.back() = xnext_;
+    xs_try.back() = xnext;
   } else {
-    m->get_state()->integrate(xnext_, fs_.back() * (steplength - 1), xs_try_.back());
+    m->get_state()->integrate(xnext, fs_.back() * (steplength - 1), xs_try.back());
   }
-  m->calc(d, xs_try_.back());
-  cost_try_ += d->cost;
+  m->calc(data_T, xs_try.back());
+  cost_try += data_T->cost;
 
-  if (raiseIfNaN(cost_try_)) {
+  if (raiseIfNaN(cost_try)) {
     throw_pretty("forward_error");
   }
+  return cost_try;
 }
 
 const std::vector<Eigen::MatrixXd>& SolverBoxDDP::get_Quu_inv() const { return Quu_inv_; }
@@ -7,16 +7,34 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <iostream>
-#ifdef CROCODDYL_WITH_MULTITHREADING
-#include <omp.h>
-#endif  // CROCODDYL_WITH_MULTITHREADING
+#include <algorithm>
+#include <new>
 
 #include "crocoddyl/core/solvers/ddp.hpp"
 #include "crocoddyl/core/utils/exception.hpp"
+#include "crocoddyl/core/utils/instrumentation.hpp"
 #include "crocoddyl/core/utils/stop-watch.hpp"
 
 namespace crocoddyl {
 
+namespace {
+// Rotate the first n maps one position towards the beginning by rebinding them, so no coefficient is copied
+template <typename Map>
+void rotateMaps(std::vector<Map>& maps, const std::size_t n) {
+  if (n < 2) {
+    return;
+  }
+  double* const front = maps[0].data();
+  const Eigen::Index rows = maps[0].rows();
+  const Eigen::Index cols = maps[0].cols();
+  for (std::size_t t = 0; t < n - 1; ++t) {
+    new (&maps[t]) Map(maps[t + 1].data(), maps[t + 1].rows(), maps[t + 1].cols());
+  }
+  new (&maps[n - 1]) Map(front, rows, cols);
+}
+
+}  // namespace
+
 SolverDDP::SolverDDP(boost::shared_ptr<ShootingProblem> problem)
     : SolverAbstract(problem),
       reg_incfactor_(10.),
@@ -24,11 +42,30 @@ SolverDDP::SolverDDP(boost::shared_ptr<ShootingProblem> problem)
       reg_min_(1e-9),
       reg_max_(1e9),
       cost_try_(0.),
+      workspace_block_(NULL),
+      workspace_block_size_(0),
       th_grad_(1e-12),
       th_gaptol_(1e-16),
       th_stepdec_(0.5),
       th_stepinc_(0.01),
-      was_feasible_(false) {
+      was_feasible_(false),
+      backward_type_(BackwardPassSerial),
+      linesearch_type_(LineSearchSerial),
+      fixed_size_(false),
+      structured_(true),
+      calc_outdated_(false),
+      speculative_(false),
+      spec_available_(false),
+      spec_rollout_(false),
+      spec_nodes_(0),
+      spec_waiting_(0),
+      fixed_node_(NULL),
+      fixed_gains_(NULL),
+      fixed_nu_(0),
+      warm_start_policy_(false),
+      shifted_(false),
+      warm_rollout_(false),
+      rti_prepared_(false) {
   allocateData();
 
   const std::size_t n_alphas = 10;
@@ -50,12 +87,14 @@ bool SolverDDP::solve(const std::vector<Eigen::VectorXd>& init_xs, const std::ve
   xs_try_[0] = problem_->get_x0();  // it is needed in case that init_xs[0] is infeasible
   setCandidate(init_xs, init_us, is_feasible);
 
-  if (std::isnan(reginit)) {
-    xreg_ = reg_min_;
-    ureg_ = reg_min_;
-  } else {
-    xreg_ = reginit;
-    ureg_ = reginit;
+  if (!applyWarmStart()) {
+    if (std::isnan(reginit)) {
+      xreg_ = reg_min_;
+      ureg_ = reg_min_;
+    } else {
+      xreg_ = reginit;
+      ureg_ = reginit;
+    }
   }
   was_feasible_ = false;
 
@@ -79,11 +118,11 @@ bool SolverDDP::solve(const std::vector<Eigen::VectorXd>& init_xs, const std::ve
 
     // We need to recalculate the derivatives when the step length passes
     recalcDiff = false;
-    for (std::vector<double>::const_iterator it = alphas_.begin(); it != alphas_.end(); ++it) {
-      steplength_ = *it;
+    for (std::size_t i = 0; i < alphas_.size(); ++i) {
+      steplength_ = alphas_[i];
 
       try {
-        dV_ = tryStep(steplength_);
+        dV_ = tryLineSearchStep(i);
       } catch (std::exception& e) {
         continue;
       }
@@ -129,12 +168,20 @@ void SolverDDP::computeDirection(const bool recalcDiff) {
   if (recalcDiff) {
     calcDiff();
   }
-  backwardPass();
+  {
+    InstrumentationProbe probe(ProbeBackwardPass);
+    backwardPass();
+  }
   STOP_PROFILER("SolverDDP::computeDirection");
 }
 
 double SolverDDP::tryStep(const double steplength) {
-  forwardPass(steplength);
+  {
+    InstrumentationProbe probe(ProbeForwardPass);
+    forwardPass(steplength);
+  }
+  calc_outdated_ = false;
+  spec_available_ = false;
   return cost_ - cost_try_;
 }
 
@@ -166,10 +213,63 @@ const Eigen::Vector2d& SolverDDP::expectedImprovement() {
   return d_;
 }
 
+void SolverDDP::shiftWarmStart() {
+  SolverAbstract::shiftWarmStart();
+  shifted_ = true;
+  const std::size_t T = problem_->get_T();
+  if (T < 2) {
+    return;
+  }
+  // The terms of each running node move together, so the workspace keeps its node-major layout
+  rotateMaps(Vxx_, T);
+  rotateMaps(Vx_, T);
+  rotateMaps(Qxx_, T);
+  rotateMaps(Qxu_, T);
+  rotateMaps(Quu_, T);
+  rotateMaps(Qx_, T);
+  rotateMaps(Qu_, T);
+  rotateMaps(K_, T);
+  rotateMaps(k_, T);
+  rotateMaps(fs_, T);
+  rotateMaps(FuTVxx_p_, T);
+  rotateMaps(Quuk_, T);
+  Vxx_[T - 1] = Vxx_[T - 2];
+  Vx_[T - 1] = Vx_[T - 2];
+  K_[T - 1] = K_[T - 2];
+  k_[T - 1] = k_[T - 2];
+  fs_[T - 1].setZero();
+
+  // The trials of the concurrent line search follow the nodes of the problem, so their datas are recycled
+  for (std::size_t n = 1; n < ls_trials_.size(); ++n) {
+    LineSearchTrial& trial = ls_trials_[n];
+    if (trial.models.size() == T) {
+      std::rotate(trial.models.begin(), trial.models.begin() + 1, trial.models.end());
+      std::rotate(trial.datas.begin(), trial.datas.begin() + 1, trial.datas.end());
+    }
+  }
+  if (spec_trial_.models.size() == T) {
+    std::rotate(spec_trial_.models.begin(), spec_trial_.models.begin() + 1, spec_trial_.models.end());
+    std::rotate(spec_trial_.datas.begin(), spec_trial_.datas.begin() + 1, spec_trial_.datas.end());
+  }
+  spec_available_ = false;
+}
+
 double SolverDDP::calcDiff() {
   START_PROFILER("SolverDDP::calcDiff");
-  if (iter_ == 0) problem_->calc(xs_, us_);
-  cost_ = problem_->calcDiff(xs_, us_);
+  InstrumentationProbe probe(ProbeCalcDiff);
+  if (hasSpeculativeDerivatives()) {
+    // The speculative full step was accepted, so its data already contain the derivatives
+    problem_->swapDatas(spec_trial_.datas, spec_trial_.terminal_data);
+    cost_ = spec_trial_.cost;
+  } else if ((iter_ == 0 && !warm_rollout_) || calc_outdated_) {
+    // The datas do not contain the calc of the current guess, so both are computed at once
+    cost_ = problem_->calcAndDiff(xs_, us_);
+  } else {
+    cost_ = problem_->calcDiff(xs_, us_);
+  }
+  calc_outdated_ = false;
+  spec_available_ = false;
+  warm_rollout_ = false;
 
   if (!is_feasible_) {
     const Eigen::VectorXd& x0 = problem_->get_x0();
@@ -181,14 +281,11 @@ double SolverDDP::calcDiff() {
     const std::size_t T = problem_->get_T();
     const std::vector<boost::shared_ptr<ActionModelAbstract> >& models = problem_->get_runningModels();
     const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas = problem_->get_runningDatas();
-#ifdef CROCODDYL_WITH_MULTITHREADING
-#pragma omp parallel for num_threads(problem_->get_nthreads())
-#endif
-    for (std::size_t t = 0; t < T; ++t) {
+    problem_->get_scheduler()->parallelFor(T, [&](const std::size_t t) {
       const boost::shared_ptr<ActionModelAbstract>& model = models[t];
       const boost::shared_ptr<ActionDataAbstract>& d = datas[t];
       model->get_state()->diff(xs_[t + 1], d->xnext, fs_[t + 1]);
-    }
+    });
 
     if (could_be_feasible) {
       for (std::size_t t = 0; t < T; ++t) {
@@ -201,7 +298,7 @@ double SolverDDP::calcDiff() {
     is_feasible_ = could_be_feasible;
 
   } else if (!was_feasible_) {  // closing the gaps
-    for (std::vector<Eigen::VectorXd>::iterator it = fs_.begin(); it != fs_.end(); ++it) {
+    for (std::vector<VectorXdMap>::iterator it = fs_.begin(); it != fs_.end(); ++it) {
       it->setZero();
     }
   }
@@ -210,7 +307,20 @@ double SolverDDP::calcDiff() {
 }
 
 void SolverDDP::backwardPass() {
+  switch (backward_type_) {
+    case BackwardPassPartitioned:
+      backwardPassPartitioned();
+      break;
+    default:
+      backwardPassSerial();
+      break;
+  }
+}
+
+void SolverDDP::backwardPassSerial() {
   START_PROFILER("SolverDDP::backwardPass");
+  // The nodes might have changed since the allocation (e.g. with set_runningModels() or circularAppend())
+  selectFixedSizeKernels();
   const boost::shared_ptr<ActionDataAbstract>& d_T = problem_->get_terminalData();
   Vxx_.back() = d_T->Lxx;
   Vx_.back() = d_T->Lx;
@@ -222,76 +332,310 @@ void SolverDDP::backwardPass() {
   if (!is_feasible_) {
     Vx_.back().noalias() += Vxx_.back() * fs_.back();
   }
+  backwardPassSegment(0, problem_->get_T(), sweep_);
+  STOP_PROFILER("SolverDDP::backwardPass");
+}
+
+void SolverDDP::backwardPassPartitioned() {
+  const std::size_t T = problem_->get_T();
+  const std::size_t nsegments = std::min(problem_->get_nthreads(), T);
+  if (nsegments < 2) {
+    backwardPassSerial();
+    return;
+  }
+  START_PROFILER("SolverDDP::backwardPass");
+  selectFixedSizeKernels();
+  if (seg_bounds_.size() != nsegments + 1 || seg_bounds_.back() != T) {
+    allocatePartitionData(nsegments);
+  }
+
+  // Condense the segments, except the first one as its boundary is the initial node
+  problem_->get_scheduler()->parallelFor(nsegments - 1, [&](const std::size_t i) {
+    const std::size_t s = i + 1;
+    RiccatiElement& e = seg_elems_[s];
+    seg_success_[s] = computeRiccatiElement(seg_bounds_[s + 1] - 1, e);
+    for (std::size_t t = seg_bounds_[s + 1] - 1; t-- > seg_bounds_[s];) {
+      if (!seg_success_[s]) {
+        break;
+      }
+      seg_success_[s] = computeRiccatiElement(t, seg_nodes_[s]);
+      combineRiccatiElements(seg_nodes_[s], e, seg_tmps_[s], seg_lu_[s], seg_MA_[s], seg_MC_[s], seg_Mb_[s]);
+      std::swap(e, seg_tmps_[s]);
+    }
+  });
+  for (std::size_t s = 1; s < nsegments; ++s) {
+    if (!seg_success_[s]) {
+      STOP_PROFILER("SolverDDP::backwardPass");
+      backwardPassSerial();
+      return;
+    }
+  }
+
+  // Propagate the Value function across the segment boundaries
+  const boost::shared_ptr<ActionDataAbstract>& d_T = problem_->get_terminalData();
+  suffix_.A.setZero();
+  suffix_.b.setZero();
+  suffix_.C.setZero();
+  suffix_.eta = -d_T->Lx;
+  suffix_.J = d_T->Lxx;
+  if (!std::isnan(xreg_)) {
+    suffix_.J.diagonal().array() += xreg_;
+  }
+  for (std::size_t s = nsegments; s-- > 0;) {
+    const std::size_t t = seg_bounds_[s + 1];
+    Vxx_[t] = suffix_.J;
+    Vx_[t] = -suffix_.eta;
+    if (!is_feasible_) {
+      Vx_[t].noalias() += Vxx_[t] * fs_[t];
+    }
+    if (s > 0) {
+      combineRiccatiElements(seg_elems_[s], suffix_, seg_tmps_[0], seg_lu_[0], seg_MA_[0], seg_MC_[0], seg_Mb_[0]);
+      std::swap(suffix_, seg_tmps_[0]);
+    }
+  }
+
+  // Run the Riccati sweep of each segment. The previous segment reads the boundary value of its successor, so the
+  // sweeps write the Value function of their first node into their own buffers, which are copied after the join
+  problem_->get_scheduler()->parallelFor(nsegments, [&](const std::size_t s) {
+    try {
+      backwardPassSegment(seg_bounds_[s], seg_bounds_[s + 1], seg_sweeps_[s], s > 0);
+      seg_success_[s] = true;
+    } catch (std::exception& e) {
+      seg_success_[s] = false;
+    }
+  });
+  for (std::size_t s = 0; s < nsegments; ++s) {
+    if (!seg_success_[s]) {
+      STOP_PROFILER("SolverDDP::backwardPass");
+      throw_pretty("backward_error");
+    }
+  }
+  for (std::size_t s = 1; s < nsegments; ++s) {
+    Vxx_[seg_bounds_[s]] = seg_sweeps_[s].Vxx_first;
+    Vx_[seg_bounds_[s]] = seg_sweeps_[s].Vx_first;
+  }
+  STOP_PROFILER("SolverDDP::backwardPass");
+}
+
+void SolverDDP::backwardPassSegment(const std::size_t t0, const std::size_t t1, RiccatiSweepData& sweep,
+                                    const bool defer_first) {
   const std::vector<boost::shared_ptr<ActionModelAbstract> >& models = problem_->get_runningModels();
   const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas = problem_->get_runningDatas();
-  for (int t = static_cast<int>(problem_->get_T()) - 1; t >= 0; --t) {
+  for (int t = static_cast<int>(t1) - 1; t >= static_cast<int>(t0); --t) {
     const boost::shared_ptr<ActionModelAbstract>& m = models[t];
     const boost::shared_ptr<ActionDataAbstract>& d = datas[t];
-    const Eigen::MatrixXd& Vxx_p = Vxx_[t + 1];
-    const Eigen::VectorXd& Vx_p = Vx_[t + 1];
+    const MatrixXdMap& Vxx_p = Vxx_[t + 1];
+    const VectorXdMap& Vx_p = Vx_[t + 1];
     const std::size_t nu = m->get_nu();
+    const bool structured = structured_ && d->F_structured;
+    const bool deferred = defer_first && t == static_cast<int>(t0);
+    MatrixXdMap Vxx(deferred ? sweep.Vxx_first.data() : Vxx_[t].data(), Vxx_[t].rows(), Vxx_[t].cols());
+    VectorXdMap Vx(deferred ? sweep.Vx_first.data() : Vx_[t].data(), Vx_[t].size());
+    if (!structured && fixed_size_ && fixed_node_ != NULL && nu == fixed_nu_) {
+      (this->*fixed_node_)(t, sweep, Vxx.data(), Vx.data());
+      continue;
+    }
 
     Qxx_[t] = d->Lxx;
     Qx_[t] = d->Lx;
-    START_PROFILER("SolverDDP::Qxx");
-    FxTVxx_p_.noalias() = d->Fx.transpose() * Vxx_p;
-    Qxx_[t].noalias() += FxTVxx_p_ * d->Fx;
-    STOP_PROFILER("SolverDDP::Qxx");
-    Qx_[t].noalias() += d->Fx.transpose() * Vx_p;
     if (nu != 0) {
       Qxu_[t].leftCols(nu) = d->Lxu;
       Quu_[t].topLeftCorner(nu, nu) = d->Luu;
       Qu_[t].head(nu) = d->Lu;
-      START_PROFILER("SolverDDP::Qxu");
-      Qxu_[t].leftCols(nu).noalias() += FxTVxx_p_ * d->Fu;
-      STOP_PROFILER("SolverDDP::Qxu");
-      START_PROFILER("SolverDDP::Quu");
-      FuTVxx_p_[t].topRows(nu).noalias() = d->Fu.transpose() * Vxx_p;
-      Quu_[t].topLeftCorner(nu, nu).noalias() += FuTVxx_p_[t].topRows(nu) * d->Fu;
-      STOP_PROFILER("SolverDDP::Quu");
+    }
+    if (structured) {
+      computeStructuredTerms(t, sweep);
+    } else {
+      START_PROFILER("SolverDDP::Qxx");
+      sweep.FxTVxx_p.noalias() = d->Fx.transpose() * Vxx_p;
+      Qxx_[t].noalias() += sweep.FxTVxx_p * d->Fx;
+      STOP_PROFILER("SolverDDP::Qxx");
+      if (nu != 0) {
+        START_PROFILER("SolverDDP::Qxu");
+        Qxu_[t].leftCols(nu).noalias() += sweep.FxTVxx_p * d->Fu;
+        STOP_PROFILER("SolverDDP::Qxu");
+        START_PROFILER("SolverDDP::Quu");
+        FuTVxx_p_[t].topRows(nu).noalias() = d->Fu.transpose() * Vxx_p;
+        Quu_[t].topLeftCorner(nu, nu).noalias() += FuTVxx_p_[t].topRows(nu) * d->Fu;
+        STOP_PROFILER("SolverDDP::Quu");
+      }
+    }
+    Qx_[t].noalias() += d->Fx.transpose() * Vx_p;
+    if (nu != 0) {
       Qu_[t].head(nu).noalias() += d->Fu.transpose() * Vx_p;
-
       if (!std::isnan(ureg_)) {
         Quu_[t].diagonal().head(nu).array() += ureg_;
       }
     }
 
-    computeGains(t);
+    {
+      InstrumentationProbe probe(ProbeComputeGains);
+      computeGains(t);
+    }
 
-    Vx_[t] = Qx_[t];
-    Vxx_[t] = Qxx_[t];
+    Vx = Qx_[t];
+    Vxx = Qxx_[t];
     if (nu != 0) {
       if (std::isnan(ureg_)) {
-        Vx_[t].noalias() -= K_[t].topRows(nu).transpose() * Qu_[t].head(nu);
+        Vx.noalias() -= K_[t].topRows(nu).transpose() * Qu_[t].head(nu);
       } else {
         Quuk_[t].head(nu).noalias() = Quu_[t].topLeftCorner(nu, nu) * k_[t].head(nu);
-        Vx_[t].noalias() += K_[t].topRows(nu).transpose() * Quuk_[t].head(nu);
-        Vx_[t].noalias() -= 2 * (K_[t].topRows(nu).transpose() * Qu_[t].head(nu));
+        Vx.noalias() += K_[t].topRows(nu).transpose() * Quuk_[t].head(nu);
+        Vx.noalias() -= 2 * (K_[t].topRows(nu).transpose() * Qu_[t].head(nu));
       }
       START_PROFILER("SolverDDP::Vxx");
-      Vxx_[t].noalias() -= Qxu_[t].leftCols(nu) * K_[t].topRows(nu);
+      Vxx.noalias() -= Qxu_[t].leftCols(nu) * K_[t].topRows(nu);
       STOP_PROFILER("SolverDDP::Vxx");
     }
-    Vxx_tmp_ = 0.5 * (Vxx_[t] + Vxx_[t].transpose());
-    Vxx_[t] = Vxx_tmp_;
+    sweep.Vxx_tmp = 0.5 * (Vxx + Vxx.transpose());
+    Vxx = sweep.Vxx_tmp;
 
     if (!std::isnan(xreg_)) {
-      Vxx_[t].diagonal().array() += xreg_;
+      Vxx.diagonal().array() += xreg_;
     }
 
     // Compute and store the Vx gradient at end of the interval (rollout state)
     if (!is_feasible_) {
-      Vx_[t].noalias() += Vxx_[t] * fs_[t];
+      Vx.noalias() += Vxx * fs_[t];
     }
 
-    if (raiseIfNaN(Vx_[t].lpNorm<Eigen::Infinity>())) {
+    if (raiseIfNaN(Vx.lpNorm<Eigen::Infinity>())) {
       throw_pretty("backward_error");
     }
-    if (raiseIfNaN(Vxx_[t].lpNorm<Eigen::Infinity>())) {
+    if (raiseIfNaN(Vxx.lpNorm<Eigen::Infinity>())) {
       throw_pretty("backward_error");
     }
   }
-  STOP_PROFILER("SolverDDP::backwardPass");
+}
+
+void SolverDDP::computeStructuredTerms(const std::size_t t, RiccatiSweepData& sweep) {
+  START_PROFILER("SolverDDP::computeStructuredTerms");
+  const boost::shared_ptr<ActionModelAbstract>& m = problem_->get_runningModels()[t];
+  const boost::shared_ptr<ActionDataAbstract>& d = problem_->get_runningDatas()[t];
+  const MatrixXdMap& Vxx_p = Vxx_[t + 1];
+  const std::size_t nu = m->get_nu();
+  const std::size_t nv = m->get_state()->get_ndx() / 2;
+  const std::size_t nd = d->F_ndense;
+  const std::size_t ne = nv - nd;
+  const double dt = d->F_dt;
+
+  // Split fx = M Fv + C, with M = [dt I; I] and C = [Fx_dense; 0 I 0; 0], and fu = M Fuv + [Fu_dense; 0]
+  const Eigen::MatrixXd& Fx = d->Fx;
+  const Eigen::MatrixXd& Fu = d->Fu;
+  Eigen::Block<Eigen::MatrixXd> Fx_dense = sweep.Fx_dense.topRows(nd);
+  Eigen::Block<Eigen::MatrixXd> Fu_dense = sweep.Fu_dense.topLeftCorner(nd, nu);
+  Fx_dense = Fx.topRows(nd);
+  Fx_dense.noalias() -= dt * Fx.bottomRows(nv).topRows(nd);
+  Fu_dense = Fu.topRows(nd);
+  Fu_dense.noalias() -= dt * Fu.bottomRows(nv).topRows(nd);
+
+  // fxTVxx_p = Fv^T M^T Vxx_p + C^T Vxx_p
+  MatrixXdRowMajor& FxTVxx_p = sweep.FxTVxx_p;
+  sweep.MTVxx_p = Vxx_p.bottomRows(nv);
+  sweep.MTVxx_p.noalias() += dt * Vxx_p.topRows(nv);
+  FxTVxx_p.noalias() = Fx.bottomRows(nv).transpose() * sweep.MTVxx_p;
+  FxTVxx_p.middleRows(nd, ne) += Vxx_p.middleRows(nd, ne);
+  if (nd != 0) {
+    FxTVxx_p.noalias() += Fx_dense.transpose() * Vxx_p.topRows(nd);
+  }
+
+  // Qxx += fxTVxx_p M Fv + fxTVxx_p C
+  sweep.FxTVxx_pM = FxTVxx_p.rightCols(nv);
+  sweep.FxTVxx_pM.noalias() += dt * FxTVxx_p.leftCols(nv);
+  Qxx_[t].noalias() += sweep.FxTVxx_pM * Fx.bottomRows(nv);
+  Qxx_[t].middleCols(nd, ne) += FxTVxx_p.middleCols(nd, ne);
+  if (nd != 0) {
+    Qxx_[t].noalias() += FxTVxx_p.leftCols(nd) * Fx_dense;
+  }
+  if (nu != 0) {
+    Qxu_[t].leftCols(nu).noalias() += sweep.FxTVxx_pM * Fu.bottomRows(nv);
+    FuTVxx_p_[t].topRows(nu).noalias() = Fu.bottomRows(nv).transpose() * sweep.MTVxx_p;
+    if (nd != 0) {
+      Qxu_[t].leftCols(nu).noalias() += FxTVxx_p.leftCols(nd) * Fu_dense;
+      FuTVxx_p_[t].topRows(nu).noalias() += Fu_dense.transpose() * Vxx_p.topRows(nd);
+    }
+    Quu_[t].topLeftCorner(nu, nu).noalias() += FuTVxx_p_[t].topRows(nu) * Fu;
+  }
+  STOP_PROFILER("SolverDDP::computeStructuredTerms");
+}
+
+bool SolverDDP::computeRiccatiElement(const std::size_t t, RiccatiElement& e) {
+  const boost::shared_ptr<ActionModelAbstract>& m = problem_->get_runningModels()[t];
+  const boost::shared_ptr<ActionDataAbstract>& d = problem_->get_runningDatas()[t];
+  const std::size_t nu = m->get_nu();
+
+  // The node buffers of the Riccati sweep are used as workspace since the sweep overwrites them afterwards
+  e.A = d->Fx;
+  if (is_feasible_) {
+    e.b.setZero();
+  } else {
+    e.b = fs_[t + 1];
+  }
+  e.C.setZero();
+  e.eta = -d->Lx;
+  e.J = d->Lxx;
+  if (nu != 0) {
+    Quu_[t].topLeftCorner(nu, nu) = d->Luu;
+    if (!std::isnan(ureg_)) {
+      Quu_[t].diagonal().head(nu).array() += ureg_;
+    }
+    Quu_llt_[t].compute(Quu_[t].topLeftCorner(nu, nu));
+    if (Quu_llt_[t].info() != Eigen::Success) {
+      return false;
+    }
+    // Eliminate the cross term, i.e. u = v - Luu^{-1} (Lux x + Lu)
+    Eigen::Block<MatrixXdRowMajorMap, Eigen::Dynamic, Eigen::Dynamic, true> Luu_inv_Lux = K_[t].topRows(nu);
+    Luu_inv_Lux = d->Lxu.transpose();
+    Quu_llt_[t].solveInPlace(Luu_inv_Lux);
+    Eigen::VectorBlock<VectorXdMap, Eigen::Dynamic> Luu_inv_lu = k_[t].head(nu);
+    Luu_inv_lu = d->Lu;
+    Quu_llt_[t].solveInPlace(Luu_inv_lu);
+    Eigen::Block<MatrixXdRowMajorMap, Eigen::Dynamic, Eigen::Dynamic, true> Luu_inv_FuT = FuTVxx_p_[t].topRows(nu);
+    Luu_inv_FuT = d->Fu.transpose();
+    Quu_llt_[t].solveInPlace(Luu_inv_FuT);
+
+    e.A.noalias() -= d->Fu * Luu_inv_Lux;
+    e.b.noalias() -= d->Fu * Luu_inv_lu;
+    e.C.noalias() = d->Fu * Luu_inv_FuT;
+    e.eta.noalias() += d->Lxu * Luu_inv_lu;
+    e.J.noalias() -= d->Lxu * Luu_inv_Lux;
+  }
+  if (!std::isnan(xreg_)) {
+    e.J.diagonal().array() += xreg_;
+  }
+  return true;
+}
+
+void SolverDDP::combineRiccatiElements(const RiccatiElement& e_ij, const RiccatiElement& e_jk, RiccatiElement& e_ik,
+                                       Eigen::PartialPivLU<Eigen::MatrixXd>& lu, Eigen::MatrixXd& MA,
+                                       Eigen::MatrixXd& MC, Eigen::VectorXd& Mb) {
+  // M = (I + C_ij J_jk)^{-1}, note that M^T = (I + J_jk C_ij)^{-1}
+  e_ik.A.noalias() = e_ij.C * e_jk.J;
+  e_ik.A.diagonal().array() += 1.;
+  lu.compute(e_ik.A);
+  MA = lu.solve(e_ij.A);
+  MC = lu.solve(e_ij.C);
+  Mb = e_ij.b;
+  Mb.noalias() += e_ij.C * e_jk.eta;
+  Mb = lu.solve(Mb);
+
+  e_ik.A.noalias() = e_jk.A * MA;
+  e_ik.b = e_jk.b;
+  e_ik.b.noalias() += e_jk.A * Mb;
+  e_ik.C = e_jk.C;
+  e_ik.C.noalias() += e_jk.A * MC * e_jk.A.transpose();
+  e_ik.eta = e_jk.eta;
+  e_ik.eta.noalias() -= e_jk.J * e_ij.b;
+  Mb.noalias() = MA.transpose() * e_ik.eta;
+  e_ik.eta = Mb + e_ij.eta;
+  e_ik.J = e_ij.J;
+  e_ik.J.noalias() += MA.transpose() * e_jk.J * e_ij.A;
+
+  // Ensure the symmetry of the Hessian terms
+  MC = 0.5 * (e_ik.C + e_ik.C.transpose());
+  e_ik.C = MC;
+  MC = 0.5 * (e_ik.J + e_ik.J.transpose());
+  e_ik.J = MC;
 }
 
 void SolverDDP::forwardPass(const double steplength) {
@@ -300,51 +644,302 @@ void SolverDDP::forwardPass(const double steplength) {
     throw_pretty("Invalid argument: "
                  << "invalid step length, value is between 0. to 1.");
   }
-  cost_try_ = 0.;
+  cost_try_ = computeRollout(steplength, problem_->get_runningDatas(), problem_->get_terminalData(), xs_try_, us_try_,
+                             dx_, xnext_);
+  STOP_PROFILER("SolverDDP::forwardPass");
+}
+
+double SolverDDP::computeRollout(const double steplength,
+                                 const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas,
+                                 const boost::shared_ptr<ActionDataAbstract>& data_T,
+                                 std::vector<Eigen::VectorXd>& xs_try, std::vector<Eigen::VectorXd>& us_try,
+                                 std::vector<Eigen::VectorXd>& dx, Eigen::VectorXd&) {
+  double cost_try = 0.;
   const std::size_t T = problem_->get_T();
   const std::vector<boost::shared_ptr<ActionModelAbstract> >& models = problem_->get_runningModels();
-  const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas = problem_->get_runningDatas();
   for (std::size_t t = 0; t < T; ++t) {
     const boost::shared_ptr<ActionModelAbstract>& m = models[t];
     const boost::shared_ptr<ActionDataAbstract>& d = datas[t];
 
-    m->get_state()->diff(xs_[t], xs_try_[t], dx_[t]);
+    m->get_state()->diff(xs_[t], xs_try[t], dx[t]);
     if (m->get_nu() != 0) {
       const std::size_t nu = m->get_nu();
 
-      us_try_[t].head(nu).noalias() = us_[t].head(nu);
-      us_try_[t].head(nu).noalias() -= k_[t].head(nu) * steplength;
-      us_try_[t].head(nu).noalias() -= K_[t].topRows(nu) * dx_[t];
-      m->calc(d, xs_try_[t], us_try_[t].head(nu));
+      us_try[t].head(nu).noalias() = us_[t].head(nu);
+      us_try[t].head(nu).noalias() -= k_[t].head(nu) * steplength;
+      us_try[t].head(nu).noalias() -= K_[t].topRows(nu) * dx[t];
+      m->calc(d, xs_try[t], us_try[t].head(nu));
     } else {
-      m->calc(d, xs_try_[t]);
+      m->calc(d, xs_try[t]);
     }
-    xs_try_[t + 1] = d->xnext;
-    cost_try_ += d->cost;
+    xs_try[t + 1] = d->xnext;
+    cost_try += d->cost;
 
-    if (raiseIfNaN(cost_try_)) {
+    if (raiseIfNaN(cost_try)) {
       throw_pretty("forward_error");
     }
-    if (raiseIfNaN(xs_try_[t + 1].lpNorm<Eigen::Infinity>())) {
+    if (raiseIfNaN(xs_try[t + 1].lpNorm<Eigen::Infinity>())) {
       throw_pretty("forward_error");
     }
+    notifyRolloutNode(t);
   }
 
   const boost::shared_ptr<ActionModelAbstract>& m = problem_->get_terminalModel();
-  const boost::shared_ptr<ActionDataAbstract>& d = problem_->get_terminalData();
-  m->calc(d, xs_try_.back());
-  cost_try_ += d->cost;
+  m->calc(data_T, xs_try.back());
+  cost_try += data_T->cost;
+
+  if (raiseIfNaN(cost_try)) {
+    throw_pretty("forward_error");
+  }
+  return cost_try;
+}
+
+bool SolverDDP::preparationPhase() {
+  if (std::isnan(xreg_)) {
+    xreg_ = reg_min_;
+    ureg_ = reg_min_;
+  }
+  // The guess was modified by the feedback phase (or shifted), so its rollout has to be computed again
+  calc_outdated_ = true;
+  spec_available_ = false;
+  bool recalcDiff = true;
+  while (true) {
+    try {
+      computeDirection(recalcDiff);
+    } catch (std::exception& e) {
+      recalcDiff = false;
+      increaseRegularization();
+      if (xreg_ == reg_max_) {
+        rti_prepared_ = false;
+        return false;
+      } else {
+        continue;
+      }
+    }
+    break;
+  }
+  // Relax the regularization of the next cycle only if this backward pass succeeded at the first attempt
+  if (recalcDiff) {
+    decreaseRegularization();
+  }
+  rti_prepared_ = true;
+  return true;
+}
+
+void SolverDDP::feedbackPhase(const Eigen::VectorXd& x0) {
+  if (!rti_prepared_) {
+    throw_pretty("Invalid argument: "
+                 << "the preparation phase has to be run before the feedback phase");
+  }
+  problem_->set_x0(x0);
+  const std::size_t T = problem_->get_T();
+  const std::vector<boost::shared_ptr<ActionModelAbstract> >& models = problem_->get_runningModels();
+  const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas = problem_->get_runningDatas();
+  models[0]->get_state()->diff(xs_[0], x0, fs_[0]);
+  rti_dx_ = fs_[0];
+  for (std::size_t t = 0; t < T; ++t) {
+    const boost::shared_ptr<ActionModelAbstract>& m = models[t];
+    const boost::shared_ptr<ActionDataAbstract>& d = datas[t];
+    const std::size_t nu = m->get_nu();
+    rti_dx_next_.noalias() = d->Fx * rti_dx_;
+    if (nu != 0) {
+      us_try_[t].head(nu).noalias() = -k_[t].head(nu) - K_[t].topRows(nu) * rti_dx_;
+      rti_dx_next_.noalias() += d->Fu * us_try_[t].head(nu);
+      us_[t].head(nu) += us_try_[t].head(nu);
+    }
+    if (!is_feasible_) {
+      rti_dx_next_ += fs_[t + 1];
+    }
+    m->get_state()->integrate(xs_[t], rti_dx_, xs_try_[t]);
+    xs_[t].swap(xs_try_[t]);
+    rti_dx_.swap(rti_dx_next_);
+  }
+  problem_->get_terminalModel()->get_state()->integrate(xs_.back(), rti_dx_, xs_try_.back());
+  xs_.back().swap(xs_try_.back());
+  is_feasible_ = false;
+  rti_prepared_ = false;
+}
+
+double SolverDDP::tryLineSearchStep(const std::size_t i) {
+  if (linesearch_type_ == LineSearchSerial) {
+    if (speculative_ && i == 0 && problem_->get_nthreads() > 1) {
+      return trySpeculativeStep();
+    }
+    return tryStep(alphas_[i]);
+  }
+  const std::size_t ntrials = std::min(problem_->get_nthreads(), alphas_.size());
+  if (ntrials < 2) {
+    return tryStep(alphas_[i]);
+  }
+
+  // Roll out a batch of step lengths, the first one on the problem data
+  const std::size_t j = i % ntrials;
+  if (j == 0) {
+    START_PROFILER("SolverDDP::forwardPass");
+    allocateLineSearchData(ntrials);
+    const std::size_t nbatch = std::min(ntrials, alphas_.size() - i);
+    problem_->get_scheduler()->parallelFor(nbatch, [&](const std::size_t n) {
+      LineSearchTrial& trial = ls_trials_[n];
+      trial.xs[0] = xs_try_[0];
+      InstrumentationProbe probe(ProbeForwardPass);
+      try {
+        if (n == 0) {
+          trial.cost = computeRollout(alphas_[i], problem_->get_runningDatas(), problem_->get_terminalData(),
+                                      trial.xs, trial.us, trial.dx, trial.xnext);
+        } else {
+          trial.cost = computeRollout(alphas_[i + n], trial.datas, trial.terminal_data, trial.xs, trial.us, trial.dx,
+                                      trial.xnext);
+        }
+        trial.success = true;
+      } catch (std::exception& e) {
+        trial.success = false;
+      }
+    });
+    STOP_PROFILER("SolverDDP::forwardPass");
+  }
 
-  if (raiseIfNaN(cost_try_)) {
+  // Load the rollout of the i-th step length
+  LineSearchTrial& trial = ls_trials_[j];
+  if (!trial.success) {
     throw_pretty("forward_error");
   }
+  xs_try_.swap(trial.xs);
+  us_try_.swap(trial.us);
+  dx_.swap(trial.dx);
+  cost_try_ = trial.cost;
+  calc_outdated_ = j != 0;
+  return cost_ - cost_try_;
+}
+
+double SolverDDP::trySpeculativeStep() {
+  START_PROFILER("SolverDDP::forwardPass");
+  allocateTrialData(spec_trial_, true);
+  spec_trial_.xs[0] = xs_try_[0];
+  const std::size_t T = problem_->get_T();
+  const std::vector<boost::shared_ptr<ActionModelAbstract> >& models = problem_->get_runningModels();
+  const boost::shared_ptr<ActionModelAbstract>& model_T = problem_->get_terminalModel();
+  std::atomic<bool> started(false);
+  std::atomic<bool> failed(false);
+  std::atomic<bool> diff_failed(false);
+  std::atomic<std::size_t> next(0);
+  spec_nodes_.store(0);
+  spec_rollout_ = true;
+  problem_->get_scheduler()->parallelFor(problem_->get_nthreads(), [&](const std::size_t n) {
+    if (n == 0) {
+      started.store(true, std::memory_order_release);
+      InstrumentationProbe probe(ProbeForwardPass);
+      try {
+        spec_trial_.cost = computeRollout(alphas_[0], spec_trial_.datas, spec_trial_.terminal_data, spec_trial_.xs,
+                                          spec_trial_.us, spec_trial_.dx, spec_trial_.xnext);
+      } catch (std::exception& e) {
+        failed.store(true, std::memory_order_relaxed);
+      }
+      notifyRolloutNode(T);  // the terminal node is ready too
+    } else if (!started.load(std::memory_order_acquire)) {
+      return;
+    }
+
+    // Differentiate the nodes once the rollout has passed them. The rollout task never waits, and the other tasks
+    // only wait once it has started, so they sleep until it notifies their node
+    for (std::size_t t = next++; t < T + 1; t = next++) {
+      if (spec_nodes_.load(std::memory_order_acquire) < t + 1) {
+        std::unique_lock<std::mutex> lock(spec_mutex_);
+        ++spec_waiting_;
+        spec_cond_.wait(lock, [&] { return spec_nodes_.load(std::memory_order_relaxed) >= t + 1; });
+        --spec_waiting_;
+      }
+      if (failed.load(std::memory_order_relaxed) || diff_failed.load(std::memory_order_relaxed)) {
+        return;
+      }
+      try {
+        if (t == T) {
+          model_T->calcDiff(spec_trial_.terminal_data, spec_trial_.xs.back());
+        } else if (models[t]->get_nu() != 0) {
+          const std::size_t nu = models[t]->get_nu();
+          models[t]->calcDiff(spec_trial_.datas[t], spec_trial_.xs[t], spec_trial_.us[t].head(nu));
+        } else {
+          models[t]->calcDiff(spec_trial_.datas[t], spec_trial_.xs[t]);
+        }
+      } catch (std::exception& e) {
+        diff_failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  });
+  spec_rollout_ = false;
   STOP_PROFILER("SolverDDP::forwardPass");
+
+  if (failed) {
+    throw_pretty("forward_error");
+  }
+  xs_try_.swap(spec_trial_.xs);
+  us_try_.swap(spec_trial_.us);
+  dx_.swap(spec_trial_.dx);
+  cost_try_ = spec_trial_.cost;
+  calc_outdated_ = true;  // the problem data are only updated if the step is accepted
+  spec_available_ = !diff_failed;
+  return cost_ - cost_try_;
+}
+
+bool SolverDDP::hasSpeculativeDerivatives() const {
+  // The problem could have been modified between two solves
+  if (!spec_available_ || iter_ == 0) {
+    return false;
+  }
+  const std::size_t T = problem_->get_T();
+  for (std::size_t t = 0; t < T; ++t) {
+    if (xs_[t] != xs_try_[t] || us_[t] != us_try_[t]) {
+      return false;
+    }
+  }
+  return xs_.back() == xs_try_.back();
+}
+
+bool SolverDDP::applyWarmStart() {
+  const bool shifted = shifted_;
+  shifted_ = false;
+  warm_rollout_ = false;
+  if (!warm_start_policy_ || !shifted || std::isnan(xreg_) || xreg_ == reg_max_) {
+    return false;
+  }
+
+  // The closed-loop rollout starts from the initial state, so it runs the feasible branch of the rollouts
+  const bool was_feasible = is_feasible_;
+  xs_try_[0] = problem_->get_x0();
+  is_feasible_ = true;
+  try {
+    InstrumentationProbe probe(ProbeForwardPass);
+    cost_try_ = computeRollout(0., problem_->get_runningDatas(), problem_->get_terminalData(), xs_try_, us_try_, dx_,
+                               xnext_);
+  } catch (std::exception& e) {
+    is_feasible_ = was_feasible;
+    calc_outdated_ = true;
+    return false;
+  }
+  setCandidate(xs_try_, us_try_, true);
+  cost_ = cost_try_;
+  calc_outdated_ = false;
+  spec_available_ = false;
+  warm_rollout_ = true;
+  return true;
+}
+
+void SolverDDP::notifyRolloutNode(const std::size_t t) {
+  if (spec_rollout_) {
+    // The node count is updated under the lock, so a task cannot miss it between its check and its wait
+    std::lock_guard<std::mutex> lock(spec_mutex_);
+    spec_nodes_.store(t + 1, std::memory_order_release);
+    if (spec_waiting_ > 0) {
+      spec_cond_.notify_all();
+    }
+  }
 }
 
 void SolverDDP::computeGains(const std::size_t t) {
   START_PROFILER("SolverDDP::computeGains");
   const std::size_t nu = problem_->get_runningModels()[t]->get_nu();
-  if (nu > 0) {
+  if (fixed_size_ && fixed_gains_ != NULL && nu == fixed_nu_) {
+    (this->*fixed_gains_)(t);
+  } else if (nu > 0) {
     START_PROFILER("SolverDDP::Quu_inv");
     Quu_llt_[t].compute(Quu_[t].topLeftCorner(nu, nu));
     STOP_PROFILER("SolverDDP::Quu_inv");
@@ -354,18 +949,140 @@ void SolverDDP::computeGains(const std::size_t t) {
     }
     K_[t].topRows(nu) = Qxu_[t].leftCols(nu).transpose();
 
-    Eigen::Block<MatrixXdRowMajor, Eigen::Dynamic, Eigen::internal::traits<MatrixXdRowMajor>::ColsAtCompileTime, true>
-        K = K_[t].topRows(nu);
+    Eigen::Block<MatrixXdRowMajorMap, Eigen::Dynamic, Eigen::Dynamic, true> K = K_[t].topRows(nu);
     START_PROFILER("SolverDDP::Quu_inv_Qux");
     Quu_llt_[t].solveInPlace(K);
     STOP_PROFILER("SolverDDP::Quu_inv_Qux");
     k_[t].head(nu) = Qu_[t].head(nu);
-    Eigen::VectorBlock<Eigen::VectorXd, Eigen::Dynamic> k = k_[t].head(nu);
+    Eigen::VectorBlock<VectorXdMap, Eigen::Dynamic> k = k_[t].head(nu);
     Quu_llt_[t].solveInPlace(k);
   }
   STOP_PROFILER("SolverDDP::computeGains");
 }
 
+template <int NX, int NU>
+void SolverDDP::backwardPassNodeFixed(const std::size_t t, RiccatiSweepData& sweep, double* Vxx_out, double* Vx_out) {
+  typedef Eigen::Matrix<double, NX, NX> MatrixNxNx;
+  typedef Eigen::Matrix<double, NX, NU> MatrixNxNu;
+  typedef Eigen::Matrix<double, NU, NU> MatrixNuNu;
+  typedef Eigen::Matrix<double, NU, NX, Eigen::RowMajor> MatrixNuNxRowMajor;
+  typedef Eigen::Matrix<double, NX, 1> VectorNx;
+  typedef Eigen::Matrix<double, NU, 1> VectorNu;
+  const boost::shared_ptr<ActionDataAbstract>& d = problem_->get_runningDatas()[t];
+
+  // Fixed-size views of the action data and of the node terms of the workspace
+  const Eigen::Map<const MatrixNxNx> Fx(d->Fx.data());
+  const Eigen::Map<const MatrixNxNu> Fu(d->Fu.data());
+  const Eigen::Map<const MatrixNxNx> Lxx(d->Lxx.data());
+  const Eigen::Map<const MatrixNxNu> Lxu(d->Lxu.data());
+  const Eigen::Map<const MatrixNuNu> Luu(d->Luu.data());
+  const Eigen::Map<const VectorNx> Lx(d->Lx.data());
+  const Eigen::Map<const VectorNu> Lu(d->Lu.data());
+  const Eigen::Map<const MatrixNxNx, Eigen::AlignedMax> Vxx_p(Vxx_[t + 1].data());
+  const Eigen::Map<const VectorNx, Eigen::AlignedMax> Vx_p(Vx_[t + 1].data());
+  Eigen::Map<MatrixNxNx, Eigen::AlignedMax> Qxx(Qxx_[t].data());
+  Eigen::Map<MatrixNxNu, Eigen::AlignedMax> Qxu(Qxu_[t].data());
+  Eigen::Map<MatrixNuNu, Eigen::AlignedMax> Quu(Quu_[t].data());
+  Eigen::Map<VectorNx, Eigen::AlignedMax> Qx(Qx_[t].data());
+  Eigen::Map<VectorNu, Eigen::AlignedMax> Qu(Qu_[t].data());
+  Eigen::Map<MatrixNuNxRowMajor, Eigen::AlignedMax> FuTVxx_p(FuTVxx_p_[t].data());
+  Eigen::Map<Eigen::Matrix<double, NX, NX, Eigen::RowMajor> > FxTVxx_p(sweep.FxTVxx_p.data());
+
+  Qxx = Lxx;
+  Qx = Lx;
+  Qxu = Lxu;
+  Quu = Luu;
+  Qu = Lu;
+  FxTVxx_p.noalias() = Fx.transpose() * Vxx_p;
+  Qxx.noalias() += FxTVxx_p * Fx;
+  Qx.noalias() += Fx.transpose() * Vx_p;
+  Qxu.noalias() += FxTVxx_p * Fu;
+  FuTVxx_p.noalias() = Fu.transpose() * Vxx_p;
+  Quu.noalias() += FuTVxx_p * Fu;
+  Qu.noalias() += Fu.transpose() * Vx_p;
+  if (!std::isnan(ureg_)) {
+    Quu.diagonal().array() += ureg_;
+  }
+
+  {
+    InstrumentationProbe probe(ProbeComputeGains);
+    computeGains(t);
+  }
+
+  const Eigen::Map<const MatrixNuNxRowMajor, Eigen::AlignedMax> K(K_[t].data());
+  const Eigen::Map<const VectorNu, Eigen::AlignedMax> k(k_[t].data());
+  Eigen::Map<MatrixNxNx, Eigen::AlignedMax> Vxx(Vxx_out);
+  Eigen::Map<VectorNx, Eigen::AlignedMax> Vx(Vx_out);
+  Eigen::Map<VectorNu, Eigen::AlignedMax> Quuk(Quuk_[t].data());
+  Eigen::Map<MatrixNxNx> Vxx_tmp(sweep.Vxx_tmp.data());
+  Vx = Qx;
+  Vxx = Qxx;
+  if (std::isnan(ureg_)) {
+    Vx.noalias() -= K.transpose() * Qu;
+  } else {
+    Quuk.noalias() = Quu * k;
+    Vx.noalias() += K.transpose() * Quuk;
+    Vx.noalias() -= 2 * (K.transpose() * Qu);
+  }
+  Vxx.noalias() -= Qxu * K;
+  Vxx_tmp = 0.5 * (Vxx + Vxx.transpose());
+  Vxx = Vxx_tmp;
+
+  if (!std::isnan(xreg_)) {
+    Vxx.diagonal().array() += xreg_;
+  }
+
+  // Compute and store the Vx gradient at end of the interval (rollout state)
+  if (!is_feasible_) {
+    Vx.noalias() += Vxx * Eigen::Map<const VectorNx, Eigen::AlignedMax>(fs_[t].data());
+  }
+
+  if (raiseIfNaN(Vx.template lpNorm<Eigen::Infinity>())) {
+    throw_pretty("backward_error");
+  }
+  if (raiseIfNaN(Vxx.template lpNorm<Eigen::Infinity>())) {
+    throw_pretty("backward_error");
+  }
+}
+
+template <int NX, int NU>
+void SolverDDP::computeGainsFixed(const std::size_t t) {
+  typedef Eigen::Matrix<double, NU, NU> MatrixNuNu;
+  const Eigen::Map<const MatrixNuNu, Eigen::AlignedMax> Quu(Quu_[t].data());
+  const Eigen::Map<const Eigen::Matrix<double, NX, NU>, Eigen::AlignedMax> Qxu(Qxu_[t].data());
+  const Eigen::Map<const Eigen::Matrix<double, NU, 1>, Eigen::AlignedMax> Qu(Qu_[t].data());
+  Eigen::Map<Eigen::Matrix<double, NU, NX, Eigen::RowMajor>, Eigen::AlignedMax> K(K_[t].data());
+  Eigen::Map<Eigen::Matrix<double, NU, 1>, Eigen::AlignedMax> k(k_[t].data());
+
+  // The factorization is kept in Quu_llt_, as in the dynamic-size path, since its storage is already allocated
+  Quu_llt_[t].compute(Quu);
+  if (Quu_llt_[t].info() != Eigen::Success) {
+    throw_pretty("backward_error");
+  }
+  K = Qxu.transpose();
+  Quu_llt_[t].solveInPlace(K);
+  k = Qu;
+  Quu_llt_[t].solveInPlace(k);
+}
+
+void SolverDDP::selectFixedSizeKernels() {
+  const std::size_t ndx = problem_->get_ndx();
+  const std::size_t nu = problem_->get_nu_max();
+  fixed_node_ = NULL;
+  fixed_gains_ = NULL;
+  fixed_nu_ = nu;
+  if (ndx == 3 && nu == 2) {  // unicycle
+    fixed_node_ = &SolverDDP::backwardPassNodeFixed<3, 2>;
+    fixed_gains_ = &SolverDDP::computeGainsFixed<3, 2>;
+  } else if (ndx == 14 && nu == 7) {  // 7-DoF manipulators
+    fixed_node_ = &SolverDDP::backwardPassNodeFixed<14, 7>;
+    fixed_gains_ = &SolverDDP::computeGainsFixed<14, 7>;
+  } else if (ndx == 36 && nu == 12) {  // 12-DoF legged robots (floating base)
+    fixed_node_ = &SolverDDP::backwardPassNodeFixed<36, 12>;
+    fixed_gains_ = &SolverDDP::computeGainsFixed<36, 12>;
+  }
+}
+
 void SolverDDP::increaseRegularization() {
   xreg_ *= reg_incfactor_;
   if (xreg_ > reg_max_) {
@@ -384,40 +1101,89 @@ void SolverDDP::decreaseRegularization() {
 
 void SolverDDP::allocateData() {
   const std::size_t T = problem_->get_T();
-  Vxx_.resize(T + 1);
-  Vx_.resize(T + 1);
-  Qxx_.resize(T);
-  Qxu_.resize(T);
-  Quu_.resize(T);
-  Qx_.resize(T);
-  Qu_.resize(T);
-  K_.resize(T);
-  k_.resize(T);
-  fs_.resize(T + 1);
+  const std::size_t ndx = problem_->get_ndx();
+  const std::size_t nu = problem_->get_nu_max();
+  const std::vector<boost::shared_ptr<ActionModelAbstract> >& models = problem_->get_runningModels();
+
+  // Register the per-node terms in node-major order, i.e., Vxx, Vx, Qxx, Qxu, Quu, Qx, Qu, K, k, fs, FuTVxx_p and
+  // Quuk of each running node, and then Vxx, Vx and fs of the terminal node
+  workspace_.clear();
+  workspace_nodes_.resize(T + 1);
+  std::vector<std::size_t> offsets;
+  offsets.reserve(12 * T + 3);
+  for (std::size_t t = 0; t < T; ++t) {
+    const std::size_t size = workspace_.get_size();
+    offsets.push_back(workspace_.push(ndx, ndx));
+    offsets.push_back(workspace_.push(ndx));
+    offsets.push_back(workspace_.push(ndx, ndx));
+    offsets.push_back(workspace_.push(ndx, nu));
+    offsets.push_back(workspace_.push(nu, nu));
+    offsets.push_back(workspace_.push(ndx));
+    offsets.push_back(workspace_.push(nu));
+    offsets.push_back(workspace_.push(nu, ndx));
+    offsets.push_back(workspace_.push(nu));
+    offsets.push_back(workspace_.push(ndx));
+    offsets.push_back(workspace_.push(nu, ndx));
+    offsets.push_back(workspace_.push(nu));
+    workspace_nodes_[t] = workspace_.get_size() - size;
+  }
+  const std::size_t size = workspace_.get_size();
+  offsets.push_back(workspace_.push(ndx, ndx));
+  offsets.push_back(workspace_.push(ndx));
+  offsets.push_back(workspace_.push(ndx));
+  workspace_nodes_[T] = workspace_.get_size() - size;
+  if (workspace_block_ != NULL && workspace_.get_size() == workspace_block_size_) {
+    workspace_.allocate(workspace_block_);
+  } else {
+    workspace_block_ = NULL;
+    workspace_.allocate();
+  }
+
+  Vxx_.clear();
+  Vx_.clear();
+  Qxx_.clear();
+  Qxu_.clear();
+  Quu_.clear();
+  Qx_.clear();
+  Qu_.clear();
+  K_.clear();
+  k_.clear();
+  fs_.clear();
+  FuTVxx_p_.clear();
+  Quuk_.clear();
+  Vxx_.reserve(T + 1);
+  Vx_.reserve(T + 1);
+  Qxx_.reserve(T);
+  Qxu_.reserve(T);
+  Quu_.reserve(T);
+  Qx_.reserve(T);
+  Qu_.reserve(T);
+  K_.reserve(T);
+  k_.reserve(T);
+  fs_.reserve(T + 1);
+  FuTVxx_p_.reserve(T);
+  Quuk_.reserve(T);
 
   xs_try_.resize(T + 1);
   us_try_.resize(T);
   dx_.resize(T);
-
-  FuTVxx_p_.resize(T);
   Quu_llt_.resize(T);
-  Quuk_.resize(T);
 
-  const std::size_t ndx = problem_->get_ndx();
-  const std::size_t nu = problem_->get_nu_max();
-  const std::vector<boost::shared_ptr<ActionModelAbstract> >& models = problem_->get_runningModels();
+  std::vector<std::size_t>::const_iterator offset = offsets.begin();
   for (std::size_t t = 0; t < T; ++t) {
     const boost::shared_ptr<ActionModelAbstract>& model = models[t];
-    Vxx_[t] = Eigen::MatrixXd::Zero(ndx, ndx);
-    Vx_[t] = Eigen::VectorXd::Zero(ndx);
-    Qxx_[t] = Eigen::MatrixXd::Zero(ndx, ndx);
-    Qxu_[t] = Eigen::MatrixXd::Zero(ndx, nu);
-    Quu_[t] = Eigen::MatrixXd::Zero(nu, nu);
-    Qx_[t] = Eigen::VectorXd::Zero(ndx);
-    Qu_[t] = Eigen::VectorXd::Zero(nu);
-    K_[t] = MatrixXdRowMajor::Zero(nu, ndx);
-    k_[t] = Eigen::VectorXd::Zero(nu);
-    fs_[t] = Eigen::VectorXd::Zero(ndx);
+    Vxx_.push_back(MatrixXdMap(workspace_.get_data(*offset++), ndx, ndx));
+    Vx_.push_back(VectorXdMap(workspace_.get_data(*offset++), ndx));
+    Qxx_.push_back(MatrixXdMap(workspace_.get_data(*offset++), ndx, ndx));
+    Qxu_.push_back(MatrixXdMap(workspace_.get_data(*offset++), ndx, nu));
+    Quu_.push_back(MatrixXdMap(workspace_.get_data(*offset++), nu, nu));
+    Qx_.push_back(VectorXdMap(workspace_.get_data(*offset++), ndx));
+    Qu_.push_back(VectorXdMap(workspace_.get_data(*offset++), nu));
+    K_.push_back(MatrixXdRowMajorMap(workspace_.get_data(*offset++), nu, ndx));
+    k_.push_back(VectorXdMap(workspace_.get_data(*offset++), nu));
+    fs_.push_back(VectorXdMap(workspace_.get_data(*offset++), ndx));
+    FuTVxx_p_.push_back(MatrixXdRowMajorMap(workspace_.get_data(*offset++), nu, ndx));
+    Quuk_.push_back(VectorXdMap(workspace_.get_data(*offset++), nu));
 
     if (t == 0) {
       xs_try_[t] = problem_->get_x0();
@@ -426,21 +1192,84 @@ void SolverDDP::allocateData() {
     }
     us_try_[t] = Eigen::VectorXd::Zero(nu);
     dx_[t] = Eigen::VectorXd::Zero(ndx);
-
-    FuTVxx_p_[t] = MatrixXdRowMajor::Zero(nu, ndx);
     Quu_llt_[t] = Eigen::LLT<Eigen::MatrixXd>(model->get_nu());
-    Quuk_[t] = Eigen::VectorXd(nu);
   }
-  Vxx_.back() = Eigen::MatrixXd::Zero(ndx, ndx);
-  Vxx_tmp_ = Eigen::MatrixXd::Zero(ndx, ndx);
-  Vx_.back() = Eigen::VectorXd::Zero(ndx);
+  Vxx_.push_back(MatrixXdMap(workspace_.get_data(*offset++), ndx, ndx));
+  Vx_.push_back(VectorXdMap(workspace_.get_data(*offset++), ndx));
+  fs_.push_back(VectorXdMap(workspace_.get_data(*offset++), ndx));
   xs_try_.back() = problem_->get_terminalModel()->get_state()->zero();
-  fs_.back() = Eigen::VectorXd::Zero(ndx);
 
-  FxTVxx_p_ = MatrixXdRowMajor::Zero(ndx, ndx);
+  sweep_ = RiccatiSweepData(ndx, nu);
   fTVxx_p_ = Eigen::VectorXd::Zero(ndx);
+  rti_dx_ = Eigen::VectorXd::Zero(ndx);
+  rti_dx_next_ = Eigen::VectorXd::Zero(ndx);
+  selectFixedSizeKernels();
+}
+
+void SolverDDP::allocatePartitionData(const std::size_t nsegments) {
+  const std::size_t T = problem_->get_T();
+  const std::size_t ndx = problem_->get_ndx();
+  seg_bounds_.resize(nsegments + 1);
+  for (std::size_t s = 0; s <= nsegments; ++s) {
+    seg_bounds_[s] = s * T / nsegments;
+  }
+  seg_elems_.assign(nsegments, RiccatiElement(ndx));
+  seg_nodes_.assign(nsegments, RiccatiElement(ndx));
+  seg_tmps_.assign(nsegments, RiccatiElement(ndx));
+  seg_lu_.assign(nsegments, Eigen::PartialPivLU<Eigen::MatrixXd>(ndx));
+  seg_MA_.assign(nsegments, Eigen::MatrixXd::Zero(ndx, ndx));
+  seg_MC_.assign(nsegments, Eigen::MatrixXd::Zero(ndx, ndx));
+  seg_Mb_.assign(nsegments, Eigen::VectorXd::Zero(ndx));
+  seg_sweeps_.assign(nsegments, RiccatiSweepData(ndx, problem_->get_nu_max()));
+  seg_success_.assign(nsegments, true);
+  suffix_ = RiccatiElement(ndx);
+}
+
+void SolverDDP::allocateLineSearchData(const std::size_t ntrials) {
+  ls_trials_.resize(ntrials);
+  for (std::size_t n = 0; n < ntrials; ++n) {
+    allocateTrialData(ls_trials_[n], n != 0);  // the first trial runs on the problem data
+  }
+}
+
+void SolverDDP::allocateTrialData(LineSearchTrial& trial, const bool own_data) {
+  const std::size_t T = problem_->get_T();
+  const std::vector<boost::shared_ptr<ActionModelAbstract> >& models = problem_->get_runningModels();
+  const boost::shared_ptr<ActionModelAbstract>& model_T = problem_->get_terminalModel();
+  if (trial.xs.size() != T + 1) {
+    trial.xs = xs_try_;
+    trial.us = us_try_;
+    trial.dx = dx_;
+    trial.xnext = xnext_;
+  }
+  if (own_data) {
+    trial.models.resize(T);
+    trial.datas.resize(T);
+    for (std::size_t t = 0; t < T; ++t) {
+      if (trial.models[t] != models[t]) {
+        trial.models[t] = models[t];
+        trial.datas[t] = models[t]->createData();
+      }
+    }
+    if (trial.terminal_model != model_T) {
+      trial.terminal_model = model_T;
+      trial.terminal_data = model_T->createData();
+    }
+  }
 }
 
+BackwardPassType SolverDDP::get_backward_type() const { return backward_type_; }
+
+LineSearchType SolverDDP::get_linesearch_type() const { return linesearch_type_; }
+
+bool SolverDDP::get_fixed_size() const { return fixed_size_; }
+
+bool SolverDDP::get_structured() const { return structured_; }
+
+bool SolverDDP::get_speculative_calcDiff() const { return speculative_; }
+
+bool SolverDDP::get_warm_start_policy() const { return warm_start_policy_; }
+
 double SolverDDP::get_reg_incfactor() const { return reg_incfactor_; }
 
 double SolverDDP::get_reg_decfactor() const { return reg_decfactor_; }
@@ -465,25 +1294,47 @@ double SolverDDP::get_th_grad() const { return th_grad_; }
 
 double SolverDDP::get_th_gaptol() const { return th_gaptol_; }
 
-const std::vector<Eigen::MatrixXd>& SolverDDP::get_Vxx() const { return Vxx_; }
+const std::vector<SolverDDP::MatrixXdMap>& SolverDDP::get_Vxx() const { return Vxx_; }
+
+const std::vector<SolverDDP::VectorXdMap>& SolverDDP::get_Vx() const { return Vx_; }
+
+const std::vector<SolverDDP::MatrixXdMap>& SolverDDP::get_Qxx() const { return Qxx_; }
+
+const std::vector<SolverDDP::MatrixXdMap>& SolverDDP::get_Qxu() const { return Qxu_; }
 
-const std::vector<Eigen::VectorXd>& SolverDDP::get_Vx() const { return Vx_; }
+const std::vector<SolverDDP::MatrixXdMap>& SolverDDP::get_Quu() const { return Quu_; }
 
-const std::vector<Eigen::MatrixXd>& SolverDDP::get_Qxx() const { return Qxx_; }
+const std::vector<SolverDDP::VectorXdMap>& SolverDDP::get_Qx() const { return Qx_; }
 
-const std::vector<Eigen::MatrixXd>& SolverDDP::get_Qxu() const { return Qxu_; }
+const std::vector<SolverDDP::VectorXdMap>& SolverDDP::get_Qu() const { return Qu_; }
 
-const std::vector<Eigen::MatrixXd>& SolverDDP::get_Quu() const { return Quu_; }
+const std::vector<SolverDDP::MatrixXdRowMajorMap>& SolverDDP::get_K() const { return K_; }
 
-const std::vector<Eigen::VectorXd>& SolverDDP::get_Qx() const { return Qx_; }
+const std::vector<SolverDDP::VectorXdMap>& SolverDDP::get_k() const { return k_; }
 
-const std::vector<Eigen::VectorXd>& SolverDDP::get_Qu() const { return Qu_; }
+const std::vector<SolverDDP::VectorXdMap>& SolverDDP::get_fs() const { return fs_; }
 
-const std::vector<typename MathBaseTpl<double>::MatrixXsRowMajor>& SolverDDP::get_K() const { return K_; }
+std::size_t SolverDDP::get_workspace_size() const { return workspace_.get_size(); }
 
-const std::vector<Eigen::VectorXd>& SolverDDP::get_k() const { return k_; }
+const std::vector<std::size_t>& SolverDDP::get_workspace_nodes() const { return workspace_nodes_; }
 
-const std::vector<Eigen::VectorXd>& SolverDDP::get_fs() const { return fs_; }
+void SolverDDP::set_backward_type(const BackwardPassType type) { backward_type_ = type; }
+
+void SolverDDP::set_linesearch_type(const LineSearchType type) { linesearch_type_ = type; }
+
+void SolverDDP::set_fixed_size(const bool fixed_size) { fixed_size_ = fixed_size; }
+
+void SolverDDP::set_structured(const bool structured) { structured_ = structured; }
+
+void SolverDDP::set_speculative_calcDiff(const bool speculative) { speculative_ = speculative; }
+
+void SolverDDP::set_warm_start_policy(const bool warm_start) { warm_start_policy_ = warm_start; }
+
+void SolverDDP::set_workspace(double* block) {
+  workspace_block_ = block;
+  workspace_block_size_ = workspace_.get_size();
+  allocateData();
+}
 
 void SolverDDP::set_reg_incfactor(const double regfactor) {
   if (regfactor <= 1.) {
@@ -6,9 +6,7 @@
 // All rights reserved.
 ///////////////////////////////////////////////////////////////////////////////
 
-#ifdef CROCODDYL_WITH_MULTITHREADING
-#include <omp.h>
-#endif  // CROCODDYL_WITH_MULTITHREADING
+#include <limits>
 
 #include "crocoddyl/core/utils/exception.hpp"
 #include "crocoddyl/core/solvers/fddp.hpp"
@@ -16,27 +14,45 @@
 namespace crocoddyl {
 
 SolverFDDP::SolverFDDP(boost::shared_ptr<ShootingProblem> problem)
-    : SolverDDP(problem), dg_(0), dq_(0), dv_(0), th_acceptnegstep_(2) {}
+    : SolverDDP(problem),
+      dg_(0),
+      dq_(0),
+      dv_(0),
+      forward_type_(ForwardPassSerial),
+      th_acceptnegstep_(2),
+      th_boundgap_(1e-9),
+      roll_gap_(0.),
+      deadline_(std::numeric_limits<double>::infinity()),
+      deadline_phase_(DeadlineNotReached),
+      direction_outdated_(true) {}
 
 SolverFDDP::~SolverFDDP() {}
 
 bool SolverFDDP::solve(const std::vector<Eigen::VectorXd>& init_xs, const std::vector<Eigen::VectorXd>& init_us,
                        const std::size_t maxiter, const bool is_feasible, const double reginit) {
+  deadline_timer_.reset();
+  deadline_phase_ = DeadlineNotReached;
+  direction_outdated_ = true;
   xs_try_[0] = problem_->get_x0();  // it is needed in case that init_xs[0] is infeasible
   setCandidate(init_xs, init_us, is_feasible);
 
-  if (std::isnan(reginit)) {
-    xreg_ = reg_min_;
-    ureg_ = reg_min_;
-  } else {
-    xreg_ = reginit;
-    ureg_ = reginit;
+  if (!applyWarmStart()) {
+    if (std::isnan(reginit)) {
+      xreg_ = reg_min_;
+      ureg_ = reg_min_;
+    } else {
+      xreg_ = reginit;
+      ureg_ = reginit;
+    }
   }
   was_feasible_ = false;
 
   bool recalcDiff = true;
   for (iter_ = 0; iter_ < maxiter; ++iter_) {
     while (true) {
+      if (checkDeadline(DeadlineComputeDirection)) {
+        return false;
+      }
       try {
         computeDirection(recalcDiff);
       } catch (std::exception& e) {
@@ -50,15 +66,20 @@ bool SolverFDDP::solve(const std::vector<Eigen::VectorXd>& init_xs, const std::v
       }
       break;
     }
+    direction_outdated_ = false;
     updateExpectedImprovement();
 
     // We need to recalculate the derivatives when the step length passes
     recalcDiff = false;
-    for (std::vector<double>::const_iterator it = alphas_.begin(); it != alphas_.end(); ++it) {
-      steplength_ = *it;
+    for (std::size_t i = 0; i < alphas_.size(); ++i) {
+      if (checkDeadline(DeadlineLineSearch)) {
+        return false;
+      }
+      steplength_ = alphas_[i];
+      roll_gap_ = 0.;  // only the partitioned rollout leaves gaps, and the other rollouts do not write it
 
       try {
-        dV_ = tryStep(steplength_);
+        dV_ = tryLineSearchStep(i);
       } catch (std::exception& e) {
         continue;
       }
@@ -68,17 +89,19 @@ bool SolverFDDP::solve(const std::vector<Eigen::VectorXd>& init_xs, const std::v
       if (dVexp_ >= 0) {  // descend direction
         if (d_[0] < th_grad_ || dV_ > th_acceptstep_ * dVexp_) {
           was_feasible_ = is_feasible_;
-          setCandidate(xs_try_, us_try_, (was_feasible_) || (steplength_ == 1));
+          setCandidate(xs_try_, us_try_, isStepFeasible());
           cost_ = cost_try_;
           recalcDiff = true;
+          direction_outdated_ = true;
           break;
         }
       } else {  // reducing the gaps by allowing a small increment in the cost value
         if (dV_ > th_acceptnegstep_ * dVexp_) {
           was_feasible_ = is_feasible_;
-          setCandidate(xs_try_, us_try_, (was_feasible_) || (steplength_ == 1));
+          setCandidate(xs_try_, us_try_, isStepFeasible());
           cost_ = cost_try_;
           recalcDiff = true;
+          direction_outdated_ = true;
           break;
         }
       }
@@ -153,47 +176,59 @@ void SolverFDDP::updateExpectedImprovement() {
 }
 
 void SolverFDDP::forwardPass(const double steplength) {
+  if (forward_type_ == ForwardPassPartitioned) {
+    forwardPassPartitioned(steplength);
+    return;
+  }
   if (steplength > 1. || steplength < 0.) {
     throw_pretty("Invalid argument: "
                  << "invalid step length, value is between 0. to 1.");
   }
-  cost_try_ = 0.;
-  xnext_ = problem_->get_x0();
+  cost_try_ = computeRollout(steplength, problem_->get_runningDatas(), problem_->get_terminalData(), xs_try_, us_try_,
+                             dx_, xnext_);
+}
+
+double SolverFDDP::computeRollout(const double steplength,
+                                  const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas,
+                                  const boost::shared_ptr<ActionDataAbstract>& data_T,
+                                  std::vector<Eigen::VectorXd>& xs_try, std::vector<Eigen::VectorXd>& us_try,
+                                  std::vector<Eigen::VectorXd>& dx, Eigen::VectorXd& xnext) {
+  double cost_try = 0.;
+  xnext = problem_->get_x0();
   const std::size_t T = problem_->get_T();
   const std::vector<boost::shared_ptr<ActionModelAbstract> >& models = problem_->get_runningModels();
-  const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas = problem_->get_runningDatas();
   if ((is_feasible_) || (steplength == 1)) {
     for (std::size_t t = 0; t < T; ++t) {
       const boost::shared_ptr<ActionModelAbstract>& m = models[t];
       const boost::shared_ptr<ActionDataAbstract>& d = datas[t];
       const std::size_t nu = m->get_nu();
 
-      xs_try_[t] = xnext_;
-      m->get_state()->diff(xs_[t], xs_try_[t], dx_[t]);
+      xs_try[t] = xnext;
+      m->get_state()->diff(xs_[t], xs_try[t], dx[t]);
       if (nu != 0) {
-        us_try_[t].head(nu).noalias() = us_[t].head(nu) - k_[t].head(nu) * steplength - K_[t].topRows(nu) * dx_[t];
-        m->calc(d, xs_try_[t], us_try_[t].head(nu));
+        us_try[t].head(nu).noalias() = us_[t].head(nu) - k_[t].head(nu) * steplength - K_[t].topRows(nu) * dx[t];
+        m->calc(d, xs_try[t], us_try[t].head(nu));
       } else {
-        m->calc(d, xs_try_[t]);
+        m->calc(d, xs_try[t]);
       }
-      xnext_ = d->xnext;
-      cost_try_ += d->cost;
+      xnext = d->xnext;
+      cost_try += d->cost;
 
-      if (raiseIfNaN(cost_try_)) {
+      if (raiseIfNaN(cost_try)) {
         throw_pretty("forward_error");
       }
-      if (raiseIfNaN(xnext_.lpNorm<Eigen::Infinity>())) {
+      if (raiseIfNaN(xnext.lpNorm<Eigen::Infinity>())) {
         throw_pretty("forward_error");
       }
+      notifyRolloutNode(t);
     }
 
     const boost::shared_ptr<ActionModelAbstract>& m = problem_->get_terminalModel();
-    const boost::shared_ptr<ActionDataAbstract>& d = problem_->get_terminalData();
-    xs_try_.back() = xnext_;
-    m->calc(d, xs_try_.back());
-    cost_try_ += d->cost;
+    xs_try.back() = xnext;
+    m->calc(data_T, xs_try.back());
+    cost_try += data_T->cost;
 
-    if (raiseIfNaN(cost_try_)) {
+    if (raiseIfNaN(cost_try)) {
       throw_pretty("forward_error");
     }
   } else {
@@ -201,39 +236,200 @@ void SolverFDDP::forwardPass(const double steplength) {
       const boost::shared_ptr<ActionModelAbstract>& m = models[t];
       const boost::shared_ptr<ActionDataAbstract>& d = datas[t];
       const std::size_t nu = m->get_nu();
-      m->get_state()->integrate(xnext_, fs_[t] * (steplength - 1), xs_try_[t]);
-      m->get_state()->diff(xs_[t], xs_try_[t], dx_[t]);
+      m->get_state()->integrate(xnext, fs_[t] * (steplength - 1), xs_try[t]);
+      m->get_state()->diff(xs_[t], xs_try[t], dx[t]);
       if (nu != 0) {
-        us_try_[t].head(nu).noalias() = us_[t].head(nu) - k_[t].head(nu) * steplength - K_[t].topRows(nu) * dx_[t];
-        m->calc(d, xs_try_[t], us_try_[t].head(nu));
+        us_try[t].head(nu).noalias() = us_[t].head(nu) - k_[t].head(nu) * steplength - K_[t].topRows(nu) * dx[t];
+        m->calc(d, xs_try[t], us_try[t].head(nu));
       } else {
-        m->calc(d, xs_try_[t]);
+        m->calc(d, xs_try[t]);
       }
-      xnext_ = d->xnext;
-      cost_try_ += d->cost;
+      xnext = d->xnext;
+      cost_try += d->cost;
 
-      if (raiseIfNaN(cost_try_)) {
+      if (raiseIfNaN(cost_try)) {
         throw_pretty("forward_error");
       }
-      if (raiseIfNaN(xnext_.lpNorm<Eigen::Infinity>())) {
+      if (raiseIfNaN(xnext.lpNorm<Eigen::Infinity>())) {
         throw_pretty("forward_error");
       }
+      notifyRolloutNode(t);
     }
 
     const boost::shared_ptr<ActionModelAbstract>& m = problem_->get_terminalModel();
-    const boost::shared_ptr<ActionDataAbstract>& d = problem_->get_terminalData();
-    m->get_state()->integrate(xnext_, fs_.back() * (steplength - 1), xs_try_.back());
-    m->calc(d, xs_try_.back());
-    cost_try_ += d->cost;
+    m->get_state()->integrate(xnext, fs_.back() * (steplength - 1), xs_try.back());
+    m->calc(data_T, xs_try.back());
+    cost_try += data_T->cost;
+
+    if (raiseIfNaN(cost_try)) {
+      throw_pretty("forward_error");
+    }
+  }
+  return cost_try;
+}
+
+void SolverFDDP::forwardPassPartitioned(const double steplength, const bool clamp) {
+  if (steplength > 1. || steplength < 0.) {
+    throw_pretty("Invalid argument: "
+                 << "invalid step length, value is between 0. to 1.");
+  }
+  const std::size_t T = problem_->get_T();
+  const std::size_t nsegments = std::max(std::min(problem_->get_nthreads(), T), std::size_t(1));
+  if (roll_bounds_.size() != nsegments + 1 || roll_bounds_.back() != T) {
+    allocateRolloutData(nsegments);
+  }
+  const std::vector<boost::shared_ptr<ActionModelAbstract> >& models = problem_->get_runningModels();
+  const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas = problem_->get_runningDatas();
+  const bool close_gaps = is_feasible_ || steplength == 1;
+
+  // Predict the state deviation at the segment boundaries with the linearized dynamics
+  if (is_feasible_) {
+    dx_lin_.setZero();
+  } else {
+    dx_lin_ = fs_[0] * steplength;
+  }
+  for (std::size_t t = 0, s = 1; s < nsegments; ++t) {
+    if (t == roll_bounds_[s]) {
+      roll_dx_[s] = dx_lin_;
+      if (++s == nsegments) {
+        break;
+      }
+    }
+    const boost::shared_ptr<ActionModelAbstract>& m = models[t];
+    const boost::shared_ptr<ActionDataAbstract>& d = datas[t];
+    const std::size_t nu = m->get_nu();
+    dx_lin_next_.noalias() = d->Fx * dx_lin_;
+    if (nu != 0) {
+      us_try_[t].head(nu).noalias() = us_[t].head(nu) - k_[t].head(nu) * steplength - K_[t].topRows(nu) * dx_lin_;
+      if (clamp && m->get_has_control_limits()) {
+        us_try_[t].head(nu) = us_try_[t].head(nu).cwiseMax(m->get_u_lb()).cwiseMin(m->get_u_ub());
+      }
+      us_try_[t].head(nu) -= us_[t].head(nu);
+      dx_lin_next_.noalias() += d->Fu * us_try_[t].head(nu);
+    }
+    if (!is_feasible_) {
+      dx_lin_next_ += fs_[t + 1] * steplength;
+    }
+    dx_lin_.swap(dx_lin_next_);
+  }
+
+  // Run the nonlinear rollout of each segment
+  roll_xnext_[0] = problem_->get_x0();
+  problem_->get_scheduler()->parallelFor(nsegments, [&](const std::size_t s) {
+    Eigen::VectorXd& xnext = roll_xnext_[s];
+    double& cost = roll_cost_[s];
+    cost = 0.;
+    roll_success_[s] = true;
+    try {
+      for (std::size_t t = roll_bounds_[s]; t < roll_bounds_[s + 1]; ++t) {
+        const boost::shared_ptr<ActionModelAbstract>& m = models[t];
+        const boost::shared_ptr<ActionDataAbstract>& d = datas[t];
+        const std::size_t nu = m->get_nu();
+        if (s > 0 && t == roll_bounds_[s]) {
+          m->get_state()->integrate(xs_[t], roll_dx_[s], xs_try_[t]);
+        } else if (close_gaps) {
+          xs_try_[t] = xnext;
+        } else {
+          m->get_state()->integrate(xnext, fs_[t] * (steplength - 1), xs_try_[t]);
+        }
+        m->get_state()->diff(xs_[t], xs_try_[t], dx_[t]);
+        if (nu != 0) {
+          us_try_[t].head(nu).noalias() =
+              us_[t].head(nu) - k_[t].head(nu) * steplength - K_[t].topRows(nu) * dx_[t];
+          if (clamp && m->get_has_control_limits()) {
+            us_try_[t].head(nu) = us_try_[t].head(nu).cwiseMax(m->get_u_lb()).cwiseMin(m->get_u_ub());
+          }
+          m->calc(d, xs_try_[t], us_try_[t].head(nu));
+        } else {
+          m->calc(d, xs_try_[t]);
+        }
+        xnext = d->xnext;
+        cost += d->cost;
 
-    if (raiseIfNaN(cost_try_)) {
+        if (raiseIfNaN(cost) || raiseIfNaN(xnext.lpNorm<Eigen::Infinity>())) {
+          roll_success_[s] = false;
+          break;
+        }
+      }
+    } catch (std::exception& e) {
+      roll_success_[s] = false;
+    }
+  });
+  cost_try_ = 0.;
+  for (std::size_t s = 0; s < nsegments; ++s) {
+    if (!roll_success_[s]) {
       throw_pretty("forward_error");
     }
+    cost_try_ += roll_cost_[s];
+  }
+
+  // Measure the gaps left at the segment boundaries
+  roll_gap_ = 0.;
+  for (std::size_t s = 1; s < nsegments; ++s) {
+    const std::size_t t = roll_bounds_[s];
+    models[t]->get_state()->diff(xs_try_[t], roll_xnext_[s - 1], roll_fs_);
+    roll_gap_ = std::max(roll_gap_, roll_fs_.lpNorm<Eigen::Infinity>());
+  }
+
+  const boost::shared_ptr<ActionModelAbstract>& m = problem_->get_terminalModel();
+  const boost::shared_ptr<ActionDataAbstract>& d = problem_->get_terminalData();
+  if (close_gaps) {
+    xs_try_.back() = roll_xnext_.back();
+  } else {
+    m->get_state()->integrate(roll_xnext_.back(), fs_.back() * (steplength - 1), xs_try_.back());
+  }
+  m->calc(d, xs_try_.back());
+  cost_try_ += d->cost;
+
+  if (raiseIfNaN(cost_try_)) {
+    throw_pretty("forward_error");
+  }
+}
+
+void SolverFDDP::allocateRolloutData(const std::size_t nsegments) {
+  const std::size_t T = problem_->get_T();
+  const std::size_t nx = problem_->get_nx();
+  const std::size_t ndx = problem_->get_ndx();
+  roll_bounds_.resize(nsegments + 1);
+  for (std::size_t s = 0; s <= nsegments; ++s) {
+    roll_bounds_[s] = s * T / nsegments;
   }
+  roll_dx_.assign(nsegments, Eigen::VectorXd::Zero(ndx));
+  roll_xnext_.assign(nsegments, Eigen::VectorXd::Zero(nx));
+  roll_cost_.assign(nsegments, 0.);
+  roll_success_.assign(nsegments, true);
+  roll_fs_ = Eigen::VectorXd::Zero(ndx);
+  dx_lin_ = Eigen::VectorXd::Zero(ndx);
+  dx_lin_next_ = Eigen::VectorXd::Zero(ndx);
+}
+
+bool SolverFDDP::isStepFeasible() const {
+  if (!was_feasible_ && steplength_ != 1) {
+    return false;
+  }
+  return roll_gap_ <= th_boundgap_;
+}
+
+bool SolverFDDP::checkDeadline(const DeadlinePhase phase) {
+  if (deadline_timer_.get_duration() >= deadline_) {
+    deadline_phase_ = phase;
+    return true;
+  }
+  return false;
 }
 
 double SolverFDDP::get_th_acceptnegstep() const { return th_acceptnegstep_; }
 
+ForwardPassType SolverFDDP::get_forward_type() const { return forward_type_; }
+
+double SolverFDDP::get_th_boundgap() const { return th_boundgap_; }
+
+double SolverFDDP::get_deadline() const { return deadline_; }
+
+DeadlinePhase SolverFDDP::get_deadline_phase() const { return deadline_phase_; }
+
+bool SolverFDDP::get_direction_outdated() const { return direction_outdated_; }
+
 void SolverFDDP::set_th_acceptnegstep(const double th_acceptnegstep) {
   if (0. > th_acceptnegstep) {
     throw_pretty("Invalid argument: "
@@ -242,4 +438,22 @@ void SolverFDDP::set_th_acceptnegstep(const double th_acceptnegstep) {
   th_acceptnegstep_ = th_acceptnegstep;
 }
 
+void SolverFDDP::set_forward_type(const ForwardPassType type) { forward_type_ = type; }
+
+void SolverFDDP::set_th_boundgap(const double th_boundgap) {
+  if (0. > th_boundgap) {
+    throw_pretty("Invalid argument: "
+                 << "th_boundgap value has to be positive.");
+  }
+  th_boundgap_ = th_boundgap;
+}
+
+void SolverFDDP::set_deadline(const double deadline) {
+  if (0. >= deadline) {
+    throw_pretty("Invalid argument: "
+                 << "deadline value has to be positive.");
+  }
+  deadline_ = deadline;
+}
+
 }  // namespace crocoddyl
@@ -8,6 +8,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "crocoddyl/core/solvers/kkt.hpp"
+#include "crocoddyl/core/utils/exception.hpp"
 
 namespace crocoddyl {
 
@@ -18,6 +19,7 @@ SolverKKT::SolverKKT(boost::shared_ptr<ShootingProblem> problem)
       reg_min_(1e-9),
       reg_max_(1e9),
       cost_try_(0.),
+      factorization_type_(KKTFactorizationRiccati),
       th_grad_(1e-12),
       was_feasible_(false) {
   allocateData();
@@ -154,12 +156,39 @@ const Eigen::Vector2d& SolverKKT::expectedImprovement() {
   // -grad^T.primal
   d_(0) = -kktref_.segment(0, ndx_ + nu_).dot(primal_);
   // -(hessian.primal)^T.primal
-  kkt_primal_.noalias() = kkt_.block(0, 0, ndx_ + nu_, ndx_ + nu_) * primal_;
+  if (factorization_type_ == KKTFactorizationDense) {
+    kkt_primal_.noalias() = kkt_.block(0, 0, ndx_ + nu_, ndx_ + nu_) * primal_;
+  } else {
+    std::size_t ix = 0;
+    std::size_t iu = 0;
+    const std::size_t T = problem_->get_T();
+    const std::vector<boost::shared_ptr<ActionModelAbstract> >& models = problem_->get_runningModels();
+    const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas = problem_->get_runningDatas();
+    for (std::size_t t = 0; t < T; ++t) {
+      const boost::shared_ptr<ActionDataAbstract>& d = datas[t];
+      const std::size_t ndxi = models[t]->get_state()->get_ndx();
+      const std::size_t nui = models[t]->get_nu();
+      kkt_primal_.segment(ix, ndxi).noalias() = d->Lxx * dxs_[t];
+      kkt_primal_.segment(ix, ndxi).noalias() += d->Lxu * dus_[t];
+      kkt_primal_.segment(ndx_ + iu, nui).noalias() = d->Lxu.transpose() * dxs_[t];
+      kkt_primal_.segment(ndx_ + iu, nui).noalias() += d->Luu * dus_[t];
+      ix += ndxi;
+      iu += nui;
+    }
+    const std::size_t ndxf = problem_->get_terminalModel()->get_state()->get_ndx();
+    kkt_primal_.segment(ix, ndxf).noalias() = problem_->get_terminalData()->Lxx * dxs_.back();
+  }
   d_(1) = -kkt_primal_.dot(primal_);
   return d_;
 }
 
-const Eigen::MatrixXd& SolverKKT::get_kkt() const { return kkt_; }
+const Eigen::MatrixXd& SolverKKT::get_kkt() const {
+  if (factorization_type_ != KKTFactorizationDense) {
+    kkt_.setZero(2 * ndx_ + nu_, 2 * ndx_ + nu_);
+    assembleKKT(kkt_);
+  }
+  return kkt_;
+}
 
 const Eigen::VectorXd& SolverKKT::get_kktref() const { return kktref_; }
 
@@ -177,9 +206,20 @@ std::size_t SolverKKT::get_ndx() const { return ndx_; }
 
 std::size_t SolverKKT::get_nu() const { return nu_; }
 
+KKTFactorizationType SolverKKT::get_factorization_type() const { return factorization_type_; }
+
+void SolverKKT::set_factorization_type(const KKTFactorizationType type) {
+  factorization_type_ = type;
+  if (factorization_type_ == KKTFactorizationDense) {
+    kkt_.setZero(2 * ndx_ + nu_, 2 * ndx_ + nu_);
+    assembleKKT(kkt_);
+  } else {
+    kkt_.resize(0, 0);
+  }
+}
+
 double SolverKKT::calcDiff() {
-  cost_ = problem_->calc(xs_, us_);
-  cost_ = problem_->calcDiff(xs_, us_);
+  cost_ = problem_->calcAndDiff(xs_, us_);
 
   // offset on constraint xnext = f(x,u) due to x0 = ref.
   const std::size_t cx0 = problem_->get_runningModels()[0]->get_state()->get_ndx();
@@ -187,7 +227,6 @@ double SolverKKT::calcDiff() {
   std::size_t ix = 0;
   std::size_t iu = 0;
   const std::size_t T = problem_->get_T();
-  kkt_.block(ndx_ + nu_, 0, ndx_, ndx_) = Eigen::MatrixXd::Identity(ndx_, ndx_);
   for (std::size_t t = 0; t < T; ++t) {
     const boost::shared_ptr<ActionModelAbstract>& m = problem_->get_runningModels()[t];
     const boost::shared_ptr<ActionDataAbstract>& d = problem_->get_runningDatas()[t];
@@ -199,14 +238,6 @@ double SolverKKT::calcDiff() {
       m->get_state()->diff(problem_->get_x0(), xs_[0], kktref_.segment(ndx_ + nu_, ndxi));
     }
 
-    // Filling KKT matrix
-    kkt_.block(ix, ix, ndxi, ndxi) = d->Lxx;
-    kkt_.block(ix, ndx_ + iu, ndxi, nui) = d->Lxu;
-    kkt_.block(ndx_ + iu, ix, nui, ndxi) = d->Lxu.transpose();
-    kkt_.block(ndx_ + iu, ndx_ + iu, nui, nui) = d->Luu;
-    kkt_.block(ndx_ + nu_ + cx0 + ix, ix, ndxi, ndxi) = -d->Fx;
-    kkt_.block(ndx_ + nu_ + cx0 + ix, ndx_ + iu, ndxi, nui) = -d->Fu;
-
     // Filling KKT vector
     kktref_.segment(ix, ndxi) = d->Lx;
     kktref_.segment(ndx_ + iu, nui) = d->Lu;
@@ -217,16 +248,141 @@ double SolverKKT::calcDiff() {
   }
   const boost::shared_ptr<ActionDataAbstract>& df = problem_->get_terminalData();
   const std::size_t ndxf = problem_->get_terminalModel()->get_state()->get_ndx();
-  kkt_.block(ix, ix, ndxf, ndxf) = df->Lxx;
   kktref_.segment(ix, ndxf) = df->Lx;
-  kkt_.block(0, ndx_ + nu_, ndx_ + nu_, ndx_) = kkt_.block(ndx_ + nu_, 0, ndx_, ndx_ + nu_).transpose();
+
+  // Filling KKT matrix, the Riccati factorization reads the node blocks from the action data instead
+  if (factorization_type_ == KKTFactorizationDense) {
+    assembleKKT(kkt_);
+  }
   return cost_;
 }
 
+void SolverKKT::assembleKKT(Eigen::MatrixXd& kkt) const {
+  // offset on constraint xnext = f(x,u) due to x0 = ref.
+  const std::size_t cx0 = problem_->get_runningModels()[0]->get_state()->get_ndx();
+
+  std::size_t ix = 0;
+  std::size_t iu = 0;
+  const std::size_t T = problem_->get_T();
+  kkt.block(ndx_ + nu_, 0, ndx_, ndx_) = Eigen::MatrixXd::Identity(ndx_, ndx_);
+  for (std::size_t t = 0; t < T; ++t) {
+    const boost::shared_ptr<ActionModelAbstract>& m = problem_->get_runningModels()[t];
+    const boost::shared_ptr<ActionDataAbstract>& d = problem_->get_runningDatas()[t];
+    const std::size_t ndxi = m->get_state()->get_ndx();
+    const std::size_t nui = m->get_nu();
+
+    kkt.block(ix, ix, ndxi, ndxi) = d->Lxx;
+    kkt.block(ix, ndx_ + iu, ndxi, nui) = d->Lxu;
+    kkt.block(ndx_ + iu, ix, nui, ndxi) = d->Lxu.transpose();
+    kkt.block(ndx_ + iu, ndx_ + iu, nui, nui) = d->Luu;
+    kkt.block(ndx_ + nu_ + cx0 + ix, ix, ndxi, ndxi) = -d->Fx;
+    kkt.block(ndx_ + nu_ + cx0 + ix, ndx_ + iu, ndxi, nui) = -d->Fu;
+
+    ix += ndxi;
+    iu += nui;
+  }
+  const boost::shared_ptr<ActionDataAbstract>& df = problem_->get_terminalData();
+  const std::size_t ndxf = problem_->get_terminalModel()->get_state()->get_ndx();
+  kkt.block(ix, ix, ndxf, ndxf) = df->Lxx;
+  kkt.block(0, ndx_ + nu_, ndx_ + nu_, ndx_) = kkt.block(ndx_ + nu_, 0, ndx_, ndx_ + nu_).transpose();
+}
+
 void SolverKKT::computePrimalDual() {
-  primaldual_ = kkt_.lu().solve(-kktref_);
-  primal_ = primaldual_.segment(0, ndx_ + nu_);
-  dual_ = primaldual_.segment(ndx_ + nu_, ndx_);
+  if (factorization_type_ == KKTFactorizationDense) {
+    primaldual_ = kkt_.lu().solve(-kktref_);
+    primal_ = primaldual_.segment(0, ndx_ + nu_);
+    dual_ = primaldual_.segment(ndx_ + nu_, ndx_);
+  } else {
+    computePrimalDualRiccati();
+  }
+}
+
+void SolverKKT::computePrimalDualRiccati() {
+  const std::size_t T = problem_->get_T();
+  const std::vector<boost::shared_ptr<ActionModelAbstract> >& models = problem_->get_runningModels();
+  const std::vector<boost::shared_ptr<ActionDataAbstract> >& datas = problem_->get_runningDatas();
+  const std::size_t ndx_c = ndx_ + nu_;  // offset of the constraint rows
+  const std::size_t cx0 = models[0]->get_state()->get_ndx();
+
+  // Backward recursion, where the dynamics constraint of each node reads dx' = Fx dx + Fu du - c
+  const std::size_t ndxf = problem_->get_terminalModel()->get_state()->get_ndx();
+  std::size_t ix = ndx_ - ndxf;
+  P_.back() = problem_->get_terminalData()->Lxx;
+  p_.back() = problem_->get_terminalData()->Lx;
+  for (std::size_t t = T; t-- > 0;) {
+    const boost::shared_ptr<ActionDataAbstract>& d = datas[t];
+    const std::size_t ndxi = models[t]->get_state()->get_ndx();
+    const std::size_t nui = models[t]->get_nu();
+    const Eigen::VectorBlock<Eigen::VectorXd, Eigen::Dynamic> c = kktref_.segment(ndx_c + cx0 + ix - ndxi, ndxi);
+    ix -= ndxi;
+
+    Pb_ = p_[t + 1];
+    Pb_.noalias() -= P_[t + 1] * c;
+    FxTP_.noalias() = d->Fx.transpose() * P_[t + 1];
+    P_[t] = d->Lxx;
+    P_[t].noalias() += FxTP_ * d->Fx;
+    p_[t] = d->Lx;
+    p_[t].noalias() += d->Fx.transpose() * Pb_;
+    if (nui != 0) {
+      Eigen::Block<Eigen::MatrixXd, Eigen::Dynamic, Eigen::Dynamic, true> Qxu = Qxu_.leftCols(nui);
+      Eigen::Block<Eigen::MatrixXd> Quu = Quu_.topLeftCorner(nui, nui);
+      Eigen::VectorBlock<Eigen::VectorXd, Eigen::Dynamic> Qu = Qu_.head(nui);
+      Qxu = d->Lxu;
+      Qxu.noalias() += FxTP_ * d->Fu;
+      FuTP_.topRows(nui).noalias() = d->Fu.transpose() * P_[t + 1];
+      Quu = d->Luu;
+      Quu.noalias() += FuTP_.topRows(nui) * d->Fu;
+      Qu = d->Lu;
+      Qu.noalias() += d->Fu.transpose() * Pb_;
+
+      // du = k + K dx, with K = -Quu^{-1} Qux and k = -Quu^{-1} Qu
+      Quu_ldlt_[t].compute(Quu);
+      if (Quu_ldlt_[t].info() != Eigen::Success) {
+        throw_pretty("backward_error");
+      }
+      K_[t] = -Qxu.transpose();
+      Quu_ldlt_[t].solveInPlace(K_[t]);
+      k_[t] = -Qu;
+      Quu_ldlt_[t].solveInPlace(k_[t]);
+      P_[t].noalias() += Qxu * K_[t];
+      p_[t].noalias() += Qxu * k_[t];
+      P_tmp_ = 0.5 * (P_[t] + P_[t].transpose());
+      P_[t] = P_tmp_;
+    }
+    if (raiseIfNaN(p_[t].lpNorm<Eigen::Infinity>()) || raiseIfNaN(P_[t].lpNorm<Eigen::Infinity>())) {
+      throw_pretty("backward_error");
+    }
+  }
+
+  // Forward recursion of the primal direction and the multipliers
+  dxs_[0] = -kktref_.segment(ndx_c, cx0);
+  ix = 0;
+  std::size_t iu = 0;
+  for (std::size_t t = 0; t < T; ++t) {
+    const boost::shared_ptr<ActionDataAbstract>& d = datas[t];
+    const std::size_t ndxi = models[t]->get_state()->get_ndx();
+    const std::size_t nui = models[t]->get_nu();
+    lambdas_[t] = -p_[t];
+    lambdas_[t].noalias() -= P_[t] * dxs_[t];
+    dxs_[t + 1] = -kktref_.segment(ndx_c + cx0 + ix, ndxi);
+    dxs_[t + 1].noalias() += d->Fx * dxs_[t];
+    if (nui != 0) {
+      dus_[t] = k_[t];
+      dus_[t].noalias() += K_[t] * dxs_[t];
+      dxs_[t + 1].noalias() += d->Fu * dus_[t];
+    }
+    primal_.segment(ix, ndxi) = dxs_[t];
+    primal_.segment(ndx_ + iu, nui) = dus_[t];
+    dual_.segment(ix, ndxi) = lambdas_[t];
+    ix += ndxi;
+    iu += nui;
+  }
+  lambdas_.back() = -p_.back();
+  lambdas_.back().noalias() -= P_.back() * dxs_.back();
+  primal_.segment(ix, ndxf) = dxs_.back();
+  dual_.segment(ix, ndxf) = lambdas_.back();
+  primaldual_.head(ndx_ + nu_) = primal_;
+  primaldual_.tail(ndx_) = dual_;
 }
 
 void SolverKKT::increaseRegularization() {
@@ -250,6 +406,11 @@ void SolverKKT::allocateData() {
   dxs_.resize(T + 1);
   dus_.resize(T);
   lambdas_.resize(T + 1);
+  P_.resize(T + 1);
+  p_.resize(T + 1);
+  K_.resize(T);
+  k_.resize(T);
+  Quu_ldlt_.resize(T);
   xs_try_.resize(T + 1);
   us_try_.resize(T);
 
@@ -269,6 +430,11 @@ void SolverKKT::allocateData() {
     dxs_[t] = Eigen::VectorXd::Zero(ndx);
     dus_[t] = Eigen::VectorXd::Zero(nu);
     lambdas_[t] = Eigen::VectorXd::Zero(ndx);
+    P_[t] = Eigen::MatrixXd::Zero(ndx, ndx);
+    p_[t] = Eigen::VectorXd::Zero(ndx);
+    K_[t] = Eigen::MatrixXd::Zero(nu, ndx);
+    k_[t] = Eigen::VectorXd::Zero(nu);
+    Quu_ldlt_[t] = Eigen::LDLT<Eigen::MatrixXd>(nu);
     nx_ += nx;
     ndx_ += ndx;
     nu_ += nu;
@@ -279,10 +445,13 @@ void SolverKKT::allocateData() {
   xs_try_.back() = problem_->get_terminalModel()->get_state()->zero();
   dxs_.back() = Eigen::VectorXd::Zero(model->get_state()->get_ndx());
   lambdas_.back() = Eigen::VectorXd::Zero(model->get_state()->get_ndx());
+  P_.back() = Eigen::MatrixXd::Zero(model->get_state()->get_ndx(), model->get_state()->get_ndx());
+  p_.back() = Eigen::VectorXd::Zero(model->get_state()->get_ndx());
 
-  // Set dimensions for kkt matrix and kkt_ref vector
-  kkt_.resize(2 * ndx_ + nu_, 2 * ndx_ + nu_);
-  kkt_.setZero();
+  // Set dimensions for kkt matrix (only needed by the dense factorization) and kkt_ref vector
+  if (factorization_type_ == KKTFactorizationDense) {
+    kkt_.setZero(2 * ndx_ + nu_, 2 * ndx_ + nu_);
+  }
   kktref_.resize(2 * ndx_ + nu_);
   kktref_.setZero();
   primaldual_.resize(2 * ndx_ + nu_);
@@ -295,6 +464,14 @@ void SolverKKT::allocateData() {
   dual_.setZero();
   dF.resize(ndx_ + nu_);
   dF.setZero();
+  const std::size_t nu_max = problem_->get_nu_max();
+  P_tmp_ = Eigen::MatrixXd::Zero(ndx, ndx);
+  Qxu_ = Eigen::MatrixXd::Zero(ndx, nu_max);
+  Quu_ = Eigen::MatrixXd::Zero(nu_max, nu_max);
+  Qu_ = Eigen::VectorXd::Zero(nu_max);
+  FxTP_ = Eigen::MatrixXd::Zero(ndx, ndx);
+  FuTP_ = Eigen::MatrixXd::Zero(nu_max, ndx);
+  Pb_ = Eigen::VectorXd::Zero(ndx);
 }
 
 }  // namespace crocoddyl
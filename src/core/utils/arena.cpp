@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <algorithm>
+#include <string>
+
+#include "crocoddyl/core/utils/arena.hpp"
+#include "crocoddyl/core/utils/exception.hpp"
+
+namespace crocoddyl {
+
+namespace {
+// Number of scalars per aligned chunk
+const std::size_t chunk = MemoryArena::alignment / sizeof(double);
+}  // namespace
+
+const std::size_t MemoryArena::alignment;
+
+MemoryArena::MemoryArena() : data_(NULL), size_(0) {}
+
+MemoryArena::~MemoryArena() {}
+
+std::size_t MemoryArena::push(const std::size_t rows, const std::size_t cols) {
+  if (data_ != NULL) {
+    throw_pretty("Invalid argument: "
+                 << "the arena is already allocated, clear it before registering new buffers");
+  }
+  const std::size_t offset = size_;
+  size_ += (rows * cols + chunk - 1) / chunk * chunk;
+  return offset;
+}
+
+void MemoryArena::allocate() {
+  buffer_.assign(size_ + chunk, 0.);
+  const uintptr_t address = reinterpret_cast<uintptr_t>(buffer_.data());
+  const uintptr_t misalignment = address % alignment;
+  data_ = buffer_.data() + (misalignment == 0 ? 0 : (alignment - misalignment) / sizeof(double));
+}
+
+void MemoryArena::allocate(double* block) {
+  if (reinterpret_cast<uintptr_t>(block) % alignment != 0) {
+    throw_pretty("Invalid argument: "
+                 << "the block has to be aligned to " + std::to_string(alignment) + " bytes");
+  }
+  std::vector<double>().swap(buffer_);
+  data_ = block;
+  std::fill(data_, data_ + size_, 0.);
+}
+
+void MemoryArena::clear() {
+  std::vector<double>().swap(buffer_);
+  data_ = NULL;
+  size_ = 0;
+}
+
+double* MemoryArena::get_data(const std::size_t offset) {
+  if (data_ == NULL) {
+    throw_pretty("Invalid argument: "
+                 << "the arena is not allocated");
+  }
+  return data_ + offset;
+}
+
+std::size_t MemoryArena::get_size() const { return size_ * sizeof(double); }
+
+}  // namespace crocoddyl
@@ -7,6 +7,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "crocoddyl/core/utils/callbacks.hpp"
+#include "crocoddyl/core/solvers/ddp.hpp"
+#include "crocoddyl/core/utils/exception.hpp"
 
 namespace crocoddyl {
 
@@ -66,4 +68,35 @@ void CallbackVerbose::operator()(SolverAbstract& solver) {
   }
 }
 
+CallbackPolicyPublisher::CallbackPolicyPublisher(boost::shared_ptr<PolicyBuffer> buffer)
+    : CallbackAbstract(), buffer_(buffer) {}
+
+CallbackPolicyPublisher::~CallbackPolicyPublisher() {}
+
+void CallbackPolicyPublisher::operator()(SolverAbstract& solver) {
+  SolverDDP* ddp = dynamic_cast<SolverDDP*>(&solver);
+  if (ddp == NULL) {
+    throw_pretty("Invalid argument: "
+                 << "the policy can only be published by DDP-based solvers");
+  }
+  const std::size_t nodes = buffer_->get_nodes();
+  if (nodes > ddp->get_problem()->get_T()) {
+    throw_pretty("Invalid argument: "
+                 << "the buffer has more nodes than the problem (it should be lower than or equal to " +
+                        std::to_string(ddp->get_problem()->get_T()) + ")");
+  }
+  Policy& policy = buffer_->get_back();
+  const std::vector<Eigen::VectorXd>& xs = ddp->get_xs();
+  const std::vector<Eigen::VectorXd>& us = ddp->get_us();
+  const std::vector<SolverDDP::MatrixXdRowMajorMap>& K = ddp->get_K();
+  for (std::size_t t = 0; t < nodes; ++t) {
+    policy.xs[t] = xs[t];
+    policy.us[t] = us[t];
+    policy.K[t] = K[t];
+  }
+  buffer_->publish(ddp->get_iter());
+}
+
+const boost::shared_ptr<PolicyBuffer>& CallbackPolicyPublisher::get_buffer() const { return buffer_; }
+
 }  // namespace crocoddyl
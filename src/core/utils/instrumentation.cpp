@@ -0,0 +1,276 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <thread>
+
+#include "crocoddyl/core/utils/instrumentation.hpp"
+#include "crocoddyl/core/utils/exception.hpp"
+
+namespace crocoddyl {
+
+namespace {
+const uint64_t max_latency = (uint64_t(1) << (LatencyHistogram::magnitudes + LatencyHistogram::sub_bits)) - 1;
+std::atomic<std::size_t> instrumentation_ids(0);
+}  // namespace
+
+const std::size_t LatencyHistogram::sub_bits;
+const std::size_t LatencyHistogram::sub_buckets;
+const std::size_t LatencyHistogram::magnitudes;
+const std::size_t LatencyHistogram::nbuckets;
+
+LatencyHistogram::LatencyHistogram()
+    : counts_(nbuckets, 0), count_(0), sum_(0), min_(std::numeric_limits<uint64_t>::max()), max_(0) {}
+
+LatencyHistogram::~LatencyHistogram() {}
+
+void LatencyHistogram::record(const uint64_t ns) {
+  ++counts_[bucketIndex(ns)];
+  ++count_;
+  sum_ += ns;
+  min_ = std::min(min_, ns);
+  max_ = std::max(max_, ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+  for (std::size_t i = 0; i < nbuckets; ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  count_ = 0;
+  sum_ = 0;
+  min_ = std::numeric_limits<uint64_t>::max();
+  max_ = 0;
+}
+
+std::size_t LatencyHistogram::bucketIndex(const uint64_t ns) {
+  if (ns < sub_buckets) {
+    return static_cast<std::size_t>(ns);
+  }
+  // The latencies in [2^m, 2^(m+1)) are split into sub_buckets buckets of width 2^(m-sub_bits)
+  const uint64_t value = std::min(ns, max_latency);
+  const std::size_t shift = static_cast<std::size_t>(63 - __builtin_clzll(value)) - sub_bits;
+  return shift * sub_buckets + static_cast<std::size_t>(value >> shift);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(const std::size_t i) {
+  if (i < sub_buckets) {
+    return static_cast<uint64_t>(i);
+  }
+  const std::size_t shift = i / sub_buckets - 1;
+  return ((static_cast<uint64_t>(i % sub_buckets + sub_buckets) + 1) << shift) - 1;
+}
+
+uint64_t LatencyHistogram::get_count() const { return count_; }
+
+uint64_t LatencyHistogram::get_bucket(const std::size_t i) const {
+  if (i >= nbuckets) {
+    throw_pretty("Invalid argument: "
+                 << "i is bigger than the number of buckets (it should be lower than " + std::to_string(nbuckets) +
+                        ")");
+  }
+  return counts_[i];
+}
+
+double LatencyHistogram::get_min() const { return count_ == 0 ? 0. : static_cast<double>(min_) * 1e-3; }
+
+double LatencyHistogram::get_max() const { return static_cast<double>(max_) * 1e-3; }
+
+double LatencyHistogram::get_mean() const {
+  return count_ == 0 ? 0. : static_cast<double>(sum_) / static_cast<double>(count_) * 1e-3;
+}
+
+double LatencyHistogram::get_percentile(const double p) const {
+  if (p < 0. || p > 1.) {
+    throw_pretty("Invalid argument: "
+                 << "p should be in [0, 1]");
+  }
+  if (count_ == 0) {
+    return 0.;
+  }
+  const uint64_t rank = std::max(uint64_t(1), static_cast<uint64_t>(std::ceil(p * static_cast<double>(count_))));
+  uint64_t cumulative = 0;
+  for (std::size_t i = 0; i < nbuckets; ++i) {
+    cumulative += counts_[i];
+    if (cumulative >= rank) {
+      return static_cast<double>(std::min(bucketUpperBound(i), max_)) * 1e-3;
+    }
+  }
+  return get_max();
+}
+
+/**
+ * Histograms of a thread. Only the owner thread writes them, so the updates are relaxed loads and stores instead of
+ * read-modify-write operations, while other threads can safely read them at any time.
+ */
+struct Instrumentation::ThreadRecords {
+  ThreadRecords() : thread(std::this_thread::get_id()) { clear(); }
+
+  void clear() {
+    for (std::size_t p = 0; p < NbProbeTypes; ++p) {
+      for (std::size_t i = 0; i < LatencyHistogram::nbuckets; ++i) {
+        counts[p][i].store(0, std::memory_order_relaxed);
+      }
+      count[p].store(0, std::memory_order_relaxed);
+      sum[p].store(0, std::memory_order_relaxed);
+      min[p].store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+      max[p].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  static void increment(std::atomic<uint64_t>& value, const uint64_t delta) {
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+  }
+
+  std::thread::id thread;                                                  //!< Thread that writes the records
+  std::atomic<uint64_t> counts[NbProbeTypes][LatencyHistogram::nbuckets];  //!< Number of records per bucket
+  std::atomic<uint64_t> count[NbProbeTypes];                               //!< Number of records
+  std::atomic<uint64_t> sum[NbProbeTypes];                                 //!< Sum of the latencies in ns
+  std::atomic<uint64_t> min[NbProbeTypes];                                 //!< Minimum latency in ns
+  std::atomic<uint64_t> max[NbProbeTypes];                                 //!< Maximum latency in ns
+};
+
+std::atomic<bool> Instrumentation::enabled_(false);
+
+Instrumentation::Instrumentation() : id_(++instrumentation_ids) {}
+
+Instrumentation::~Instrumentation() {
+  for (std::size_t i = 0; i < records_.size(); ++i) {
+    delete records_[i];
+  }
+}
+
+Instrumentation::ThreadRecords* Instrumentation::get_thread_records() {
+  // The records of the last instrumentation used by the thread are cached, so the registry is only locked when a
+  // thread records for the first time
+  static thread_local ThreadRecords* cache = NULL;
+  static thread_local std::size_t cache_owner = 0;
+  if (cache_owner == id_) {
+    return cache;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  const std::thread::id thread = std::this_thread::get_id();
+  for (std::size_t i = 0; i < records_.size(); ++i) {
+    if (records_[i]->thread == thread) {
+      cache = records_[i];
+      cache_owner = id_;
+      return cache;
+    }
+  }
+  records_.push_back(new ThreadRecords());
+  cache = records_.back();
+  cache_owner = id_;
+  return cache;
+}
+
+void Instrumentation::record(const ProbeType probe, const uint64_t ns) {
+  if (static_cast<std::size_t>(probe) >= NbProbeTypes) {
+    throw_pretty("Invalid argument: "
+                 << "probe is not a valid probe type");
+  }
+  ThreadRecords* records = get_thread_records();
+  ThreadRecords::increment(records->counts[probe][LatencyHistogram::bucketIndex(ns)], 1);
+  ThreadRecords::increment(records->count[probe], 1);
+  ThreadRecords::increment(records->sum[probe], ns);
+  if (ns < records->min[probe].load(std::memory_order_relaxed)) {
+    records->min[probe].store(ns, std::memory_order_relaxed);
+  }
+  if (ns > records->max[probe].load(std::memory_order_relaxed)) {
+    records->max[probe].store(ns, std::memory_order_relaxed);
+  }
+}
+
+void Instrumentation::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (std::size_t i = 0; i < records_.size(); ++i) {
+    records_[i]->clear();
+  }
+}
+
+void Instrumentation::report(std::ostream& os) const {
+  const std::ios_base::fmtflags flags = os.flags();
+  const std::streamsize precision = os.precision();
+  os << std::fixed << std::setprecision(2);
+  os << std::left << std::setw(20) << "probe" << std::right << std::setw(12) << "count" << std::setw(12) << "mean"
+     << std::setw(12) << "p50" << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(12) << "p99.9"
+     << std::setw(12) << "max" << "  [us]" << std::endl;
+  for (std::size_t p = 0; p < NbProbeTypes; ++p) {
+    const LatencyHistogram histogram = get_histogram(static_cast<ProbeType>(p));
+    if (histogram.get_count() == 0) {
+      continue;
+    }
+    os << std::left << std::setw(20) << get_name(static_cast<ProbeType>(p)) << std::right << std::setw(12)
+       << histogram.get_count() << std::setw(12) << histogram.get_mean() << std::setw(12)
+       << histogram.get_percentile(0.5) << std::setw(12) << histogram.get_percentile(0.9) << std::setw(12)
+       << histogram.get_percentile(0.99) << std::setw(12) << histogram.get_percentile(0.999) << std::setw(12)
+       << histogram.get_max() << std::endl;
+  }
+  os.flags(flags);
+  os.precision(precision);
+}
+
+LatencyHistogram Instrumentation::get_histogram(const ProbeType probe) const {
+  if (static_cast<std::size_t>(probe) >= NbProbeTypes) {
+    throw_pretty("Invalid argument: "
+                 << "probe is not a valid probe type");
+  }
+  LatencyHistogram histogram;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (std::size_t i = 0; i < records_.size(); ++i) {
+    const ThreadRecords* records = records_[i];
+    for (std::size_t j = 0; j < LatencyHistogram::nbuckets; ++j) {
+      histogram.counts_[j] += records->counts[probe][j].load(std::memory_order_relaxed);
+    }
+    histogram.count_ += records->count[probe].load(std::memory_order_relaxed);
+    histogram.sum_ += records->sum[probe].load(std::memory_order_relaxed);
+    histogram.min_ = std::min(histogram.min_, records->min[probe].load(std::memory_order_relaxed));
+    histogram.max_ = std::max(histogram.max_, records->max[probe].load(std::memory_order_relaxed));
+  }
+  return histogram;
+}
+
+const char* Instrumentation::get_name(const ProbeType probe) {
+  switch (probe) {
+    case ProbeCalcDiff:
+      return "calcDiff";
+    case ProbeBackwardPass:
+      return "backwardPass";
+    case ProbeForwardPass:
+      return "forwardPass";
+    case ProbeComputeGains:
+      return "computeGains";
+    case ProbeNodeCalc:
+      return "node calc";
+    case ProbeNodeCalcDiff:
+      return "node calcDiff";
+    case ProbeNodeCalcAndDiff:
+      return "node calcAndDiff";
+    default:
+      throw_pretty("Invalid argument: "
+                   << "probe is not a valid probe type");
+  }
+}
+
+void Instrumentation::set_enabled(const bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+Instrumentation& getInstrumentation() {
+  static Instrumentation instrumentation;
+  return instrumentation;
+}
+
+}  // namespace crocoddyl
@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ctime>
+
+#include "crocoddyl/core/utils/policy-buffer.hpp"
+#include "crocoddyl/core/utils/exception.hpp"
+
+namespace crocoddyl {
+
+Policy::Policy(const std::size_t nodes, const std::size_t nx, const std::size_t ndx, const std::size_t nu)
+    : xs(nodes, Eigen::VectorXd::Zero(nx)),
+      us(nodes, Eigen::VectorXd::Zero(nu)),
+      K(nodes, MatrixXdRowMajor::Zero(nu, ndx)),
+      iter(0),
+      sequence(0),
+      timestamp(0.) {}
+
+void Policy::computeControl(const std::size_t t, const Eigen::Ref<const Eigen::VectorXd>& dx,
+                            Eigen::VectorXd& u) const {
+  if (t >= us.size()) {
+    throw_pretty("Invalid argument: "
+                 << "t is bigger than the number of nodes (it should be lower than " + std::to_string(us.size()) +
+                        ")");
+  }
+  u = us[t];
+  u.noalias() -= K[t] * dx;
+}
+
+const unsigned char PolicyBuffer::fresh;
+const unsigned char PolicyBuffer::index;
+
+PolicyBuffer::PolicyBuffer(const std::size_t nodes, const std::size_t nx, const std::size_t ndx,
+                           const std::size_t nu)
+    : nodes_(nodes), policies_(3, Policy(nodes, nx, ndx, nu)), middle_(1), back_(0), front_(2), sequence_(0) {
+  if (nodes == 0) {
+    throw_pretty("Invalid argument: "
+                 << "nodes has to be positive");
+  }
+}
+
+PolicyBuffer::~PolicyBuffer() {}
+
+Policy& PolicyBuffer::get_back() { return policies_[back_]; }
+
+void PolicyBuffer::publish(const std::size_t iter) {
+  Policy& policy = policies_[back_];
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  policy.iter = iter;
+  policy.sequence = ++sequence_;
+  policy.timestamp = static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+  // The release makes the policy visible to the reader that acquires it
+  back_ = middle_.exchange(static_cast<unsigned char>(back_ | fresh), std::memory_order_acq_rel) & index;
+}
+
+const Policy& PolicyBuffer::read() {
+  if (middle_.load(std::memory_order_relaxed) & fresh) {
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & index;
+  }
+  return policies_[front_];
+}
+
+bool PolicyBuffer::has_update() const { return (middle_.load(std::memory_order_relaxed) & fresh) != 0; }
+
+std::size_t PolicyBuffer::get_nodes() const { return nodes_; }
+
+}  // namespace crocoddyl
@@ -0,0 +1,358 @@
+///////////////////////////////////////////////////////////////////////////////
+// BSD 3-Clause License
+//
+// Copyright (C) 2021, University of Edinburgh
+// Copyright note valid unless otherwise stated in individual files.
+// All rights reserved.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <iostream>
+#include <boost/make_shared.hpp>
+#ifdef CROCODDYL_WITH_MULTITHREADING
+#include <omp.h>
+#endif  // CROCODDYL_WITH_MULTITHREADING
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif  // __linux__
+
+#include "crocoddyl/core/utils/scheduler.hpp"
+#include "crocoddyl/core/utils/exception.hpp"
+
+namespace crocoddyl {
+
+namespace {
+// True if the current thread is running a task of a thread pool
+thread_local bool in_pool_task = false;
+}  // namespace
+
+SchedulerAbstract::SchedulerAbstract(const std::size_t nthreads) : nthreads_(nthreads) {
+  if (nthreads == 0) {
+    throw_pretty("Invalid argument: "
+                 << "nthreads has to be positive");
+  }
+}
+
+SchedulerAbstract::~SchedulerAbstract() {}
+
+std::size_t SchedulerAbstract::get_nthreads() const { return nthreads_; }
+
+void SchedulerAbstract::set_nthreads(const std::size_t nthreads) {
+  if (nthreads == 0) {
+    throw_pretty("Invalid argument: "
+                 << "nthreads has to be positive");
+  }
+  nthreads_ = nthreads;
+}
+
+SchedulerOpenMP::SchedulerOpenMP(const std::size_t nthreads) : SchedulerAbstract(1) { set_nthreads(nthreads); }
+
+SchedulerOpenMP::~SchedulerOpenMP() {}
+
+void SchedulerOpenMP::parallelFor(const std::size_t n, const TaskFunction& task) {
+#ifdef CROCODDYL_WITH_MULTITHREADING
+  if (nthreads_ > 1 && n > 1) {
+    std::exception_ptr error;
+#pragma omp parallel for num_threads(nthreads_)
+    for (std::size_t i = 0; i < n; ++i) {
+      try {
+        task(i);
+      } catch (...) {
+#pragma omp critical(crocoddyl_scheduler_error)
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return;
+  }
+#endif  // CROCODDYL_WITH_MULTITHREADING
+  for (std::size_t i = 0; i < n; ++i) {
+    task(i);
+  }
+}
+
+void SchedulerOpenMP::set_nthreads(const std::size_t nthreads) {
+#ifndef CROCODDYL_WITH_MULTITHREADING
+  if (nthreads > 1) {
+    std::cerr << "Warning: the number of threads won't affect the computational performance as multithreading "
+                 "support is not enabled (use SchedulerThreadPool instead)."
+              << std::endl;
+  }
+  SchedulerAbstract::set_nthreads(1);
+#else
+  SchedulerAbstract::set_nthreads(nthreads);
+#endif
+}
+
+std::size_t SchedulerOpenMP::getDefaultNumThreads() {
+#ifdef CROCODDYL_WITH_MULTITHREADING
+  return CROCODDYL_WITH_NTHREADS;
+#else
+  return 1;
+#endif
+}
+
+SchedulerThreadPool::SchedulerThreadPool(const std::size_t nthreads)
+    : SchedulerAbstract(nthreads), task_(NULL), generation_(0), pending_(0), stop_(false) {
+  startWorkers();
+}
+
+SchedulerThreadPool::~SchedulerThreadPool() { stopWorkers(); }
+
+void SchedulerThreadPool::parallelFor(const std::size_t n, const TaskFunction& task) {
+  if (nthreads_ == 1 || n < 2 || in_pool_task) {
+    for (std::size_t i = 0; i < n; ++i) {
+      task(i);
+    }
+    return;
+  }
+  std::lock_guard<std::mutex> call_lock(call_mutex_);
+
+  // Split the iterations into one contiguous range per thread
+  for (std::size_t k = 0; k < nthreads_; ++k) {
+    WorkRange& range = *ranges_[k];
+    range.begin = k * n / nthreads_;
+    range.end = (k + 1) * n / nthreads_;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    error_ = std::exception_ptr();
+    pending_ = nthreads_ - 1;
+    ++generation_;
+  }
+  start_cv_.notify_all();
+
+  // The calling thread runs the first range
+  in_pool_task = true;
+  runTasks(0);
+  in_pool_task = false;
+
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_ == 0; });
+    task_ = NULL;
+    std::swap(error, error_);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void SchedulerThreadPool::set_nthreads(const std::size_t nthreads) {
+  if (nthreads == 0) {
+    throw_pretty("Invalid argument: "
+                 << "nthreads has to be positive");
+  }
+  std::lock_guard<std::mutex> call_lock(call_mutex_);
+  if (nthreads == nthreads_) {
+    return;
+  }
+  stopWorkers();
+  nthreads_ = nthreads;
+  startWorkers();
+}
+
+const std::vector<std::size_t>& SchedulerThreadPool::get_affinity() const { return affinity_; }
+
+void SchedulerThreadPool::set_affinity(const std::vector<std::size_t>& cores) {
+#ifndef __linux__
+  if (!cores.empty()) {
+    std::cerr << "Warning: thread pinning is only supported in Linux, the workers won't be pinned." << std::endl;
+  }
+#endif
+  std::lock_guard<std::mutex> call_lock(call_mutex_);
+  stopWorkers();
+  affinity_ = cores;
+  startWorkers();
+}
+
+std::size_t SchedulerThreadPool::getDefaultNumThreads() {
+  const std::size_t nthreads = std::thread::hardware_concurrency();
+  return nthreads > 0 ? nthreads : 1;
+}
+
+void SchedulerThreadPool::startWorkers() {
+  ranges_.resize(nthreads_);
+  for (std::size_t k = 0; k < nthreads_; ++k) {
+    if (!ranges_[k]) {
+      ranges_[k] = boost::make_shared<WorkRange>();
+    }
+    ranges_[k]->begin = 0;
+    ranges_[k]->end = 0;
+  }
+  stop_ = false;
+  workers_.reserve(nthreads_ - 1);
+  for (std::size_t k = 1; k < nthreads_; ++k) {
+    workers_.push_back(std::thread(&SchedulerThreadPool::workerLoop, this, k, generation_));
+    pinWorker(k - 1);
+  }
+}
+
+void SchedulerThreadPool::stopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_cv_.notify_all();
+  for (std::size_t k = 0; k < workers_.size(); ++k) {
+    workers_[k].join();
+  }
+  workers_.clear();
+}
+
+void SchedulerThreadPool::pinWorker(const std::size_t i) {
+  if (affinity_.empty()) {
+    return;
+  }
+#ifdef __linux__
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(affinity_[i % affinity_.size()], &cpuset);
+  if (pthread_setaffinity_np(workers_[i].native_handle(), sizeof(cpu_set_t), &cpuset) != 0) {
+    std::cerr << "Warning: the worker " << i << " couldn't be pinned to the core " << affinity_[i % affinity_.size()]
+              << "." << std::endl;
+  }
+#endif
+}
+
+void SchedulerThreadPool::workerLoop(const std::size_t id, std::size_t generation) {
+  in_pool_task = true;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_cv_.wait(lock, [this, generation] { return stop_ || generation_ != generation; });
+      if (stop_) {
+        return;
+      }
+      generation = generation_;
+    }
+    runTasks(id);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--pending_ == 0) {
+        done_cv_.notify_one();
+      }
+    }
+  }
+}
+
+void SchedulerThreadPool::runTasks(const std::size_t id) {
+  std::size_t i;
+  do {
+    while (popTask(id, i)) {
+      try {
+        (*task_)(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) {
+          error_ = std::current_exception();
+        }
+      }
+    }
+  } while (stealTasks(id));
+}
+
+bool SchedulerThreadPool::popTask(const std::size_t id, std::size_t& i) {
+  WorkRange& range = *ranges_[id];
+  std::lock_guard<std::mutex> lock(range.mutex);
+  if (range.begin == range.end) {
+    return false;
+  }
+  i = range.begin++;
+  return true;
+}
+
+bool SchedulerThreadPool::stealTasks(const std::size_t id) {
+  while (true) {
+    // Find the thread with the largest pending range
+    std::size_t victim = id;
+    std::size_t largest = 0;
+    for (std::size_t k = 0; k < nthreads_; ++k) {
+      if (k == id) {
+        continue;
+      }
+      WorkRange& range = *ranges_[k];
+      std::lock_guard<std::mutex> lock(range.mutex);
+      if (range.end - range.begin > largest) {
+        largest = range.end - range.begin;
+        victim = k;
+      }
+    }
+    if (victim == id) {
+      return false;
+    }
+
+    // Take the back half of its range, if it was not consumed meanwhile
+    std::size_t begin, end;
+    {
+      WorkRange& range = *ranges_[victim];
+      std::lock_guard<std::mutex> lock(range.mutex);
+      const std::size_t pending = range.end - range.begin;
+      if (pending == 0) {
+        continue;
+      }
+      end = range.end;
+      begin = range.end - (pending + 1) / 2;
+      range.end = begin;
+    }
+    WorkRange& range = *ranges_[id];
+    std::lock_guard<std::mutex> lock(range.mutex);
+    range.begin = begin;
+    range.end = end;
+    return true;
+  }
+}
+
+SchedulerExecutor::SchedulerExecutor(ExecutorFunction executor, const std::size_t nthreads)
+    : SchedulerAbstract(nthreads), executor_(executor) {
+  if (!executor_) {
+    throw_pretty("Invalid argument: "
+                 << "the executor is empty");
+  }
+}
+
+SchedulerExecutor::~SchedulerExecutor() {}
+
+void SchedulerExecutor::parallelFor(const std::size_t n, const TaskFunction& task) {
+  const std::size_t nchunks = std::min(nthreads_, n);
+  if (nchunks < 2) {
+    for (std::size_t i = 0; i < n; ++i) {
+      task(i);
+    }
+    return;
+  }
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  executor_(nchunks, [&](const std::size_t k) {
+    for (std::size_t i = k * n / nchunks; i < (k + 1) * n / nchunks; ++i) {
+      try {
+        task(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  });
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+boost::shared_ptr<SchedulerAbstract> createDefaultScheduler() {
+#ifdef CROCODDYL_WITH_MULTITHREADING
+  return boost::make_shared<SchedulerOpenMP>();
+#else
+  return boost::make_shared<SchedulerThreadPool>(1);
+#endif
+}
+
+}  // namespace crocoddyl
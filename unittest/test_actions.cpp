@@ -106,6 +106,36 @@ void test_partial_derivatives_against_numdiff(ActionModelTypes::Type action_mode
 
 //----------------------------------------------------------------------------//
 
+void test_calc_and_diff(ActionModelTypes::Type action_model_type) {
+  // create the model
+  ActionModelFactory factory;
+  const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = factory.create(action_model_type);
+
+  // create the data of the separated and fused computations
+  const boost::shared_ptr<crocoddyl::ActionDataAbstract>& data = model->createData();
+  const boost::shared_ptr<crocoddyl::ActionDataAbstract>& data_fused = model->createData();
+
+  // Generating random values for the state and control
+  const Eigen::VectorXd& x = model->get_state()->rand();
+  const Eigen::VectorXd& u = Eigen::VectorXd::Random(model->get_nu());
+
+  // Checking that the fused computation is equivalent to calc and calcDiff
+  model->calc(data, x, u);
+  model->calcDiff(data, x, u);
+  model->calcAndDiff(data_fused, x, u);
+  BOOST_CHECK((data->xnext - data_fused->xnext).isZero(1e-9));
+  BOOST_CHECK(std::abs(data->cost - data_fused->cost) < 1e-9);
+  BOOST_CHECK((data->Fx - data_fused->Fx).isZero(1e-9));
+  BOOST_CHECK((data->Fu - data_fused->Fu).isZero(1e-9));
+  BOOST_CHECK((data->Lx - data_fused->Lx).isZero(1e-9));
+  BOOST_CHECK((data->Lu - data_fused->Lu).isZero(1e-9));
+  BOOST_CHECK((data->Lxx - data_fused->Lxx).isZero(1e-9));
+  BOOST_CHECK((data->Lxu - data_fused->Lxu).isZero(1e-9));
+  BOOST_CHECK((data->Luu - data_fused->Luu).isZero(1e-9));
+}
+
+//----------------------------------------------------------------------------//
+
 void register_action_model_unit_tests(ActionModelTypes::Type action_model_type) {
   boost::test_tools::output_test_stream test_name;
   test_name << "test_" << action_model_type;
@@ -115,6 +145,7 @@ void register_action_model_unit_tests(ActionModelTypes::Type action_model_type)
   ts->add(BOOST_TEST_CASE(boost::bind(&test_calc_returns_state, action_model_type)));
   ts->add(BOOST_TEST_CASE(boost::bind(&test_calc_returns_a_cost, action_model_type)));
   ts->add(BOOST_TEST_CASE(boost::bind(&test_partial_derivatives_against_numdiff, action_model_type)));
+  ts->add(BOOST_TEST_CASE(boost::bind(&test_calc_and_diff, action_model_type)));
   framework::master_test_suite().add(ts);
 }
 
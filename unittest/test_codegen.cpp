@@ -18,9 +18,12 @@
 
 #include "crocoddyl/core/mathbase.hpp"
 #include "crocoddyl/core/codegen/action-base.hpp"
+#include "crocoddyl/core/codegen/problem.hpp"
+#include "crocoddyl/core/codegen/solver.hpp"
 #include "crocoddyl/core/integrator/euler.hpp"
 #include "crocoddyl/core/solvers/ddp.hpp"
 #include "crocoddyl/core/utils/callbacks.hpp"
+#include "crocoddyl/core/utils/scheduler.hpp"
 
 #include "crocoddyl/multibody/contacts/contact-6d.hpp"
 #include "crocoddyl/multibody/contacts/contact-3d.hpp"
@@ -366,11 +369,294 @@ void test_codegen_bipedal() {
   BOOST_CHECK(runningDataCG->Fu.isApprox(runningDataD->Fu));
 }
 
+void test_codegen_cache() {
+  typedef double Scalar;
+  typedef CppAD::cg::CG<Scalar> CGScalar;
+  typedef CppAD::AD<CGScalar> ADScalar;
+  boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<Scalar> > runningModelD = build_arm_action_model<Scalar>();
+  crocoddyl::ActionModelCodeGenTpl<Scalar> runningModelCG(build_arm_action_model<ADScalar>(), runningModelD,
+                                                           "pyrene_arm_cache");
+  BOOST_CHECK(runningModelCG.existLib());
+
+  // Check that the same model reuses the cached library
+  crocoddyl::ActionModelCodeGenTpl<Scalar> cachedModelCG(build_arm_action_model<ADScalar>(), runningModelD,
+                                                          "pyrene_arm_cache");
+  BOOST_CHECK_EQUAL(runningModelCG.get_library_key(), cachedModelCG.get_library_key());
+
+  // Check that a change in the model parameters produces a new library
+  boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<ADScalar> > modifiedModelAD = build_arm_action_model<ADScalar>();
+  crocoddyl::IntegratedActionModelEulerTpl<ADScalar>* m =
+      static_cast<crocoddyl::IntegratedActionModelEulerTpl<ADScalar>*>(modifiedModelAD.get());
+  crocoddyl::DifferentialActionModelFreeFwdDynamicsTpl<ADScalar>* md =
+      static_cast<crocoddyl::DifferentialActionModelFreeFwdDynamicsTpl<ADScalar>*>(m->get_differential().get());
+  md->get_costs()->get_costs().find("xReg")->second->weight = ADScalar(1.);
+  crocoddyl::ActionModelCodeGenTpl<Scalar> modifiedModelCG(modifiedModelAD, runningModelD, "pyrene_arm_cache");
+  BOOST_CHECK(runningModelCG.get_library_key() != modifiedModelCG.get_library_key());
+  BOOST_CHECK(modifiedModelCG.existLib());
+}
+
+void test_codegen_parallel_compilation() {
+  typedef double Scalar;
+  typedef CppAD::cg::CG<Scalar> CGScalar;
+  typedef CppAD::AD<CGScalar> ADScalar;
+  typedef typename crocoddyl::MathBaseTpl<Scalar>::VectorXs VectorXs;
+  boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<Scalar> > runningModelD = build_arm_action_model<Scalar>();
+
+  // Split the generated code in small functions that are compiled in parallel and cached
+  crocoddyl::CodeGenOptions options;
+  options.njobs = 4;
+  options.max_assignments = 100;
+  options.object_cache = "pyrene_arm_objects";
+  boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<Scalar> > runningModelCG =
+      boost::make_shared<crocoddyl::ActionModelCodeGenTpl<Scalar> >(
+          build_arm_action_model<ADScalar>(), runningModelD, "pyrene_arm_parallel", 0,
+          crocoddyl::ActionModelCodeGenTpl<Scalar>::empty_record_env, "calc", "calcDiff", options);
+
+  // Check that code-generated action model is the same as original.
+  boost::shared_ptr<crocoddyl::ActionDataAbstractTpl<Scalar> > runningDataCG = runningModelCG->createData();
+  boost::shared_ptr<crocoddyl::ActionDataAbstractTpl<Scalar> > runningDataD = runningModelD->createData();
+  VectorXs x_rand = runningModelCG->get_state()->rand();
+  VectorXs u_rand = VectorXs::Random(runningModelCG->get_nu());
+  runningModelD->calc(runningDataD, x_rand, u_rand);
+  runningModelD->calcDiff(runningDataD, x_rand, u_rand);
+  runningModelCG->calc(runningDataCG, x_rand, u_rand);
+  runningModelCG->calcDiff(runningDataCG, x_rand, u_rand);
+
+  BOOST_CHECK(runningDataCG->xnext.isApprox(runningDataD->xnext));
+  BOOST_CHECK_CLOSE(runningDataCG->cost, runningDataD->cost, Scalar(1e-10));
+  BOOST_CHECK(runningDataCG->Lx.isApprox(runningDataD->Lx));
+  BOOST_CHECK(runningDataCG->Lu.isApprox(runningDataD->Lu));
+  BOOST_CHECK(runningDataCG->Lxx.isApprox(runningDataD->Lxx));
+  BOOST_CHECK(runningDataCG->Lxu.isApprox(runningDataD->Lxu));
+  BOOST_CHECK(runningDataCG->Luu.isApprox(runningDataD->Luu));
+  BOOST_CHECK(runningDataCG->Fx.isApprox(runningDataD->Fx));
+  BOOST_CHECK(runningDataCG->Fu.isApprox(runningDataD->Fu));
+}
+
+void test_codegen_sparse_derivatives() {
+  typedef double Scalar;
+  typedef CppAD::cg::CG<Scalar> CGScalar;
+  typedef CppAD::AD<CGScalar> ADScalar;
+  typedef typename crocoddyl::MathBaseTpl<Scalar>::VectorXs VectorXs;
+  boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<Scalar> > runningModelD = build_arm_action_model<Scalar>();
+  boost::shared_ptr<crocoddyl::ActionModelCodeGenTpl<Scalar> > runningModelCG =
+      boost::make_shared<crocoddyl::ActionModelCodeGenTpl<Scalar> >(build_arm_action_model<ADScalar>(),
+                                                                     runningModelD, "pyrene_arm_sparse");
+
+  // The constant derivatives (e.g. the structural zeros of Lxu) are not computed by the generated calcDiff
+  const std::size_t ndx = runningModelCG->get_state()->get_ndx();
+  const std::size_t nu = runningModelCG->get_nu();
+  const std::size_t nY = 2 * ndx * ndx + 2 * ndx * nu + nu * nu + ndx + nu;
+  const std::vector<std::size_t>& outputs = runningModelCG->get_calcDiff_outputs();
+  BOOST_CHECK(outputs.size() < nY);
+  BOOST_CHECK(static_cast<std::size_t>(runningModelCG->get_calcDiff_constants().size()) == nY);
+
+  // Without the sparsity, the generated calcDiff computes all the derivatives
+  crocoddyl::CodeGenOptions options;
+  options.sparsity = false;
+  boost::shared_ptr<crocoddyl::ActionModelCodeGenTpl<Scalar> > denseModelCG =
+      boost::make_shared<crocoddyl::ActionModelCodeGenTpl<Scalar> >(
+          build_arm_action_model<ADScalar>(), runningModelD, "pyrene_arm_dense", 0,
+          crocoddyl::ActionModelCodeGenTpl<Scalar>::empty_record_env, "calc", "calcDiff", options);
+  BOOST_CHECK(denseModelCG->get_calcDiff_outputs().size() == nY);
+
+  // Check that the derivatives, including the constant ones, are the same as the original ones
+  boost::shared_ptr<crocoddyl::ActionDataAbstractTpl<Scalar> > runningDataCG = runningModelCG->createData();
+  boost::shared_ptr<crocoddyl::ActionDataAbstractTpl<Scalar> > denseDataCG = denseModelCG->createData();
+  boost::shared_ptr<crocoddyl::ActionDataAbstractTpl<Scalar> > runningDataD = runningModelD->createData();
+  for (std::size_t i = 0; i < 2; ++i) {
+    VectorXs x_rand = runningModelCG->get_state()->rand();
+    VectorXs u_rand = VectorXs::Random(runningModelCG->get_nu());
+    runningModelD->calc(runningDataD, x_rand, u_rand);
+    runningModelD->calcDiff(runningDataD, x_rand, u_rand);
+    runningModelCG->calc(runningDataCG, x_rand, u_rand);
+    runningModelCG->calcDiff(runningDataCG, x_rand, u_rand);
+    denseModelCG->calc(denseDataCG, x_rand, u_rand);
+    denseModelCG->calcDiff(denseDataCG, x_rand, u_rand);
+
+    BOOST_CHECK((denseDataCG->Lxu - runningDataCG->Lxu).isZero(1e-9));
+    BOOST_CHECK((denseDataCG->Fx - runningDataCG->Fx).isZero(1e-9));
+
+    BOOST_CHECK(runningDataCG->Lx.isApprox(runningDataD->Lx));
+    BOOST_CHECK(runningDataCG->Lu.isApprox(runningDataD->Lu));
+    BOOST_CHECK(runningDataCG->Lxx.isApprox(runningDataD->Lxx));
+    BOOST_CHECK((runningDataCG->Lxu - runningDataD->Lxu).isZero(1e-9));
+    BOOST_CHECK(runningDataCG->Luu.isApprox(runningDataD->Luu));
+    BOOST_CHECK(runningDataCG->Fx.isApprox(runningDataD->Fx));
+    BOOST_CHECK(runningDataCG->Fu.isApprox(runningDataD->Fu));
+  }
+}
+
+void test_codegen_problem() {
+  typedef double Scalar;
+  typedef CppAD::cg::CG<Scalar> CGScalar;
+  typedef CppAD::AD<CGScalar> ADScalar;
+  typedef typename crocoddyl::MathBaseTpl<Scalar>::VectorXs VectorXs;
+  const std::size_t T = 5;
+  boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<Scalar> > runningModelD = build_arm_action_model<Scalar>();
+  boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<ADScalar> > runningModelAD = build_arm_action_model<ADScalar>();
+  std::vector<boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<Scalar> > > runningModels(T, runningModelD);
+  std::vector<boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<ADScalar> > > runningModelsAD(T, runningModelAD);
+  const VectorXs x0 = runningModelD->get_state()->rand();
+  boost::shared_ptr<crocoddyl::ShootingProblemTpl<Scalar> > problemD =
+      boost::make_shared<crocoddyl::ShootingProblemTpl<Scalar> >(x0, runningModels, runningModelD);
+
+  // Generate a single function for all the nodes of the problem
+  boost::shared_ptr<crocoddyl::ShootingProblemCodeGenTpl<Scalar> > problemCG =
+      boost::make_shared<crocoddyl::ShootingProblemCodeGenTpl<Scalar> >(
+          x0, runningModels, runningModelD, runningModelsAD, runningModelAD, "pyrene_arm_problem");
+  BOOST_CHECK(problemCG->is_recorded());
+  BOOST_CHECK(problemCG->get_offsets().size() == T + 1);
+  BOOST_CHECK(problemCG->get_outputs().size() < static_cast<std::size_t>(problemCG->get_buffer().size()));
+
+  // Check that the fused function computes the same costs, dynamics and derivatives as the problem
+  std::vector<VectorXs> xs(T + 1), us(T);
+  for (std::size_t t = 0; t < T; ++t) {
+    xs[t] = runningModelD->get_state()->rand();
+    us[t] = VectorXs::Random(runningModelD->get_nu());
+  }
+  xs[T] = runningModelD->get_state()->rand();
+  const Scalar cost = problemD->calcAndDiff(xs, us);
+  BOOST_CHECK_CLOSE(problemCG->calcAndDiff(xs, us), cost, Scalar(1e-10));
+  for (std::size_t t = 0; t < T; ++t) {
+    const boost::shared_ptr<crocoddyl::ActionDataAbstractTpl<Scalar> >& dataD = problemD->get_runningDatas()[t];
+    const boost::shared_ptr<crocoddyl::ActionDataAbstractTpl<Scalar> >& dataCG = problemCG->get_runningDatas()[t];
+    BOOST_CHECK_CLOSE(dataCG->cost, dataD->cost, Scalar(1e-10));
+    BOOST_CHECK(dataCG->xnext.isApprox(dataD->xnext));
+    BOOST_CHECK(dataCG->r.isApprox(dataD->r));
+    BOOST_CHECK(dataCG->Fx.isApprox(dataD->Fx));
+    BOOST_CHECK(dataCG->Fu.isApprox(dataD->Fu));
+    BOOST_CHECK(dataCG->Lx.isApprox(dataD->Lx));
+    BOOST_CHECK(dataCG->Lu.isApprox(dataD->Lu));
+    BOOST_CHECK(dataCG->Lxx.isApprox(dataD->Lxx));
+    BOOST_CHECK((dataCG->Lxu - dataD->Lxu).isZero(1e-9));
+    BOOST_CHECK(dataCG->Luu.isApprox(dataD->Luu));
+  }
+  BOOST_CHECK_CLOSE(problemCG->get_terminalData()->cost, problemD->get_terminalData()->cost, Scalar(1e-10));
+  BOOST_CHECK(problemCG->get_terminalData()->r.isApprox(problemD->get_terminalData()->r));
+  BOOST_CHECK(problemCG->get_terminalData()->Lx.isApprox(problemD->get_terminalData()->Lx));
+  BOOST_CHECK(problemCG->get_terminalData()->Lxx.isApprox(problemD->get_terminalData()->Lxx));
+}
+
+void test_codegen_solver() {
+  typedef double Scalar;
+  typedef CppAD::cg::CG<Scalar> CGScalar;
+  typedef CppAD::AD<CGScalar> ADScalar;
+  typedef typename crocoddyl::MathBaseTpl<Scalar>::VectorXs VectorXs;
+  const std::size_t T = 10;
+  boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<Scalar> > runningModelD = build_arm_action_model<Scalar>();
+  boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<ADScalar> > runningModelAD = build_arm_action_model<ADScalar>();
+  std::vector<boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<Scalar> > > runningModels(T, runningModelD);
+  std::vector<boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<ADScalar> > > runningModelsAD(T, runningModelAD);
+  const VectorXs x0 = runningModelD->get_state()->rand();
+  boost::shared_ptr<crocoddyl::ShootingProblem> problemD =
+      boost::make_shared<crocoddyl::ShootingProblem>(x0, runningModels, runningModelD);
+  boost::shared_ptr<crocoddyl::ShootingProblemCodeGenTpl<Scalar> > problemCG =
+      boost::make_shared<crocoddyl::ShootingProblemCodeGenTpl<Scalar> >(
+          x0, runningModels, runningModelD, runningModelsAD, runningModelAD, "pyrene_arm_solver", "problemCalcAndDiff",
+          crocoddyl::CodeGenOptions(), true);
+  BOOST_CHECK(problemCG->has_riccati());
+
+  // Solve the problem with the generated functions and with the nodes from the same infeasible guess
+  std::vector<VectorXs> xs(T + 1), us(T);
+  for (std::size_t t = 0; t < T; ++t) {
+    xs[t] = runningModelD->get_state()->rand();
+    us[t] = VectorXs::Random(runningModelD->get_nu());
+  }
+  xs[T] = runningModelD->get_state()->rand();
+  crocoddyl::SolverFDDP solverD(problemD);
+  crocoddyl::SolverFDDPCodeGen solverCG(problemCG);
+  solverD.solve(xs, us, 10);
+  solverCG.solve(xs, us, 10);
+  BOOST_CHECK(solverCG.get_iter() == solverD.get_iter());
+  BOOST_CHECK_CLOSE(solverCG.get_cost(), solverD.get_cost(), Scalar(1e-6));
+  for (std::size_t t = 0; t < T; ++t) {
+    BOOST_CHECK(solverCG.get_xs()[t].isApprox(solverD.get_xs()[t], 1e-6));
+    BOOST_CHECK(solverCG.get_us()[t].isApprox(solverD.get_us()[t], 1e-6));
+    BOOST_CHECK(solverCG.get_K()[t].isApprox(solverD.get_K()[t], 1e-6));
+    BOOST_CHECK(solverCG.get_Vxx()[t].isApprox(solverD.get_Vxx()[t], 1e-6));
+  }
+}
+
+void test_codegen_batch() {
+  typedef double Scalar;
+  typedef CppAD::cg::CG<Scalar> CGScalar;
+  typedef CppAD::AD<CGScalar> ADScalar;
+  typedef typename crocoddyl::MathBaseTpl<Scalar>::VectorXs VectorXs;
+  typedef typename crocoddyl::MathBaseTpl<Scalar>::MatrixXs MatrixXs;
+  boost::shared_ptr<crocoddyl::ActionModelAbstractTpl<Scalar> > runningModelD = build_arm_action_model<Scalar>();
+  boost::shared_ptr<crocoddyl::ActionModelCodeGenTpl<Scalar> > runningModelCG =
+      boost::make_shared<crocoddyl::ActionModelCodeGenTpl<Scalar> >(build_arm_action_model<ADScalar>(),
+                                                                     runningModelD, "pyrene_arm_batch");
+
+  // Evaluate a batch of random inputs, one per column
+  const std::size_t nx = runningModelCG->get_state()->get_nx();
+  const std::size_t ndx = runningModelCG->get_state()->get_ndx();
+  const std::size_t nu = runningModelCG->get_nu();
+  const Eigen::DenseIndex K = 7;
+  MatrixXs xus(runningModelCG->getInputDimension(), K);
+  for (Eigen::DenseIndex k = 0; k < K; ++k) {
+    xus.col(k).head(nx) = runningModelCG->get_state()->rand();
+    xus.col(k).tail(nu) = VectorXs::Random(nu);
+  }
+  MatrixXs calcout(1 + nx, K);
+  MatrixXs calcDiffout(runningModelCG->get_calcDiff_constants().size(), K);
+  runningModelCG->calcBatch(xus, calcout, 2);
+  runningModelCG->calcDiffBatch(xus, calcDiffout, 2);
+
+  // Check that the concurrent and nested calls (each one with its own workspace) produce the same results
+  const std::size_t ncalls = 3;
+  std::vector<MatrixXs> calcouts(ncalls, MatrixXs::Zero(1 + nx, K));
+  std::vector<MatrixXs> calcDiffouts(ncalls, MatrixXs::Zero(calcDiffout.rows(), K));
+  boost::shared_ptr<crocoddyl::SchedulerAbstract> scheduler =
+      boost::make_shared<crocoddyl::SchedulerThreadPool>(ncalls);
+  scheduler->parallelFor(ncalls, [&](const std::size_t i) {
+    runningModelCG->calcBatch(xus, calcouts[i], scheduler);
+    runningModelCG->calcDiffBatch(xus, calcDiffouts[i], 2);
+  });
+  for (std::size_t i = 0; i < ncalls; ++i) {
+    BOOST_CHECK(calcouts[i] == calcout);
+    BOOST_CHECK(calcDiffouts[i] == calcDiffout);
+  }
+
+  // Check that each column is the same as the one of the original model
+  boost::shared_ptr<crocoddyl::ActionDataAbstractTpl<Scalar> > runningDataD = runningModelD->createData();
+  for (Eigen::DenseIndex k = 0; k < K; ++k) {
+    const VectorXs x = xus.col(k).head(nx);
+    const VectorXs u = xus.col(k).tail(nu);
+    runningModelD->calc(runningDataD, x, u);
+    runningModelD->calcDiff(runningDataD, x, u);
+    BOOST_CHECK_CLOSE(calcout(0, k), runningDataD->cost, Scalar(1e-10));
+    BOOST_CHECK(calcout.col(k).tail(nx).isApprox(runningDataD->xnext));
+
+    const Scalar* Y = calcDiffout.col(k).data();
+    BOOST_CHECK(Eigen::Map<const MatrixXs>(Y, ndx, ndx).isApprox(runningDataD->Fx));
+    Y += ndx * ndx;
+    BOOST_CHECK(Eigen::Map<const MatrixXs>(Y, ndx, nu).isApprox(runningDataD->Fu));
+    Y += ndx * nu;
+    BOOST_CHECK(Eigen::Map<const VectorXs>(Y, ndx).isApprox(runningDataD->Lx));
+    Y += ndx;
+    BOOST_CHECK(Eigen::Map<const VectorXs>(Y, nu).isApprox(runningDataD->Lu));
+    Y += nu;
+    BOOST_CHECK(Eigen::Map<const MatrixXs>(Y, ndx, ndx).isApprox(runningDataD->Lxx));
+    Y += ndx * ndx;
+    BOOST_CHECK((Eigen::Map<const MatrixXs>(Y, ndx, nu) - runningDataD->Lxu).isZero(1e-9));
+    Y += ndx * nu;
+    BOOST_CHECK(Eigen::Map<const MatrixXs>(Y, nu, nu).isApprox(runningDataD->Luu));
+  }
+}
+
 bool init_function() {
   const std::string test_name = "test_codegen";
   test_suite* ts = BOOST_TEST_SUITE(test_name);
   ts->add(BOOST_TEST_CASE(&test_codegen_4DoFArm));
   ts->add(BOOST_TEST_CASE(&test_codegen_bipedal));
+  ts->add(BOOST_TEST_CASE(&test_codegen_cache));
+  ts->add(BOOST_TEST_CASE(&test_codegen_parallel_compilation));
+  ts->add(BOOST_TEST_CASE(&test_codegen_sparse_derivatives));
+  ts->add(BOOST_TEST_CASE(&test_codegen_problem));
+  ts->add(BOOST_TEST_CASE(&test_codegen_solver));
+  ts->add(BOOST_TEST_CASE(&test_codegen_batch));
   framework::master_test_suite().add(ts);
 
   return true;
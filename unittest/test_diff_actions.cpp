@@ -141,6 +141,36 @@ void test_partial_derivatives_against_numdiff(DifferentialActionModelTypes::Type
 
 //----------------------------------------------------------------------------//
 
+void test_calc_and_diff(DifferentialActionModelTypes::Type action_type) {
+  // create the model
+  DifferentialActionModelFactory factory;
+  const boost::shared_ptr<crocoddyl::DifferentialActionModelAbstract>& model = factory.create(action_type);
+
+  // create the data of the separated and fused computations
+  const boost::shared_ptr<crocoddyl::DifferentialActionDataAbstract>& data = model->createData();
+  const boost::shared_ptr<crocoddyl::DifferentialActionDataAbstract>& data_fused = model->createData();
+
+  // Generating random values for the state and control
+  const Eigen::VectorXd& x = model->get_state()->rand();
+  const Eigen::VectorXd& u = Eigen::VectorXd::Random(model->get_nu());
+
+  // Checking that the fused computation is equivalent to calc and calcDiff
+  model->calc(data, x, u);
+  model->calcDiff(data, x, u);
+  model->calcAndDiff(data_fused, x, u);
+  BOOST_CHECK((data->xout - data_fused->xout).isZero(1e-9));
+  BOOST_CHECK(std::abs(data->cost - data_fused->cost) < 1e-9);
+  BOOST_CHECK((data->Fx - data_fused->Fx).isZero(1e-9));
+  BOOST_CHECK((data->Fu - data_fused->Fu).isZero(1e-9));
+  BOOST_CHECK((data->Lx - data_fused->Lx).isZero(1e-9));
+  BOOST_CHECK((data->Lu - data_fused->Lu).isZero(1e-9));
+  BOOST_CHECK((data->Lxx - data_fused->Lxx).isZero(1e-9));
+  BOOST_CHECK((data->Lxu - data_fused->Lxu).isZero(1e-9));
+  BOOST_CHECK((data->Luu - data_fused->Luu).isZero(1e-9));
+}
+
+//----------------------------------------------------------------------------//
+
 void register_action_model_unit_tests(DifferentialActionModelTypes::Type action_type) {
   boost::test_tools::output_test_stream test_name;
   test_name << "test_" << action_type;
@@ -150,6 +180,7 @@ void register_action_model_unit_tests(DifferentialActionModelTypes::Type action_
   ts->add(BOOST_TEST_CASE(boost::bind(&test_calc_returns_state, action_type)));
   ts->add(BOOST_TEST_CASE(boost::bind(&test_calc_returns_a_cost, action_type)));
   ts->add(BOOST_TEST_CASE(boost::bind(&test_partial_derivatives_against_numdiff, action_type)));
+  ts->add(BOOST_TEST_CASE(boost::bind(&test_calc_and_diff, action_type)));
   ts->add(BOOST_TEST_CASE(boost::bind(&test_quasi_static, action_type)));
   framework::master_test_suite().add(ts);
 }
@@ -9,7 +9,11 @@
 #define BOOST_TEST_NO_MAIN
 #define BOOST_TEST_ALTERNATIVE_INIT_API
 
+#include <algorithm>
+#include <thread>
+
 #include "crocoddyl/core/optctrl/shooting.hpp"
+#include "crocoddyl/core/utils/scheduler.hpp"
 #include "crocoddyl/core/integrator/euler.hpp"
 #include "factory/action.hpp"
 #include "factory/diff_action.hpp"
@@ -378,6 +382,256 @@ void test_quasiStatic_diffAction(DifferentialActionModelTypes::Type action_model
   }
 }
 
+void run_tasks_in_threads(const std::size_t ntasks, const crocoddyl::SchedulerAbstract::TaskFunction& task) {
+  std::vector<std::thread> threads;
+  for (std::size_t k = 0; k < ntasks; ++k) {
+    threads.push_back(std::thread(task, k));
+  }
+  for (std::size_t k = 0; k < ntasks; ++k) {
+    threads[k].join();
+  }
+}
+
+void test_scheduler(ActionModelTypes::Type action_model_type,
+                    const boost::shared_ptr<crocoddyl::SchedulerAbstract>& scheduler) {
+  // create the model
+  ActionModelFactory factory;
+  const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = factory.create(action_model_type);
+
+  // create two shooting problems (serial and with the scheduler)
+  std::size_t T = 20;
+  const Eigen::VectorXd& x0 = model->get_state()->rand();
+  std::vector<boost::shared_ptr<crocoddyl::ActionModelAbstract> > models(T, model);
+  crocoddyl::ShootingProblem problem1(x0, models, model);
+  crocoddyl::ShootingProblem problem2(x0, models, model);
+  problem1.set_scheduler(boost::make_shared<crocoddyl::SchedulerThreadPool>(1));
+  problem2.set_scheduler(scheduler);
+  BOOST_CHECK(problem2.get_scheduler() == scheduler);
+  BOOST_CHECK(problem2.get_nthreads() == scheduler->get_nthreads());
+
+  // create random trajectory
+  std::vector<Eigen::VectorXd> xs(T + 1);
+  std::vector<Eigen::VectorXd> us(T);
+  for (std::size_t i = 0; i < T; ++i) {
+    xs[i] = model->get_state()->rand();
+    us[i] = Eigen::VectorXd::Random(model->get_nu());
+  }
+  xs.back() = model->get_state()->rand();
+
+  // check that both problems produce the same values and derivatives in each node
+  BOOST_CHECK(problem1.calc(xs, us) == problem2.calc(xs, us));
+  BOOST_CHECK(problem1.calcDiff(xs, us) == problem2.calcDiff(xs, us));
+  for (std::size_t i = 0; i < T; ++i) {
+    const boost::shared_ptr<crocoddyl::ActionDataAbstract>& data1 = problem1.get_runningDatas()[i];
+    const boost::shared_ptr<crocoddyl::ActionDataAbstract>& data2 = problem2.get_runningDatas()[i];
+    BOOST_CHECK(data1->cost == data2->cost);
+    BOOST_CHECK(data1->xnext == data2->xnext);
+    BOOST_CHECK(data1->Fx == data2->Fx);
+    BOOST_CHECK(data1->Fu == data2->Fu);
+    BOOST_CHECK(data1->Lx == data2->Lx);
+    BOOST_CHECK(data1->Lu == data2->Lu);
+    BOOST_CHECK(data1->Lxx == data2->Lxx);
+    BOOST_CHECK(data1->Lxu == data2->Lxu);
+    BOOST_CHECK(data1->Luu == data2->Luu);
+  }
+
+  // check that the number of threads can be modified at runtime
+  problem2.set_nthreads(3);
+  BOOST_CHECK(problem2.get_nthreads() == scheduler->get_nthreads());
+  BOOST_CHECK(problem1.calc(xs, us) == problem2.calc(xs, us));
+
+  // check that the exceptions thrown by the nodes are propagated
+  std::vector<std::size_t> visits(T, 0);
+  bool thrown = false;
+  try {
+    scheduler->parallelFor(T, [&visits](const std::size_t i) {
+      ++visits[i];
+      if (i == 5) {
+        throw std::runtime_error("node error");
+      }
+    });
+  } catch (std::runtime_error&) {
+    thrown = true;
+  }
+  BOOST_CHECK(thrown);
+  BOOST_CHECK(visits[5] == 1);
+  for (std::size_t i = 0; i < T; ++i) {
+    BOOST_CHECK(visits[i] <= 1);
+  }
+}
+
+void test_load_balancing(ActionModelTypes::Type action_model_type, crocoddyl::LoadBalancingType load_balancing) {
+  // create the model
+  ActionModelFactory factory;
+  const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = factory.create(action_model_type);
+
+  // create two shooting problems (serial and balanced)
+  std::size_t T = 20;
+  const Eigen::VectorXd& x0 = model->get_state()->rand();
+  std::vector<boost::shared_ptr<crocoddyl::ActionModelAbstract> > models(T, model);
+  crocoddyl::ShootingProblem problem1(x0, models, model);
+  crocoddyl::ShootingProblem problem2(x0, models, model);
+  problem1.set_scheduler(boost::make_shared<crocoddyl::SchedulerThreadPool>(1));
+  problem2.set_scheduler(boost::make_shared<crocoddyl::SchedulerThreadPool>(4));
+  problem2.set_load_balancing(load_balancing);
+  BOOST_CHECK(problem2.get_load_balancing() == load_balancing);
+
+  // create random trajectory
+  std::vector<Eigen::VectorXd> xs(T + 1);
+  std::vector<Eigen::VectorXd> us(T);
+  for (std::size_t i = 0; i < T; ++i) {
+    xs[i] = model->get_state()->rand();
+    us[i] = Eigen::VectorXd::Random(model->get_nu());
+  }
+  xs.back() = model->get_state()->rand();
+
+  // check that the load balancing doesn't modify the results, also after measuring the node durations
+  for (std::size_t k = 0; k < 3; ++k) {
+    BOOST_CHECK(problem1.calc(xs, us) == problem2.calc(xs, us));
+    BOOST_CHECK(problem1.calcDiff(xs, us) == problem2.calcDiff(xs, us));
+    for (std::size_t i = 0; i < T; ++i) {
+      const boost::shared_ptr<crocoddyl::ActionDataAbstract>& data1 = problem1.get_runningDatas()[i];
+      const boost::shared_ptr<crocoddyl::ActionDataAbstract>& data2 = problem2.get_runningDatas()[i];
+      BOOST_CHECK(data1->xnext == data2->xnext);
+      BOOST_CHECK(data1->Fx == data2->Fx);
+      BOOST_CHECK(data1->Fu == data2->Fu);
+      BOOST_CHECK(data1->Lx == data2->Lx);
+      BOOST_CHECK(data1->Lu == data2->Lu);
+    }
+  }
+  BOOST_CHECK(problem2.get_calc_durations().size() == T);
+  BOOST_CHECK(problem2.get_calcDiff_durations().size() == T);
+}
+
+//----------------------------------------------------------------------------//
+
+void test_circular_append(ActionModelTypes::Type action_model_type) {
+  // create a horizon that cycles through two models
+  ActionModelFactory factory;
+  const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model1 = factory.create(action_model_type);
+  const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model2 = factory.create(action_model_type);
+  std::size_t T = 10;
+  std::vector<boost::shared_ptr<crocoddyl::ActionModelAbstract> > models(T);
+  for (std::size_t i = 0; i < T; ++i) {
+    models[i] = i % 2 == 0 ? model1 : model2;
+  }
+  crocoddyl::ShootingProblem problem(model1->get_state()->rand(), models, model1);
+  const std::vector<boost::shared_ptr<crocoddyl::ActionDataAbstract> > datas = problem.get_runningDatas();
+
+  // check that the shifted nodes recycle the datas of the removed ones
+  for (std::size_t k = 0; k < 2 * T; ++k) {
+    const boost::shared_ptr<crocoddyl::ActionModelAbstract> model = problem.get_runningModels()[0];
+    const boost::shared_ptr<crocoddyl::ActionDataAbstract> data = problem.get_runningDatas()[0];
+    const boost::shared_ptr<crocoddyl::ActionDataAbstract> next_data = problem.get_runningDatas()[1];
+    problem.circularAppend(model);
+    BOOST_CHECK(problem.get_runningModels().back() == model);
+    BOOST_CHECK(problem.get_runningDatas().back() == data);
+    BOOST_CHECK(problem.get_runningDatas()[0] == next_data);
+  }
+  for (std::size_t i = 0; i < T; ++i) {
+    BOOST_CHECK(problem.get_runningModels()[i] == models[i]);
+    BOOST_CHECK(problem.get_runningDatas()[i] == datas[i]);
+  }
+
+  // check that a data appended by the user is not recycled for another node
+  problem.circularAppend(problem.get_runningModels()[0], problem.get_runningDatas()[0]);
+  problem.circularAppend(problem.get_runningModels()[0]);
+  for (std::size_t i = 0; i < T; ++i) {
+    for (std::size_t j = i + 1; j < T; ++j) {
+      BOOST_CHECK(problem.get_runningDatas()[i] != problem.get_runningDatas()[j]);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------//
+
+void check_same_derivatives(const crocoddyl::ShootingProblem& problem1, const crocoddyl::ShootingProblem& problem2) {
+  for (std::size_t i = 0; i < problem1.get_T(); ++i) {
+    const boost::shared_ptr<crocoddyl::ActionDataAbstract>& data1 = problem1.get_runningDatas()[i];
+    const boost::shared_ptr<crocoddyl::ActionDataAbstract>& data2 = problem2.get_runningDatas()[i];
+    BOOST_CHECK((data1->Fx - data2->Fx).isZero(1e-9));
+    BOOST_CHECK((data1->Fu - data2->Fu).isZero(1e-9));
+    BOOST_CHECK((data1->Lx - data2->Lx).isZero(1e-9));
+    BOOST_CHECK((data1->Lu - data2->Lu).isZero(1e-9));
+    BOOST_CHECK((data1->Lxx - data2->Lxx).isZero(1e-9));
+    BOOST_CHECK((data1->Lxu - data2->Lxu).isZero(1e-9));
+    BOOST_CHECK((data1->Luu - data2->Luu).isZero(1e-9));
+  }
+  BOOST_CHECK((problem1.get_terminalData()->Lx - problem2.get_terminalData()->Lx).isZero(1e-9));
+  BOOST_CHECK((problem1.get_terminalData()->Lxx - problem2.get_terminalData()->Lxx).isZero(1e-9));
+}
+
+void test_incremental_calcDiff(ActionModelTypes::Type action_model_type) {
+  // create an incremental problem and a reference one
+  ActionModelFactory factory;
+  const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = factory.create(action_model_type);
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = model->get_state();
+  std::size_t T = 10;
+  std::vector<boost::shared_ptr<crocoddyl::ActionModelAbstract> > models(T, model);
+  crocoddyl::ShootingProblem problem(state->rand(), models, model);
+  crocoddyl::ShootingProblem reference(problem.get_x0(), models, model);
+  problem.set_incremental_calcDiff(true);
+  BOOST_CHECK_THROW(problem.set_calcDiff_tolerance(-1.), std::exception);
+
+  // create random trajectory
+  std::vector<Eigen::VectorXd> xs(T + 1);
+  std::vector<Eigen::VectorXd> us(T);
+  for (std::size_t i = 0; i < T; ++i) {
+    xs[i] = state->rand();
+    us[i] = Eigen::VectorXd::Random(model->get_nu());
+  }
+  xs.back() = state->rand();
+
+  // check that the first calcDiff evaluates all the nodes, and the second one none of them
+  problem.calc(xs, us);
+  problem.calcDiff(xs, us);
+  BOOST_CHECK(problem.get_calcDiff_skipped() == 0);
+  problem.calc(xs, us);
+  problem.calcDiff(xs, us);
+  BOOST_CHECK(problem.get_calcDiff_skipped() == T + 1);
+
+  // check that only the modified nodes are evaluated again
+  xs[3] = state->rand();
+  us[5] = Eigen::VectorXd::Random(model->get_nu());
+  problem.calc(xs, us);
+  reference.calc(xs, us);
+  BOOST_CHECK_CLOSE(problem.calcDiff(xs, us), reference.calcDiff(xs, us), 1e-9);
+  BOOST_CHECK(problem.get_calcDiff_skipped() == T - 1);
+  check_same_derivatives(problem, reference);
+
+  // check that the shifted nodes keep their derivatives after a circular append
+  problem.circularAppend(model);
+  reference.circularAppend(model);
+  std::rotate(xs.begin(), xs.begin() + 1, xs.end());
+  std::rotate(us.begin(), us.begin() + 1, us.end());
+  xs.back() = xs[T - 1];
+  xs[T - 1] = state->rand();
+  problem.calc(xs, us);
+  reference.calc(xs, us);
+  problem.calcDiff(xs, us);
+  reference.calcDiff(xs, us);
+  BOOST_CHECK(problem.get_calcDiff_skipped() == T);
+  check_same_derivatives(problem, reference);
+
+  // check that the invalidated derivatives are evaluated again
+  problem.invalidateDerivatives();
+  problem.calcDiff(xs, us);
+  BOOST_CHECK(problem.get_calcDiff_skipped() == 0);
+
+  // check that the fused computation only evaluates the derivatives of the modified nodes
+  xs[7] = state->rand();
+  BOOST_CHECK_CLOSE(problem.calcAndDiff(xs, us), reference.calcAndDiff(xs, us), 1e-9);
+  BOOST_CHECK(problem.get_calcDiff_skipped() == T);
+  check_same_derivatives(problem, reference);
+
+  // check that the tolerance skips the nodes with small changes
+  problem.set_calcDiff_tolerance(1e-3);
+  xs[0] += 1e-4 * Eigen::VectorXd::Ones(state->get_nx());
+  problem.calc(xs, us);
+  problem.calcDiff(xs, us);
+  BOOST_CHECK(problem.get_calcDiff_skipped() == T + 1);
+}
+
 //----------------------------------------------------------------------------//
 
 void register_action_model_unit_tests(ActionModelTypes::Type action_model_type) {
@@ -389,6 +643,17 @@ void register_action_model_unit_tests(ActionModelTypes::Type action_model_type)
   ts->add(BOOST_TEST_CASE(boost::bind(&test_calcDiff, action_model_type)));
   ts->add(BOOST_TEST_CASE(boost::bind(&test_quasiStatic, action_model_type)));
   ts->add(BOOST_TEST_CASE(boost::bind(&test_rollout, action_model_type)));
+  ts->add(BOOST_TEST_CASE(boost::bind(&test_circular_append, action_model_type)));
+  ts->add(BOOST_TEST_CASE(boost::bind(&test_incremental_calcDiff, action_model_type)));
+  ts->add(BOOST_TEST_CASE(
+      boost::bind(&test_scheduler, action_model_type, boost::make_shared<crocoddyl::SchedulerThreadPool>(4))));
+  ts->add(BOOST_TEST_CASE(
+      boost::bind(&test_scheduler, action_model_type, boost::make_shared<crocoddyl::SchedulerOpenMP>(4))));
+  ts->add(BOOST_TEST_CASE(boost::bind(
+      &test_scheduler, action_model_type,
+      boost::make_shared<crocoddyl::SchedulerExecutor>(&run_tasks_in_threads, 4))));
+  ts->add(BOOST_TEST_CASE(boost::bind(&test_load_balancing, action_model_type, crocoddyl::LoadBalancingCostAware)));
+  ts->add(BOOST_TEST_CASE(boost::bind(&test_load_balancing, action_model_type, crocoddyl::LoadBalancingDynamic)));
   framework::master_test_suite().add(ts);
 }
 
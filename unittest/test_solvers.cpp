@@ -12,7 +12,12 @@
 #define BOOST_TEST_ALTERNATIVE_INIT_API
 
 #include "crocoddyl/core/utils/callbacks.hpp"
+#include "crocoddyl/core/utils/instrumentation.hpp"
+#include "crocoddyl/core/solvers/batch.hpp"
+#include "crocoddyl/core/solvers/fddp.hpp"
+#include "crocoddyl/core/integrator/euler.hpp"
 #include "factory/solver.hpp"
+#include "factory/diff_action.hpp"
 #include "unittest_common.hpp"
 
 using namespace boost::unit_test;
@@ -79,6 +84,41 @@ void test_kkt_search_direction(ActionModelTypes::Type action_type, size_t T) {
 
 //____________________________________________________________________________//
 
+void test_kkt_factorizations(ActionModelTypes::Type action_type, size_t T) {
+  // Create the kkt solvers with the Riccati and dense factorizations
+  SolverFactory factory;
+  boost::shared_ptr<crocoddyl::SolverKKT> kkt =
+      boost::static_pointer_cast<crocoddyl::SolverKKT>(factory.create(SolverTypes::SolverKKT, action_type, T));
+  const boost::shared_ptr<crocoddyl::ShootingProblem>& problem = kkt->get_problem();
+  crocoddyl::SolverKKT dense(problem);
+  BOOST_CHECK(kkt->get_factorization_type() == crocoddyl::KKTFactorizationRiccati);
+  dense.set_factorization_type(crocoddyl::KKTFactorizationDense);
+
+  // Generate the different state along the trajectory
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = problem->get_runningModels()[0]->get_state();
+  std::vector<Eigen::VectorXd> xs;
+  std::vector<Eigen::VectorXd> us;
+  for (std::size_t i = 0; i < T; ++i) {
+    const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = problem->get_runningModels()[i];
+    xs.push_back(state->rand());
+    us.push_back(Eigen::VectorXd::Random(model->get_nu()));
+  }
+  xs.push_back(state->rand());
+
+  // Check that both factorizations compute the same primal-dual direction
+  kkt->setCandidate(xs, us);
+  dense.setCandidate(xs, us);
+  kkt->computeDirection();
+  dense.computeDirection();
+  BOOST_CHECK((kkt->get_primaldual() - dense.get_primaldual()).isZero(1e-9));
+  BOOST_CHECK((kkt->get_kkt() - dense.get_kkt()).isZero(1e-9));
+  BOOST_CHECK(kkt->expectedImprovement().isApprox(dense.expectedImprovement(), 1e-9));
+  const double stop = dense.stoppingCriteria();
+  BOOST_CHECK(std::abs(kkt->stoppingCriteria() - stop) <= 1e-9 * (1. + stop));
+}
+
+//____________________________________________________________________________//
+
 void test_solver_against_kkt_solver(SolverTypes::Type solver_type, ActionModelTypes::Type action_type, size_t T) {
   // Create the solver
   SolverFactory solver_factory;
@@ -134,6 +174,624 @@ void test_solver_against_kkt_solver(SolverTypes::Type solver_type, ActionModelTy
 
 //____________________________________________________________________________//
 
+void test_partitioned_backward_pass(SolverTypes::Type solver_type, ActionModelTypes::Type action_type, size_t T) {
+  // Create the serial and partitioned solvers
+  SolverFactory solver_factory;
+  boost::shared_ptr<crocoddyl::SolverDDP> solver =
+      boost::static_pointer_cast<crocoddyl::SolverDDP>(solver_factory.create(solver_type, action_type, T));
+  const boost::shared_ptr<crocoddyl::ShootingProblem>& problem = solver->get_problem();
+  problem->set_nthreads(4);
+  crocoddyl::SolverDDP partitioned(problem);
+  partitioned.set_backward_type(crocoddyl::BackwardPassPartitioned);
+
+  // Generate an infeasible guess
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = problem->get_runningModels()[0]->get_state();
+  std::vector<Eigen::VectorXd> xs;
+  std::vector<Eigen::VectorXd> us;
+  for (std::size_t i = 0; i < T; ++i) {
+    const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = problem->get_runningModels()[i];
+    xs.push_back(state->rand());
+    us.push_back(Eigen::VectorXd::Random(model->get_nu()));
+  }
+  xs.push_back(state->rand());
+
+  // Compute the search direction with both backward passes
+  solver->setCandidate(xs, us);
+  solver->computeDirection();
+  partitioned.setCandidate(xs, us);
+  partitioned.computeDirection();
+
+  // Check that both produce the same Value function and gains
+  for (std::size_t t = 0; t < T; ++t) {
+    const std::size_t nu = problem->get_runningModels()[t]->get_nu();
+    BOOST_CHECK((solver->get_Vxx()[t] - partitioned.get_Vxx()[t]).isZero(1e-7));
+    BOOST_CHECK((solver->get_Vx()[t] - partitioned.get_Vx()[t]).isZero(1e-7));
+    BOOST_CHECK((solver->get_K()[t].topRows(nu) - partitioned.get_K()[t].topRows(nu)).isZero(1e-7));
+    BOOST_CHECK((solver->get_k()[t].head(nu) - partitioned.get_k()[t].head(nu)).isZero(1e-7));
+  }
+}
+
+//____________________________________________________________________________//
+
+void test_partitioned_forward_pass(ActionModelTypes::Type action_type, size_t T) {
+  // Create the serial and partitioned solvers
+  SolverFactory solver_factory;
+  boost::shared_ptr<crocoddyl::SolverFDDP> solver = boost::static_pointer_cast<crocoddyl::SolverFDDP>(
+      solver_factory.create(SolverTypes::SolverFDDP, action_type, T));
+  const boost::shared_ptr<crocoddyl::ShootingProblem>& problem = solver->get_problem();
+  problem->set_nthreads(4);
+  crocoddyl::SolverFDDP partitioned(problem);
+  partitioned.set_forward_type(crocoddyl::ForwardPassPartitioned);
+
+  // Generate an infeasible guess
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = problem->get_runningModels()[0]->get_state();
+  std::vector<Eigen::VectorXd> xs;
+  std::vector<Eigen::VectorXd> us;
+  for (std::size_t i = 0; i < T; ++i) {
+    const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = problem->get_runningModels()[i];
+    xs.push_back(state->rand());
+    us.push_back(Eigen::VectorXd::Random(model->get_nu()));
+  }
+  xs.push_back(state->rand());
+
+  // Check that both rollouts converge to the same solution
+  BOOST_CHECK(solver->solve(xs, us));
+  BOOST_CHECK(partitioned.solve(xs, us));
+  BOOST_CHECK(partitioned.get_is_feasible());
+  for (std::size_t t = 0; t < T; ++t) {
+    const std::size_t nu = problem->get_runningModels()[t]->get_nu();
+    BOOST_CHECK((state->diff_dx(solver->get_xs()[t], partitioned.get_xs()[t])).isZero(1e-7));
+    BOOST_CHECK((solver->get_us()[t].head(nu) - partitioned.get_us()[t].head(nu)).isZero(1e-7));
+  }
+  BOOST_CHECK((state->diff_dx(solver->get_xs()[T], partitioned.get_xs()[T])).isZero(1e-7));
+
+  // Check that the rollouts of the concurrent line search decide the feasibility of their own steps
+  partitioned.set_linesearch_type(crocoddyl::LineSearchConcurrent);
+  BOOST_CHECK(partitioned.solve(xs, us));
+  BOOST_CHECK(partitioned.get_is_feasible());
+}
+
+//____________________________________________________________________________//
+
+void test_concurrent_linesearch(SolverTypes::Type solver_type, ActionModelTypes::Type action_type, size_t T) {
+  // Create the serial and concurrent solvers
+  SolverFactory solver_factory;
+  boost::shared_ptr<crocoddyl::SolverDDP> solver =
+      boost::static_pointer_cast<crocoddyl::SolverDDP>(solver_factory.create(solver_type, action_type, T));
+  boost::shared_ptr<crocoddyl::SolverDDP> concurrent =
+      boost::static_pointer_cast<crocoddyl::SolverDDP>(solver_factory.create(solver_type, action_type, T));
+  solver->get_problem()->set_nthreads(4);
+  concurrent->get_problem()->set_nthreads(4);
+  concurrent->set_linesearch_type(crocoddyl::LineSearchConcurrent);
+
+  // Generate an infeasible guess
+  const boost::shared_ptr<crocoddyl::ShootingProblem>& problem = solver->get_problem();
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = problem->get_runningModels()[0]->get_state();
+  std::vector<Eigen::VectorXd> xs;
+  std::vector<Eigen::VectorXd> us;
+  for (std::size_t i = 0; i < T; ++i) {
+    const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = problem->get_runningModels()[i];
+    xs.push_back(state->rand());
+    us.push_back(Eigen::VectorXd::Random(model->get_nu()));
+  }
+  xs.push_back(state->rand());
+
+  // Check that both line searches accept the same steps
+  BOOST_CHECK_EQUAL(solver->solve(xs, us), concurrent->solve(xs, us));
+  BOOST_CHECK_EQUAL(solver->get_iter(), concurrent->get_iter());
+  BOOST_CHECK_CLOSE(solver->get_cost(), concurrent->get_cost(), 1e-7);
+  for (std::size_t t = 0; t < T; ++t) {
+    const std::size_t nu = problem->get_runningModels()[t]->get_nu();
+    BOOST_CHECK((state->diff_dx(solver->get_xs()[t], concurrent->get_xs()[t])).isZero(1e-9));
+    BOOST_CHECK((solver->get_us()[t].head(nu) - concurrent->get_us()[t].head(nu)).isZero(1e-9));
+  }
+  BOOST_CHECK((state->diff_dx(solver->get_xs()[T], concurrent->get_xs()[T])).isZero(1e-9));
+}
+
+//____________________________________________________________________________//
+
+void test_speculative_calcDiff(SolverTypes::Type solver_type, ActionModelTypes::Type action_type, size_t T) {
+  // Create the solvers with and without speculative derivatives
+  SolverFactory solver_factory;
+  boost::shared_ptr<crocoddyl::SolverDDP> solver =
+      boost::static_pointer_cast<crocoddyl::SolverDDP>(solver_factory.create(solver_type, action_type, T));
+  boost::shared_ptr<crocoddyl::SolverDDP> speculative =
+      boost::static_pointer_cast<crocoddyl::SolverDDP>(solver_factory.create(solver_type, action_type, T));
+  solver->get_problem()->set_nthreads(4);
+  speculative->get_problem()->set_nthreads(4);
+  speculative->set_speculative_calcDiff(true);
+  BOOST_CHECK(speculative->get_speculative_calcDiff());
+
+  // Generate an infeasible guess
+  const boost::shared_ptr<crocoddyl::ShootingProblem>& problem = solver->get_problem();
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = problem->get_runningModels()[0]->get_state();
+  std::vector<Eigen::VectorXd> xs;
+  std::vector<Eigen::VectorXd> us;
+  for (std::size_t i = 0; i < T; ++i) {
+    const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = problem->get_runningModels()[i];
+    xs.push_back(state->rand());
+    us.push_back(Eigen::VectorXd::Random(model->get_nu()));
+  }
+  xs.push_back(state->rand());
+
+  // Check that the speculative derivatives do not modify the iterates
+  BOOST_CHECK_EQUAL(solver->solve(xs, us), speculative->solve(xs, us));
+  BOOST_CHECK_EQUAL(solver->get_iter(), speculative->get_iter());
+  BOOST_CHECK_CLOSE(solver->get_cost(), speculative->get_cost(), 1e-7);
+  for (std::size_t t = 0; t < T; ++t) {
+    const std::size_t nu = problem->get_runningModels()[t]->get_nu();
+    BOOST_CHECK((state->diff_dx(solver->get_xs()[t], speculative->get_xs()[t])).isZero(1e-9));
+    BOOST_CHECK((solver->get_us()[t].head(nu) - speculative->get_us()[t].head(nu)).isZero(1e-9));
+  }
+  BOOST_CHECK((state->diff_dx(solver->get_xs()[T], speculative->get_xs()[T])).isZero(1e-9));
+
+  // Check that the waiting tasks do not block the rollout with two workers, nor when the solve runs inside a task
+  // of the same pool, where the tasks run inline
+  boost::shared_ptr<crocoddyl::SchedulerAbstract> pool = boost::make_shared<crocoddyl::SchedulerThreadPool>(2);
+  speculative->get_problem()->set_scheduler(pool);
+  BOOST_CHECK_EQUAL(solver->solve(xs, us), speculative->solve(xs, us));
+  BOOST_CHECK_EQUAL(solver->get_iter(), speculative->get_iter());
+  pool->parallelFor(2, [&](const std::size_t n) {
+    if (n == 0) {
+      speculative->solve(xs, us);
+    }
+  });
+  BOOST_CHECK_EQUAL(solver->get_iter(), speculative->get_iter());
+  BOOST_CHECK_CLOSE(solver->get_cost(), speculative->get_cost(), 1e-7);
+}
+
+//____________________________________________________________________________//
+
+void test_batch_solver(ActionModelTypes::Type action_type, size_t T) {
+  // Create the batch solver
+  const std::size_t nbatch = 5;
+  SolverFactory solver_factory;
+  boost::shared_ptr<crocoddyl::SolverAbstract> solver = solver_factory.create(SolverTypes::SolverFDDP, action_type, T);
+  const boost::shared_ptr<crocoddyl::ShootingProblem>& problem = solver->get_problem();
+  problem->set_scheduler(boost::make_shared<crocoddyl::SchedulerThreadPool>(4));
+  crocoddyl::SolverBatch batch(problem, nbatch);
+  BOOST_CHECK_EQUAL(batch.get_problems().size(), nbatch);
+  BOOST_CHECK_EQUAL(batch.get_solvers().size(), nbatch);
+
+  // Check that the workspaces of the instances are laid out contiguously
+  for (std::size_t k = 0; k + 1 < nbatch; ++k) {
+    const crocoddyl::SolverDDP& instance = static_cast<const crocoddyl::SolverDDP&>(*batch.get_solvers()[k]);
+    const crocoddyl::SolverDDP& next = static_cast<const crocoddyl::SolverDDP&>(*batch.get_solvers()[k + 1]);
+    BOOST_CHECK(instance.get_Vxx()[0].data() + instance.get_workspace_size() / sizeof(double) ==
+                next.get_Vxx()[0].data());
+  }
+
+  // Generate a different initial state per instance
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = problem->get_runningModels()[0]->get_state();
+  std::vector<Eigen::VectorXd> x0s;
+  for (std::size_t k = 0; k < nbatch; ++k) {
+    x0s.push_back(state->rand());
+  }
+  batch.solve(x0s);
+
+  // Check that each instance matches an independent solve
+  const std::vector<bool> converged = batch.get_converged();
+  for (std::size_t k = 0; k < nbatch; ++k) {
+    problem->set_x0(x0s[k]);
+    BOOST_CHECK_EQUAL(solver->solve(), converged[k]);
+    const boost::shared_ptr<crocoddyl::SolverAbstract>& instance = batch.get_solvers()[k];
+    BOOST_CHECK((instance->get_problem()->get_x0() - x0s[k]).isZero(1e-9));
+    BOOST_CHECK_EQUAL(solver->get_iter(), instance->get_iter());
+    BOOST_CHECK_CLOSE(solver->get_cost(), instance->get_cost(), 1e-7);
+    for (std::size_t t = 0; t < T; ++t) {
+      const std::size_t nu = problem->get_runningModels()[t]->get_nu();
+      BOOST_CHECK((state->diff_dx(solver->get_xs()[t], instance->get_xs()[t])).isZero(1e-9));
+      BOOST_CHECK((solver->get_us()[t].head(nu) - instance->get_us()[t].head(nu)).isZero(1e-9));
+    }
+  }
+
+  // Check the dimension of the initial states
+  BOOST_CHECK_THROW(batch.solve(std::vector<Eigen::VectorXd>(nbatch - 1, x0s[0])), crocoddyl::Exception);
+}
+
+//____________________________________________________________________________//
+
+void test_solver_workspace(SolverTypes::Type solver_type, ActionModelTypes::Type action_type, size_t T) {
+  SolverFactory solver_factory;
+  boost::shared_ptr<crocoddyl::SolverDDP> solver =
+      boost::static_pointer_cast<crocoddyl::SolverDDP>(solver_factory.create(solver_type, action_type, T));
+  const std::vector<std::size_t>& nodes = solver->get_workspace_nodes();
+  BOOST_CHECK_EQUAL(nodes.size(), T + 1);
+
+  // Check that the nodes are contiguous and aligned in the workspace
+  std::size_t size = 0;
+  for (std::size_t t = 0; t < T; ++t) {
+    const double* node = solver->get_Vxx()[t].data();
+    const double* next_node = solver->get_Vxx()[t + 1].data();
+    BOOST_CHECK_EQUAL(static_cast<std::size_t>(next_node - node) * sizeof(double), nodes[t]);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(node) % crocoddyl::MemoryArena::alignment, 0);
+    BOOST_CHECK(solver->get_K()[t].data() > node && solver->get_K()[t].data() < next_node);
+    BOOST_CHECK(solver->get_fs()[t].data() > node && solver->get_fs()[t].data() < next_node);
+    size += nodes[t];
+  }
+  BOOST_CHECK_EQUAL(size + nodes[T], solver->get_workspace_size());
+
+  // Check that the getters return views of the workspace, which stay valid across the iterations
+  const std::vector<crocoddyl::SolverDDP::MatrixXdMap>& Vxx = solver->get_Vxx();
+  const double* Vxx0 = Vxx[0].data();
+  solver->solve();
+  BOOST_CHECK(&Vxx == &solver->get_Vxx());
+  BOOST_CHECK(Vxx[0].data() == Vxx0);
+}
+
+//____________________________________________________________________________//
+
+void test_shift_warm_start(SolverTypes::Type solver_type, ActionModelTypes::Type action_type, size_t T) {
+  SolverFactory solver_factory;
+  boost::shared_ptr<crocoddyl::SolverDDP> solver =
+      boost::static_pointer_cast<crocoddyl::SolverDDP>(solver_factory.create(solver_type, action_type, T));
+  solver->solve();
+  const std::vector<Eigen::VectorXd> xs = solver->get_xs();
+  const std::vector<Eigen::VectorXd> us = solver->get_us();
+  std::vector<Eigen::MatrixXd> K(T);
+  std::vector<Eigen::VectorXd> k(T);
+  std::vector<const double*> Vxx(T);
+  for (std::size_t t = 0; t < T; ++t) {
+    K[t] = solver->get_K()[t];
+    k[t] = solver->get_k()[t];
+    Vxx[t] = solver->get_Vxx()[t].data();
+  }
+
+  // Shift the problem and the warm-point of the solver
+  const boost::shared_ptr<crocoddyl::ShootingProblem>& problem = solver->get_problem();
+  problem->circularAppend(problem->get_runningModels()[0]);
+  solver->shiftWarmStart();
+
+  // Check that the warm-point and the per-node terms are rotated, and the end running node repeats the previous one
+  for (std::size_t t = 0; t < T - 1; ++t) {
+    BOOST_CHECK(solver->get_xs()[t] == xs[t + 1]);
+    BOOST_CHECK(solver->get_us()[t] == us[t + 1]);
+    BOOST_CHECK(solver->get_K()[t] == K[t + 1]);
+    BOOST_CHECK(solver->get_k()[t] == k[t + 1]);
+    BOOST_CHECK(solver->get_Vxx()[t].data() == Vxx[t + 1]);
+  }
+  BOOST_CHECK(solver->get_xs()[T - 1] == xs[T]);
+  BOOST_CHECK(solver->get_xs()[T] == xs[T]);
+  BOOST_CHECK(solver->get_us()[T - 1] == us[T - 1]);
+  BOOST_CHECK(solver->get_K()[T - 1] == K[T - 1]);
+  BOOST_CHECK(solver->get_k()[T - 1] == k[T - 1]);
+  BOOST_CHECK(solver->get_Vxx()[T - 1].data() == Vxx[0]);
+
+  // Check that the solver runs from the shifted warm-point
+  solver->solve(solver->get_xs(), solver->get_us());
+  BOOST_CHECK(std::isfinite(solver->get_cost()));
+}
+
+//____________________________________________________________________________//
+
+void test_warm_start_policy(SolverTypes::Type solver_type, ActionModelTypes::Type action_type, size_t T) {
+  SolverFactory solver_factory;
+  boost::shared_ptr<crocoddyl::SolverDDP> solver =
+      boost::static_pointer_cast<crocoddyl::SolverDDP>(solver_factory.create(solver_type, action_type, T));
+  solver->set_warm_start_policy(true);
+  BOOST_CHECK(solver->get_warm_start_policy());
+  solver->solve();
+
+  // Shift the problem and the warm-point of the solver, and perturb the initial state
+  const boost::shared_ptr<crocoddyl::ShootingProblem>& problem = solver->get_problem();
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = problem->get_runningModels()[0]->get_state();
+  problem->circularAppend(problem->get_runningModels()[0]);
+  solver->shiftWarmStart();
+  Eigen::VectorXd x0 = problem->get_x0();
+  state->integrate(problem->get_x0(), 1e-2 * Eigen::VectorXd::Random(state->get_ndx()), x0);
+  problem->set_x0(x0);
+  const std::vector<Eigen::VectorXd> xs = solver->get_xs();
+  const std::vector<Eigen::VectorXd> us = solver->get_us();
+  std::vector<Eigen::MatrixXd> K(T);
+  for (std::size_t t = 0; t < T; ++t) {
+    K[t] = solver->get_K()[t];
+  }
+
+  // Check that the guess is replaced by the closed-loop rollout of the shifted policy
+  solver->solve(xs, us, 0);
+  BOOST_CHECK(solver->get_is_feasible());
+  BOOST_CHECK((state->diff_dx(solver->get_xs()[0], x0)).isZero(1e-9));
+  Eigen::VectorXd dx(state->get_ndx());
+  for (std::size_t t = 0; t < T; ++t) {
+    const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = problem->get_runningModels()[t];
+    const std::size_t nu = model->get_nu();
+    state->diff(xs[t], solver->get_xs()[t], dx);
+    BOOST_CHECK((solver->get_us()[t].head(nu) - us[t].head(nu) + K[t].topRows(nu) * dx).isZero(1e-9));
+    BOOST_CHECK((state->diff_dx(solver->get_xs()[t + 1], problem->get_runningDatas()[t]->xnext)).isZero(1e-9));
+  }
+
+  // Check that the solver runs from the warm start
+  solver->solve(solver->get_xs(), solver->get_us());
+  BOOST_CHECK(std::isfinite(solver->get_cost()));
+}
+
+//____________________________________________________________________________//
+
+class CallbackExpireDeadline : public crocoddyl::CallbackAbstract {
+ public:
+  CallbackExpireDeadline() {}
+  ~CallbackExpireDeadline() {}
+
+  virtual void operator()(crocoddyl::SolverAbstract& solver) {
+    static_cast<crocoddyl::SolverFDDP&>(solver).set_deadline(1e-9);
+  }
+};
+
+void test_deadline(SolverTypes::Type solver_type, ActionModelTypes::Type action_type, size_t T) {
+  // Create the solver with a time budget and a reference solver
+  SolverFactory solver_factory;
+  boost::shared_ptr<crocoddyl::SolverFDDP> solver =
+      boost::static_pointer_cast<crocoddyl::SolverFDDP>(solver_factory.create(solver_type, action_type, T));
+  boost::shared_ptr<crocoddyl::SolverFDDP> reference =
+      boost::static_pointer_cast<crocoddyl::SolverFDDP>(solver_factory.create(solver_type, action_type, T));
+
+  // Generate an infeasible guess
+  const boost::shared_ptr<crocoddyl::ShootingProblem>& problem = solver->get_problem();
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = problem->get_runningModels()[0]->get_state();
+  std::vector<Eigen::VectorXd> xs;
+  std::vector<Eigen::VectorXd> us;
+  for (std::size_t i = 0; i < T; ++i) {
+    const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = problem->get_runningModels()[i];
+    xs.push_back(state->rand());
+    us.push_back(Eigen::VectorXd::Random(model->get_nu()));
+  }
+  xs.push_back(state->rand());
+
+  // Check that an expired budget keeps the warm-point
+  solver->set_deadline(1e-9);
+  BOOST_CHECK(!solver->solve(xs, us));
+  BOOST_CHECK(solver->get_deadline_phase() == crocoddyl::DeadlineComputeDirection);
+  BOOST_CHECK(solver->get_iter() == 0);
+  for (std::size_t t = 0; t < T; ++t) {
+    BOOST_CHECK(solver->get_xs()[t] == xs[t]);
+    BOOST_CHECK(solver->get_us()[t] == us[t]);
+  }
+
+  // Check that the solver keeps the last accepted iterate when the budget expires
+  solver->set_deadline(0.1);
+  solver->solve(xs, us);
+  if (solver->get_deadline_phase() != crocoddyl::DeadlineNotReached) {
+    reference->solve(xs, us, solver->get_iter());
+    for (std::size_t t = 0; t < T; ++t) {
+      BOOST_CHECK(solver->get_xs()[t] == reference->get_xs()[t]);
+      BOOST_CHECK(solver->get_us()[t] == reference->get_us()[t]);
+    }
+    BOOST_CHECK(solver->get_xs()[T] == reference->get_xs()[T]);
+  }
+
+  // Check that a large budget doesn't modify the solver
+  solver->set_deadline(1e9);
+  BOOST_CHECK_EQUAL(solver->solve(xs, us), reference->solve(xs, us));
+  BOOST_CHECK(solver->get_deadline_phase() == crocoddyl::DeadlineNotReached);
+  BOOST_CHECK_EQUAL(solver->get_iter(), reference->get_iter());
+  BOOST_CHECK_EQUAL(solver->get_cost(), reference->get_cost());
+
+  // Check the search direction when the budget expires before computing it, i.e. after the first iteration
+  std::vector<boost::shared_ptr<crocoddyl::CallbackAbstract> > callbacks;
+  callbacks.push_back(boost::make_shared<CallbackExpireDeadline>());
+  solver->setCallbacks(callbacks);
+  BOOST_CHECK(!solver->solve(xs, us));
+  BOOST_CHECK(solver->get_deadline_phase() == crocoddyl::DeadlineComputeDirection);
+  BOOST_CHECK(solver->get_iter() == 1);
+  reference->solve(xs, us, 1);
+  bool accepted = false;
+  for (std::size_t t = 0; t < T; ++t) {
+    accepted = accepted || solver->get_us()[t] != us[t];
+    BOOST_CHECK(solver->get_xs()[t] == reference->get_xs()[t]);
+    BOOST_CHECK(solver->get_us()[t] == reference->get_us()[t]);
+    BOOST_CHECK(solver->get_K()[t] == reference->get_K()[t]);
+    BOOST_CHECK(solver->get_k()[t] == reference->get_k()[t]);
+  }
+  BOOST_CHECK_EQUAL(solver->get_direction_outdated(), accepted);
+  BOOST_CHECK_EQUAL(reference->get_direction_outdated(), accepted);
+}
+
+//____________________________________________________________________________//
+
+void test_real_time_iteration(SolverTypes::Type solver_type, ActionModelTypes::Type action_type, size_t T) {
+  SolverFactory solver_factory;
+  boost::shared_ptr<crocoddyl::SolverDDP> solver =
+      boost::static_pointer_cast<crocoddyl::SolverDDP>(solver_factory.create(solver_type, action_type, T));
+  const boost::shared_ptr<crocoddyl::ShootingProblem>& problem = solver->get_problem();
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = problem->get_runningModels()[0]->get_state();
+
+  // Check that the feedback phase requires a prepared search direction
+  BOOST_CHECK_THROW(solver->feedbackPhase(problem->get_x0()), std::exception);
+
+  // Run a real-time iteration with a new initial state
+  BOOST_CHECK(solver->preparationPhase());
+  const double xreg = solver->get_xreg();
+  const Eigen::VectorXd x0 = state->rand();
+  solver->feedbackPhase(x0);
+  BOOST_CHECK(problem->get_x0() == x0);
+  BOOST_CHECK(solver->get_xreg() == xreg);
+
+  // Check that the full step of the LQ problem reaches its optimal solution
+  crocoddyl::SolverDDP reference(problem);
+  reference.solve();
+  for (std::size_t t = 0; t < T; ++t) {
+    BOOST_CHECK((solver->get_us()[t] - reference.get_us()[t]).isZero(1e-7));
+    BOOST_CHECK((state->diff_dx(solver->get_xs()[t], reference.get_xs()[t])).isZero(1e-7));
+  }
+  BOOST_CHECK((state->diff_dx(solver->get_xs()[T], reference.get_xs()[T])).isZero(1e-7));
+}
+
+//____________________________________________________________________________//
+
+void test_policy_publisher(SolverTypes::Type solver_type, ActionModelTypes::Type action_type, size_t T) {
+  SolverFactory solver_factory;
+  boost::shared_ptr<crocoddyl::SolverDDP> solver =
+      boost::static_pointer_cast<crocoddyl::SolverDDP>(solver_factory.create(solver_type, action_type, T));
+  const boost::shared_ptr<crocoddyl::ShootingProblem>& problem = solver->get_problem();
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = problem->get_runningModels()[0]->get_state();
+
+  // Publish the policy of the first nodes after each iteration
+  const std::size_t nodes = std::min(T, static_cast<std::size_t>(3));
+  boost::shared_ptr<crocoddyl::PolicyBuffer> buffer = boost::make_shared<crocoddyl::PolicyBuffer>(
+      nodes, state->get_nx(), state->get_ndx(), problem->get_nu_max());
+  BOOST_CHECK(!buffer->has_update());
+  BOOST_CHECK(buffer->read().sequence == 0);
+  std::vector<boost::shared_ptr<crocoddyl::CallbackAbstract> > callbacks;
+  callbacks.push_back(boost::make_shared<crocoddyl::CallbackPolicyPublisher>(buffer));
+  solver->setCallbacks(callbacks);
+  solver->solve();
+
+  // Check that the reader gets the policy of the last iteration
+  BOOST_CHECK(buffer->has_update());
+  const crocoddyl::Policy& policy = buffer->read();
+  BOOST_CHECK(!buffer->has_update());
+  BOOST_CHECK(policy.iter == solver->get_iter());
+  BOOST_CHECK(policy.sequence > 0 && policy.sequence <= solver->get_iter() + 1);
+  for (std::size_t t = 0; t < nodes; ++t) {
+    BOOST_CHECK(policy.xs[t] == solver->get_xs()[t]);
+    BOOST_CHECK(policy.us[t] == solver->get_us()[t]);
+    BOOST_CHECK(policy.K[t] == solver->get_K()[t]);
+  }
+
+  // Check that the control of the policy follows the feedback law
+  Eigen::VectorXd u;
+  const Eigen::VectorXd dx = Eigen::VectorXd::Random(state->get_ndx());
+  policy.computeControl(0, dx, u);
+  BOOST_CHECK((u - (solver->get_us()[0] - solver->get_K()[0] * dx)).isZero(1e-9));
+}
+
+//____________________________________________________________________________//
+
+void test_fixed_size_backward_pass(SolverTypes::Type solver_type, ActionModelTypes::Type action_type, size_t T) {
+  // Create the fixed-size and dynamic-size solvers
+  SolverFactory solver_factory;
+  boost::shared_ptr<crocoddyl::SolverDDP> solver =
+      boost::static_pointer_cast<crocoddyl::SolverDDP>(solver_factory.create(solver_type, action_type, T));
+  boost::shared_ptr<crocoddyl::SolverDDP> dynamic =
+      boost::static_pointer_cast<crocoddyl::SolverDDP>(solver_factory.create(solver_type, action_type, T));
+  BOOST_CHECK(!dynamic->get_fixed_size());
+  solver->set_fixed_size(true);
+
+  // Generate an infeasible guess
+  const boost::shared_ptr<crocoddyl::ShootingProblem>& problem = solver->get_problem();
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = problem->get_runningModels()[0]->get_state();
+  std::vector<Eigen::VectorXd> xs;
+  std::vector<Eigen::VectorXd> us;
+  for (std::size_t i = 0; i < T; ++i) {
+    const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = problem->get_runningModels()[i];
+    xs.push_back(state->rand());
+    us.push_back(Eigen::VectorXd::Random(model->get_nu()));
+  }
+  xs.push_back(state->rand());
+
+  // Check that both backward passes produce the same gains
+  solver->setCandidate(xs, us, false);
+  dynamic->setCandidate(xs, us, false);
+  solver->computeDirection(true);
+  dynamic->computeDirection(true);
+  for (std::size_t t = 0; t < T; ++t) {
+    const std::size_t nu = problem->get_runningModels()[t]->get_nu();
+    BOOST_CHECK((solver->get_Vxx()[t] - dynamic->get_Vxx()[t]).isZero(1e-9));
+    BOOST_CHECK((solver->get_Vx()[t] - dynamic->get_Vx()[t]).isZero(1e-9));
+    BOOST_CHECK((solver->get_K()[t].topRows(nu) - dynamic->get_K()[t].topRows(nu)).isZero(1e-9));
+    BOOST_CHECK((solver->get_k()[t].head(nu) - dynamic->get_k()[t].head(nu)).isZero(1e-9));
+  }
+}
+
+//____________________________________________________________________________//
+
+void test_structured_backward_pass(DifferentialActionModelTypes::Type action_type, size_t T) {
+  // Create the problem of Euler-integrated action models
+  DifferentialActionModelFactory factory;
+  const boost::shared_ptr<crocoddyl::DifferentialActionModelAbstract>& differential = factory.create(action_type);
+  boost::shared_ptr<crocoddyl::ActionModelAbstract> model =
+      boost::make_shared<crocoddyl::IntegratedActionModelEuler>(differential, 1e-2);
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = differential->get_state();
+  std::vector<boost::shared_ptr<crocoddyl::ActionModelAbstract> > models(T, model);
+  boost::shared_ptr<crocoddyl::ShootingProblem> problem =
+      boost::make_shared<crocoddyl::ShootingProblem>(state->rand(), models, model);
+
+  // Create the structured and dense solvers
+  crocoddyl::SolverFDDP solver(problem);
+  crocoddyl::SolverFDDP dense(problem);
+  BOOST_CHECK(solver.get_structured());
+  dense.set_structured(false);
+
+  // Generate an infeasible guess
+  std::vector<Eigen::VectorXd> xs;
+  std::vector<Eigen::VectorXd> us;
+  for (std::size_t i = 0; i < T; ++i) {
+    xs.push_back(state->rand());
+    us.push_back(Eigen::VectorXd::Random(model->get_nu()));
+  }
+  xs.push_back(state->rand());
+
+  // Check that the data advertises the structure of the Euler step
+  solver.setCandidate(xs, us, false);
+  dense.setCandidate(xs, us, false);
+  solver.computeDirection(true);
+  const boost::shared_ptr<crocoddyl::ActionDataAbstract>& data = problem->get_runningDatas()[0];
+  BOOST_CHECK(data->F_structured);
+  BOOST_CHECK_EQUAL(data->F_ndense, state->get_ndx_lie());
+
+  // Check that both backward passes produce the same gains
+  dense.computeDirection(true);
+  for (std::size_t t = 0; t < T; ++t) {
+    BOOST_CHECK((solver.get_Qxx()[t] - dense.get_Qxx()[t]).isZero(1e-9));
+    BOOST_CHECK((solver.get_Qxu()[t] - dense.get_Qxu()[t]).isZero(1e-9));
+    BOOST_CHECK((solver.get_Quu()[t] - dense.get_Quu()[t]).isZero(1e-9));
+    BOOST_CHECK((solver.get_Vxx()[t] - dense.get_Vxx()[t]).isZero(1e-9));
+    BOOST_CHECK((solver.get_K()[t] - dense.get_K()[t]).isZero(1e-9));
+    BOOST_CHECK((solver.get_k()[t] - dense.get_k()[t]).isZero(1e-9));
+  }
+}
+
+//____________________________________________________________________________//
+
+void test_instrumentation(SolverTypes::Type solver_type, ActionModelTypes::Type action_type, size_t T) {
+  // Create the solver
+  SolverFactory solver_factory;
+  boost::shared_ptr<crocoddyl::SolverDDP> solver =
+      boost::static_pointer_cast<crocoddyl::SolverDDP>(solver_factory.create(solver_type, action_type, T));
+  solver->get_problem()->set_nthreads(4);
+
+  // Generate an infeasible guess
+  const boost::shared_ptr<crocoddyl::ShootingProblem>& problem = solver->get_problem();
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = problem->get_runningModels()[0]->get_state();
+  std::vector<Eigen::VectorXd> xs;
+  std::vector<Eigen::VectorXd> us;
+  for (std::size_t i = 0; i < T; ++i) {
+    const boost::shared_ptr<crocoddyl::ActionModelAbstract>& model = problem->get_runningModels()[i];
+    xs.push_back(state->rand());
+    us.push_back(Eigen::VectorXd::Random(model->get_nu()));
+  }
+  xs.push_back(state->rand());
+
+  // Check that the probes record the solver phases and the node calls
+  crocoddyl::Instrumentation& instrumentation = crocoddyl::getInstrumentation();
+  instrumentation.reset();
+  crocoddyl::Instrumentation::set_enabled(true);
+  solver->solve(xs, us);
+  crocoddyl::Instrumentation::set_enabled(false);
+  const std::size_t iter = solver->get_iter();
+  BOOST_CHECK(instrumentation.get_histogram(crocoddyl::ProbeCalcDiff).get_count() >= iter);
+  BOOST_CHECK(instrumentation.get_histogram(crocoddyl::ProbeBackwardPass).get_count() >= iter);
+  BOOST_CHECK(instrumentation.get_histogram(crocoddyl::ProbeForwardPass).get_count() >= iter);
+  BOOST_CHECK(instrumentation.get_histogram(crocoddyl::ProbeComputeGains).get_count() >= iter * T);
+  BOOST_CHECK(instrumentation.get_histogram(crocoddyl::ProbeNodeCalcDiff).get_count() >= iter * (T + 1));
+  for (std::size_t p = 0; p < crocoddyl::NbProbeTypes; ++p) {
+    const crocoddyl::LatencyHistogram histogram =
+        instrumentation.get_histogram(static_cast<crocoddyl::ProbeType>(p));
+    BOOST_CHECK(histogram.get_min() <= histogram.get_percentile(0.5));
+    BOOST_CHECK(histogram.get_percentile(0.5) <= histogram.get_percentile(0.99));
+    BOOST_CHECK(histogram.get_percentile(0.99) <= histogram.get_max());
+  }
+
+  // Check that the disabled probes do not record
+  const uint64_t count = instrumentation.get_histogram(crocoddyl::ProbeCalcDiff).get_count();
+  solver->solve(xs, us);
+  BOOST_CHECK_EQUAL(instrumentation.get_histogram(crocoddyl::ProbeCalcDiff).get_count(), count);
+  instrumentation.reset();
+  BOOST_CHECK_EQUAL(instrumentation.get_histogram(crocoddyl::ProbeCalcDiff).get_count(), uint64_t(0));
+}
+
+//____________________________________________________________________________//
+
 bool init_function() {
   size_t T = 10;
 
@@ -143,6 +801,7 @@ bool init_function() {
     test_suite* ts = BOOST_TEST_SUITE(test_name.str());
     ts->add(BOOST_TEST_CASE(boost::bind(&test_kkt_dimension, ActionModelTypes::all[action_type], T)));
     ts->add(BOOST_TEST_CASE(boost::bind(&test_kkt_search_direction, ActionModelTypes::all[action_type], T)));
+    ts->add(BOOST_TEST_CASE(boost::bind(&test_kkt_factorizations, ActionModelTypes::all[action_type], T)));
     framework::master_test_suite().add(ts);
   }
 
@@ -158,6 +817,166 @@ bool init_function() {
       framework::master_test_suite().add(ts);
     }
   }
+
+  for (size_t action_type = 0; action_type < ActionModelTypes::ActionModelImpulseFwdDynamics_HyQ; ++action_type) {
+    boost::test_tools::output_test_stream test_name;
+    test_name << "test_partitioned_backward_pass_" << ActionModelTypes::all[action_type];
+    test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+    std::cout << "Running " << test_name.str() << std::endl;
+    ts->add(BOOST_TEST_CASE(boost::bind(&test_partitioned_backward_pass, SolverTypes::SolverDDP,
+                                        ActionModelTypes::all[action_type], T)));
+    // Long horizons with many nodes per segment and thread
+    ts->add(BOOST_TEST_CASE(boost::bind(&test_partitioned_backward_pass, SolverTypes::SolverDDP,
+                                        ActionModelTypes::all[action_type], 256)));
+    framework::master_test_suite().add(ts);
+  }
+
+  for (size_t action_type = 0; action_type < ActionModelTypes::ActionModelImpulseFwdDynamics_HyQ; ++action_type) {
+    boost::test_tools::output_test_stream test_name;
+    test_name << "test_partitioned_forward_pass_" << ActionModelTypes::all[action_type];
+    test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+    std::cout << "Running " << test_name.str() << std::endl;
+    ts->add(BOOST_TEST_CASE(boost::bind(&test_partitioned_forward_pass, ActionModelTypes::all[action_type], T)));
+    framework::master_test_suite().add(ts);
+  }
+
+  for (size_t solver_type = 1; solver_type < SolverTypes::all.size(); ++solver_type) {
+    for (size_t action_type = 0; action_type < ActionModelTypes::ActionModelImpulseFwdDynamics_HyQ; ++action_type) {
+      boost::test_tools::output_test_stream test_name;
+      test_name << "test_concurrent_linesearch_" << SolverTypes::all[solver_type] << "_"
+                << ActionModelTypes::all[action_type];
+      test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+      std::cout << "Running " << test_name.str() << std::endl;
+      ts->add(BOOST_TEST_CASE(boost::bind(&test_concurrent_linesearch, SolverTypes::all[solver_type],
+                                          ActionModelTypes::all[action_type], T)));
+      framework::master_test_suite().add(ts);
+    }
+  }
+  for (size_t solver_type = 1; solver_type < SolverTypes::all.size(); ++solver_type) {
+    for (size_t action_type = 0; action_type < ActionModelTypes::ActionModelImpulseFwdDynamics_HyQ; ++action_type) {
+      boost::test_tools::output_test_stream test_name;
+      test_name << "test_speculative_calcDiff_" << SolverTypes::all[solver_type] << "_"
+                << ActionModelTypes::all[action_type];
+      test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+      std::cout << "Running " << test_name.str() << std::endl;
+      ts->add(BOOST_TEST_CASE(boost::bind(&test_speculative_calcDiff, SolverTypes::all[solver_type],
+                                          ActionModelTypes::all[action_type], T)));
+      framework::master_test_suite().add(ts);
+    }
+  }
+  for (size_t action_type = 0; action_type < ActionModelTypes::ActionModelImpulseFwdDynamics_HyQ; ++action_type) {
+    boost::test_tools::output_test_stream test_name;
+    test_name << "test_batch_solver_" << ActionModelTypes::all[action_type];
+    test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+    std::cout << "Running " << test_name.str() << std::endl;
+    ts->add(BOOST_TEST_CASE(boost::bind(&test_batch_solver, ActionModelTypes::all[action_type], T)));
+    framework::master_test_suite().add(ts);
+  }
+  for (size_t solver_type = 1; solver_type < SolverTypes::all.size(); ++solver_type) {
+    for (size_t action_type = 0; action_type < ActionModelTypes::ActionModelImpulseFwdDynamics_HyQ; ++action_type) {
+      boost::test_tools::output_test_stream test_name;
+      test_name << "test_solver_workspace_" << SolverTypes::all[solver_type] << "_"
+                << ActionModelTypes::all[action_type];
+      test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+      std::cout << "Running " << test_name.str() << std::endl;
+      ts->add(BOOST_TEST_CASE(boost::bind(&test_solver_workspace, SolverTypes::all[solver_type],
+                                          ActionModelTypes::all[action_type], T)));
+      framework::master_test_suite().add(ts);
+    }
+  }
+  for (size_t solver_type = 1; solver_type < SolverTypes::all.size(); ++solver_type) {
+    for (size_t action_type = 0; action_type < ActionModelTypes::ActionModelImpulseFwdDynamics_HyQ; ++action_type) {
+      boost::test_tools::output_test_stream test_name;
+      test_name << "test_shift_warm_start_" << SolverTypes::all[solver_type] << "_"
+                << ActionModelTypes::all[action_type];
+      test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+      std::cout << "Running " << test_name.str() << std::endl;
+      ts->add(BOOST_TEST_CASE(boost::bind(&test_shift_warm_start, SolverTypes::all[solver_type],
+                                          ActionModelTypes::all[action_type], T)));
+      framework::master_test_suite().add(ts);
+    }
+  }
+  for (size_t solver_type = 1; solver_type < SolverTypes::all.size(); ++solver_type) {
+    for (size_t action_type = 0; action_type < ActionModelTypes::ActionModelImpulseFwdDynamics_HyQ; ++action_type) {
+      boost::test_tools::output_test_stream test_name;
+      test_name << "test_warm_start_policy_" << SolverTypes::all[solver_type] << "_"
+                << ActionModelTypes::all[action_type];
+      test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+      std::cout << "Running " << test_name.str() << std::endl;
+      ts->add(BOOST_TEST_CASE(boost::bind(&test_warm_start_policy, SolverTypes::all[solver_type],
+                                          ActionModelTypes::all[action_type], T)));
+      framework::master_test_suite().add(ts);
+    }
+  }
+  for (size_t action_type = 0; action_type < ActionModelTypes::ActionModelImpulseFwdDynamics_HyQ; ++action_type) {
+    boost::test_tools::output_test_stream test_name;
+    test_name << "test_deadline_" << ActionModelTypes::all[action_type];
+    test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+    std::cout << "Running " << test_name.str() << std::endl;
+    ts->add(BOOST_TEST_CASE(
+        boost::bind(&test_deadline, SolverTypes::SolverFDDP, ActionModelTypes::all[action_type], T)));
+    ts->add(BOOST_TEST_CASE(
+        boost::bind(&test_deadline, SolverTypes::SolverBoxFDDP, ActionModelTypes::all[action_type], T)));
+    framework::master_test_suite().add(ts);
+  }
+  for (size_t solver_type = 1; solver_type < SolverTypes::all.size(); ++solver_type) {
+    for (size_t action_type = ActionModelTypes::ActionModelLQRDriftFree;
+         action_type < ActionModelTypes::ActionModelImpulseFwdDynamics_HyQ; ++action_type) {
+      boost::test_tools::output_test_stream test_name;
+      test_name << "test_real_time_iteration_" << SolverTypes::all[solver_type] << "_"
+                << ActionModelTypes::all[action_type];
+      test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+      std::cout << "Running " << test_name.str() << std::endl;
+      ts->add(BOOST_TEST_CASE(boost::bind(&test_real_time_iteration, SolverTypes::all[solver_type],
+                                          ActionModelTypes::all[action_type], T)));
+      framework::master_test_suite().add(ts);
+    }
+  }
+  for (size_t solver_type = 1; solver_type < SolverTypes::all.size(); ++solver_type) {
+    for (size_t action_type = 0; action_type < ActionModelTypes::ActionModelImpulseFwdDynamics_HyQ; ++action_type) {
+      boost::test_tools::output_test_stream test_name;
+      test_name << "test_policy_publisher_" << SolverTypes::all[solver_type] << "_"
+                << ActionModelTypes::all[action_type];
+      test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+      std::cout << "Running " << test_name.str() << std::endl;
+      ts->add(BOOST_TEST_CASE(boost::bind(&test_policy_publisher, SolverTypes::all[solver_type],
+                                          ActionModelTypes::all[action_type], T)));
+      framework::master_test_suite().add(ts);
+    }
+  }
+  for (size_t solver_type = 1; solver_type < SolverTypes::all.size(); ++solver_type) {
+    for (size_t action_type = 0; action_type < ActionModelTypes::ActionModelImpulseFwdDynamics_HyQ; ++action_type) {
+      boost::test_tools::output_test_stream test_name;
+      test_name << "test_fixed_size_backward_pass_" << SolverTypes::all[solver_type] << "_"
+                << ActionModelTypes::all[action_type];
+      test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+      std::cout << "Running " << test_name.str() << std::endl;
+      ts->add(BOOST_TEST_CASE(boost::bind(&test_fixed_size_backward_pass, SolverTypes::all[solver_type],
+                                          ActionModelTypes::all[action_type], T)));
+      framework::master_test_suite().add(ts);
+    }
+  }
+  for (size_t solver_type = 1; solver_type < SolverTypes::all.size(); ++solver_type) {
+    for (size_t action_type = 0; action_type < ActionModelTypes::ActionModelImpulseFwdDynamics_HyQ; ++action_type) {
+      boost::test_tools::output_test_stream test_name;
+      test_name << "test_instrumentation_" << SolverTypes::all[solver_type] << "_"
+                << ActionModelTypes::all[action_type];
+      test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+      std::cout << "Running " << test_name.str() << std::endl;
+      ts->add(BOOST_TEST_CASE(boost::bind(&test_instrumentation, SolverTypes::all[solver_type],
+                                          ActionModelTypes::all[action_type], T)));
+      framework::master_test_suite().add(ts);
+    }
+  }
+  for (size_t action_type = 0; action_type < DifferentialActionModelTypes::all.size(); ++action_type) {
+    boost::test_tools::output_test_stream test_name;
+    test_name << "test_structured_backward_pass_" << DifferentialActionModelTypes::all[action_type];
+    test_suite* ts = BOOST_TEST_SUITE(test_name.str());
+    std::cout << "Running " << test_name.str() << std::endl;
+    ts->add(BOOST_TEST_CASE(
+        boost::bind(&test_structured_backward_pass, DifferentialActionModelTypes::all[action_type], T)));
+    framework::master_test_suite().add(ts);
+  }
   return true;
 }
 
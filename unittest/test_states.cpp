@@ -239,6 +239,29 @@ void test_JintegrateTransport(StateModelTypes::Type state_type) {
   BOOST_CHECK((Jref - Jint_2 * Jtest).isZero(1e-10));
 }
 
+void test_Jintegrate_euclidean_directions(StateModelTypes::Type state_type) {
+  StateModelFactory factory;
+  const boost::shared_ptr<crocoddyl::StateAbstract>& state = factory.create(state_type);
+  // Generating random values for the initial state and its rate of change
+  const Eigen::VectorXd& x = state->rand();
+  const Eigen::VectorXd& dx = Eigen::VectorXd::Random(state->get_ndx());
+  const std::size_t ndx = state->get_ndx();
+  const std::size_t nlie = state->get_ndx_lie();
+  BOOST_CHECK(nlie <= ndx);
+
+  // Checking that the directions after the Lie-group ones are integrated as a vector space
+  Eigen::MatrixXd Jint_1(Eigen::MatrixXd::Zero(ndx, ndx));
+  Eigen::MatrixXd Jint_2(Eigen::MatrixXd::Zero(ndx, ndx));
+  state->Jintegrate(x, dx, Jint_1, Jint_2);
+  const Eigen::MatrixXd I(Eigen::MatrixXd::Identity(ndx - nlie, ndx - nlie));
+  BOOST_CHECK((Jint_1.bottomRightCorner(ndx - nlie, ndx - nlie) - I).isZero(1e-10));
+  BOOST_CHECK((Jint_2.bottomRightCorner(ndx - nlie, ndx - nlie) - I).isZero(1e-10));
+  BOOST_CHECK(Jint_1.bottomLeftCorner(ndx - nlie, nlie).isZero(1e-10));
+  BOOST_CHECK(Jint_2.bottomLeftCorner(ndx - nlie, nlie).isZero(1e-10));
+  BOOST_CHECK(Jint_1.topRightCorner(nlie, ndx - nlie).isZero(1e-10));
+  BOOST_CHECK(Jint_2.topRightCorner(nlie, ndx - nlie).isZero(1e-10));
+}
+
 void test_Jdiff_and_Jintegrate_are_inverses(StateModelTypes::Type state_type) {
   StateModelFactory factory;
   const boost::shared_ptr<crocoddyl::StateAbstract>& state = factory.create(state_type);
@@ -320,6 +343,7 @@ void register_state_unit_tests(StateModelTypes::Type state_type) {
   ts->add(BOOST_TEST_CASE(boost::bind(&test_Jdiff_against_numdiff, state_type)));
   ts->add(BOOST_TEST_CASE(boost::bind(&test_Jintegrate_against_numdiff, state_type)));
   ts->add(BOOST_TEST_CASE(boost::bind(&test_JintegrateTransport, state_type)));
+  ts->add(BOOST_TEST_CASE(boost::bind(&test_Jintegrate_euclidean_directions, state_type)));
   ts->add(BOOST_TEST_CASE(boost::bind(&test_Jdiff_and_Jintegrate_are_inverses, state_type)));
   ts->add(BOOST_TEST_CASE(boost::bind(&test_velocity_from_Jintegrate_Jdiff, state_type)));
   framework::master_test_suite().add(ts);